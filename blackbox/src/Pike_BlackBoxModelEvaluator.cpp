@@ -1,4 +1,5 @@
 #include "Pike_BlackBoxModelEvaluator.hpp"
+#include <algorithm>
 
 namespace pike {
 
@@ -50,6 +51,54 @@ namespace pike {
 			       << "\" does not support parameters!");
   }
 
+  Teuchos::ArrayView<const double> BlackBoxModelEvaluator::getParameter(const int l) const
+  {
+    TEUCHOS_TEST_FOR_EXCEPTION(true,std::logic_error,"Error: pike::BlackBoxModelEvaluator::getParameter(l) "
+			       << "The BlackBoxModelEvaluator named \"" << this->name() 
+			       << "\" does not support getting parameter values!");
+    return Teuchos::ArrayView<const double>();
+  }
+
+  int BlackBoxModelEvaluator::getParameterSize(const int l) const
+  {
+    return -1;
+  }
+
+  void BlackBoxModelEvaluator::setParameters(const Teuchos::ArrayView<const int>& l,
+					     const Teuchos::ArrayView<const double>& p)
+  {
+    const std::vector<Teuchos::Ordinal> offsets = this->getPackedParameterOffsets(l,p.size());
+    for (Teuchos::Ordinal i = 0; i < l.size(); ++i)
+      this->setParameter(l[i],p(offsets[i],offsets[i+1]-offsets[i]));
+  }
+
+  std::vector<Teuchos::Ordinal>
+  BlackBoxModelEvaluator::getPackedParameterOffsets(const Teuchos::ArrayView<const int>& l,
+						    const Teuchos::Ordinal pSize) const
+  {
+    std::vector<Teuchos::Ordinal> offsets(1,0);
+    for (Teuchos::ArrayView<const int>::iterator i = l.begin(); i != l.end(); ++i) {
+      Teuchos::Ordinal size = this->getParameterSize(*i);
+      if (size < 0) {
+	TEUCHOS_TEST_FOR_EXCEPTION(l.size() != 1,std::logic_error,
+				   "Error: pike::BlackBoxModelEvaluator::setParameters(l,p) "
+				   << "The BlackBoxModelEvaluator named \"" << this->name()
+				   << "\" does not implement getParameterSize(), so only one parameter can be set per call!");
+	size = pSize;
+      }
+      TEUCHOS_TEST_FOR_EXCEPTION(offsets.back() + size > pSize,std::logic_error,
+				 "Error: pike::BlackBoxModelEvaluator::setParameters(l,p) "
+				 << "The buffer p of size " << pSize << " passed to the BlackBoxModelEvaluator named \""
+				 << this->name() << "\" is too small for the requested parameters!");
+      offsets.push_back(offsets.back() + size);
+    }
+    TEUCHOS_TEST_FOR_EXCEPTION(offsets.back() != pSize,std::logic_error,
+			       "Error: pike::BlackBoxModelEvaluator::setParameters(l,p) "
+			       << "The buffer p of size " << pSize << " passed to the BlackBoxModelEvaluator named \""
+			       << this->name() << "\" does not match the requested parameters of total size " << offsets.back() << "!");
+    return offsets;
+  }
+
   // ***********************
   // Response Support
   // ***********************
@@ -88,6 +137,45 @@ namespace pike {
     return Teuchos::ArrayView<const double>(std::vector<double>(0));
   }
 
+  int BlackBoxModelEvaluator::getResponseSize(const int j) const
+  {
+    return static_cast<int>(this->getResponse(j).size());
+  }
+
+  void BlackBoxModelEvaluator::getResponses(const Teuchos::ArrayView<const int>& j,
+					    const Teuchos::ArrayView<double>& g) const
+  {
+    const std::vector<Teuchos::Ordinal> offsets = this->getPackedResponseOffsets(j,g.size());
+    for (Teuchos::Ordinal i = 0; i < j.size(); ++i) {
+      const Teuchos::ArrayView<const double> g_i = this->getResponse(j[i]);
+      TEUCHOS_TEST_FOR_EXCEPTION(g_i.size() != offsets[i+1]-offsets[i],std::logic_error,
+				 "Error: pike::BlackBoxModelEvaluator::getResponses(j,g) "
+				 << "The response " << j[i] << " of the BlackBoxModelEvaluator named \""
+				 << this->name() << "\" does not match its getResponseSize()!");
+      std::copy(g_i.begin(),g_i.end(),g.begin()+offsets[i]);
+    }
+  }
+
+  std::vector<Teuchos::Ordinal>
+  BlackBoxModelEvaluator::getPackedResponseOffsets(const Teuchos::ArrayView<const int>& j,
+						   const Teuchos::Ordinal gSize) const
+  {
+    std::vector<Teuchos::Ordinal> offsets(1,0);
+    for (Teuchos::ArrayView<const int>::iterator i = j.begin(); i != j.end(); ++i) {
+      const Teuchos::Ordinal size = this->getResponseSize(*i);
+      TEUCHOS_TEST_FOR_EXCEPTION(offsets.back() + size > gSize,std::logic_error,
+				 "Error: pike::BlackBoxModelEvaluator::getResponses(j,g) "
+				 << "The buffer g of size " << gSize << " passed to the BlackBoxModelEvaluator named \""
+				 << this->name() << "\" is too small for the requested responses!");
+      offsets.push_back(offsets.back() + size);
+    }
+    TEUCHOS_TEST_FOR_EXCEPTION(offsets.back() != gSize,std::logic_error,
+			       "Error: pike::BlackBoxModelEvaluator::getResponses(j,g) "
+			       << "The buffer g of size " << gSize << " passed to the BlackBoxModelEvaluator named \""
+			       << this->name() << "\" does not match the requested responses of total size " << offsets.back() << "!");
+    return offsets;
+  }
+
   // ***********************
   // Transient Support
   // ***********************
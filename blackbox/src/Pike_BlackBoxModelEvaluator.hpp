@@ -4,6 +4,7 @@
 #include "Teuchos_VerboseObject.hpp"
 #include "Teuchos_Describable.hpp"
 #include <string>
+#include <vector>
 
 namespace pike {
 
@@ -75,6 +76,37 @@ namespace pike {
     
     //! Sets the parameter, p, for index l where 0 <= l < Np. 
     virtual void setParameter(const int l, const Teuchos::ArrayView<const double>& p);
+
+    /** \brief Returns the current value of the parameter for index l where 0 <= l < Np.
+
+	This is the value last set with setParameter() or written
+	directly by a DataTransfer.  Required by adapters that treat
+	the coupling parameters as unknowns (e.g. a fixed-point
+	residual for NOX).
+    */
+    virtual Teuchos::ArrayView<const double> getParameter(const int l) const;
+
+    /** \brief Returns the number of entries of parameter l or -1 if the size is not known.
+
+	The default implementation returns -1 so that it does not
+	depend on the optional getParameter().  Models must override
+	this to set more than one parameter with setParameters().
+    */
+    virtual int getParameterSize(const int l) const;
+
+    /** \brief Sets several parameters with a single call.
+
+	\param[in] l The parameter indices to set.
+	\param[in] p The values of the parameters, packed contiguously in the order of l.  Its size must be the sum of getParameterSize() over l.
+
+	If a single parameter is set, a parameter size of -1 means
+	that all of p is used.  The default implementation calls
+	setParameter() for each index.  Applications that move large
+	coupling fields can override this to avoid the per-parameter
+	overhead.
+    */
+    virtual void setParameters(const Teuchos::ArrayView<const int>& l,
+			       const Teuchos::ArrayView<const double>& p);
     
     /**@} */
     
@@ -100,6 +132,24 @@ namespace pike {
     
     //! Returns the response for index j where 0 <= j < Ng. 
     virtual Teuchos::ArrayView<const double> getResponse(const int j) const;
+
+    /** \brief Returns the number of entries of response j.
+
+	The default implementation returns the size of getResponse(j).
+    */
+    virtual int getResponseSize(const int j) const;
+
+    /** \brief Copies several responses into a caller owned buffer with a single call.
+
+	\param[in] j The response indices to get.
+	\param[out] g Buffer for the values of the responses, packed contiguously in the order of j.  Its size must be the sum of getResponseSize() over j.
+
+	The default implementation copies getResponse() for each
+	index.  Applications can override this to write directly into
+	the caller's buffer.
+    */
+    virtual void getResponses(const Teuchos::ArrayView<const int>& j,
+			      const Teuchos::ArrayView<double>& g) const;
     
     /**@} */
     
@@ -176,6 +226,21 @@ namespace pike {
 
     /**@} */
 
+  protected:
+
+    /** \brief Returns the offsets of the parameters l in a packed buffer of size pSize.
+
+	The returned vector has l.size()+1 entries, the last one being
+	pSize.  Throws if the sizes from getParameterSize() do not add
+	up to pSize.
+    */
+    std::vector<Teuchos::Ordinal> getPackedParameterOffsets(const Teuchos::ArrayView<const int>& l,
+							    const Teuchos::Ordinal pSize) const;
+
+    //! Returns the offsets of the responses j in a packed buffer of size gSize (see getPackedParameterOffsets()).
+    std::vector<Teuchos::Ordinal> getPackedResponseOffsets(const Teuchos::ArrayView<const int>& j,
+							   const Teuchos::Ordinal gSize) const;
+
   };
 
 }
@@ -0,0 +1,552 @@
+#include "Pike_BlackBoxModelEvaluator_Caching.hpp"
+#include "Teuchos_ParameterList.hpp"
+#include "Teuchos_VerboseObjectParameterListHelpers.hpp"
+#include "Teuchos_DefaultComm.hpp"
+#include "Teuchos_CommHelpers.hpp"
+#include "Teuchos_Assert.hpp"
+#include <functional>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cctype>
+#include <cstdio>
+
+namespace pike {
+
+  CachingModelEvaluator::CachingModelEvaluator(const Teuchos::RCP<pike::BlackBoxModelEvaluator>& model)
+    : model_(model),
+      memoryBudget_(64 * 1024 * 1024),
+      memoryUsage_(0),
+      haveCurrentSolve_(false),
+      numberOfCacheHits_(0),
+      numberOfDiskCacheHits_(0),
+      numberOfCacheMisses_(0)
+  {
+    validParameters_ = Teuchos::parameterList("Valid Parameters: CachingModelEvaluator");
+    validParameters_->set("Memory Budget (MB)",64.0,"Maximum amount of parameter and response data held in memory.  Least recently used entries are evicted first.");
+    validParameters_->set("Disk Cache Directory","","If not empty, entries evicted from memory are written to this directory and searched before solving the wrapped model.");
+    Teuchos::setupVerboseObjectSublist(validParameters_.get());
+  }
+
+  CachingModelEvaluator::~CachingModelEvaluator()
+  {
+    for (std::set<std::string>::const_iterator f = diskCacheFiles_.begin(); f != diskCacheFiles_.end(); ++f)
+      std::remove(f->c_str());
+  }
+
+  std::string CachingModelEvaluator::name() const
+  {
+    return model_->name();
+  }
+
+  void CachingModelEvaluator::solve()
+  {
+    if (model_->isTransient()) {
+      model_->solve();
+      return;
+    }
+
+    currentParameters_.resize(model_->getNumberOfParameters());
+    currentParameterIsSet_.resize(model_->getNumberOfParameters(),false);
+
+    const std::size_t hash = this->hashParameters();
+
+    // Memory tier
+    bool memoryHit = false;
+    EntryIterator memoryEntry = entries_.end();
+    typedef std::unordered_multimap<std::size_t,EntryIterator>::iterator HashIterator;
+    std::pair<HashIterator,HashIterator> range = hashToEntry_.equal_range(hash);
+    for (HashIterator i = range.first; i != range.second; ++i) {
+      if (this->matchesCurrentParameters(*(i->second))) {
+	memoryHit = true;
+	memoryEntry = i->second;
+	break;
+      }
+    }
+
+    // Disk tier
+    bool diskHit = false;
+    CacheEntry diskEntry;
+    if (!memoryHit && (diskCacheDirectory_ != ""))
+      diskHit = this->readFromDisk(hash,diskEntry);
+
+    // A hit must be a hit on all processes of the model
+    int hit = (memoryHit || diskHit) ? 1 : 0;
+    if (nonnull(comm_)) {
+      int globalHit = 0;
+      Teuchos::reduceAll(*comm_,Teuchos::REDUCE_MIN,hit,Teuchos::outArg(globalHit));
+      hit = globalHit;
+    }
+
+    if (hit == 1) {
+      if (memoryHit) {
+	// Move to the front of the LRU list.  Splicing does not
+	// invalidate the iterator stored in the hash map.
+	entries_.splice(entries_.begin(),entries_,memoryEntry);
+	this->setCurrentSolve(memoryEntry);
+      }
+      else {
+	this->insertInMemory(std::move(diskEntry));
+	this->setCurrentSolve(entries_.begin());
+	this->evictToBudget();
+	++numberOfDiskCacheHits_;
+      }
+      ++numberOfCacheHits_;
+      return;
+    }
+
+    // Miss: solve the wrapped model and store the results.  An
+    // entry that only hit on this process is replaced.
+    if (memoryHit)
+      this->eraseFromMemory(memoryEntry);
+
+    model_->solve();
+    ++numberOfCacheMisses_;
+
+    CacheEntry e;
+    e.hash = hash;
+    e.parameters = currentParameters_;
+    e.parameterIsSet = currentParameterIsSet_;
+    e.responses.resize(model_->getNumberOfResponses());
+    for (std::size_t j = 0; j < e.responses.size(); ++j) {
+      const Teuchos::ArrayView<const double> r = model_->getResponse(static_cast<int>(j));
+      e.responses[j].assign(r.begin(),r.end());
+    }
+    e.locallyConverged = model_->isLocallyConverged();
+    e.globallyConverged = model_->isGloballyConverged();
+    e.onDisk = false;
+
+    this->insertInMemory(std::move(e));
+    this->setCurrentSolve(entries_.begin());
+    this->evictToBudget();
+  }
+
+  bool CachingModelEvaluator::isLocallyConverged() const
+  {
+    if (haveCurrentSolve_ && !model_->isTransient())
+      return currentSolve_->locallyConverged;
+
+    return model_->isLocallyConverged();
+  }
+
+  bool CachingModelEvaluator::isGloballyConverged() const
+  {
+    if (haveCurrentSolve_ && !model_->isTransient())
+      return currentSolve_->globallyConverged;
+
+    return model_->isGloballyConverged();
+  }
+
+  Teuchos::ArrayView<const double> CachingModelEvaluator::getResponse(const int i) const
+  {
+    if (haveCurrentSolve_ && !model_->isTransient()) {
+      TEUCHOS_ASSERT( (i >= 0) && (i < static_cast<int>(currentSolve_->responses.size())) );
+      return Teuchos::ArrayView<const double>(currentSolve_->responses[i]);
+    }
+
+    return model_->getResponse(i);
+  }
+
+  int CachingModelEvaluator::getResponseIndex(const std::string& rName) const
+  {
+    return model_->getResponseIndex(rName);
+  }
+
+  std::string CachingModelEvaluator::getResponseName(const int i) const
+  {
+    return model_->getResponseName(i);
+  }
+
+  bool CachingModelEvaluator::supportsResponse(const std::string& rName) const
+  {
+    return model_->supportsResponse(rName);
+  }
+
+  int CachingModelEvaluator::getNumberOfResponses() const
+  {
+    return model_->getNumberOfResponses();
+  }
+
+  int CachingModelEvaluator::getResponseSize(const int j) const
+  {
+    if (haveCurrentSolve_ && !model_->isTransient()) {
+      TEUCHOS_ASSERT( (j >= 0) && (j < static_cast<int>(currentSolve_->responses.size())) );
+      return static_cast<int>(currentSolve_->responses[j].size());
+    }
+
+    return model_->getResponseSize(j);
+  }
+
+  void CachingModelEvaluator::getResponses(const Teuchos::ArrayView<const int>& j, const Teuchos::ArrayView<double>& g) const
+  {
+    // Cached responses are copied by the base implementation
+    if (haveCurrentSolve_ && !model_->isTransient())
+      pike::BlackBoxModelEvaluator::getResponses(j,g);
+    else
+      model_->getResponses(j,g);
+  }
+
+  bool CachingModelEvaluator::supportsParameter(const std::string& pName) const
+  {
+    return model_->supportsParameter(pName);
+  }
+
+  int CachingModelEvaluator::getNumberOfParameters() const
+  {
+    return model_->getNumberOfParameters();
+  }
+
+  std::string CachingModelEvaluator::getParameterName(const int l) const
+  {
+    return model_->getParameterName(l);
+  }
+
+  int CachingModelEvaluator::getParameterIndex(const std::string& pName) const
+  {
+    return model_->getParameterIndex(pName);
+  }
+
+  void CachingModelEvaluator::setParameter(const int l, const Teuchos::ArrayView<const double>& p)
+  {
+    model_->setParameter(l,p);
+    this->recordParameter(l,p);
+  }
+
+  Teuchos::ArrayView<const double> CachingModelEvaluator::getParameter(const int l) const
+  {
+    return model_->getParameter(l);
+  }
+
+  int CachingModelEvaluator::getParameterSize(const int l) const
+  {
+    return model_->getParameterSize(l);
+  }
+
+  void CachingModelEvaluator::setParameters(const Teuchos::ArrayView<const int>& l, const Teuchos::ArrayView<const double>& p)
+  {
+    const std::vector<Teuchos::Ordinal> offsets = this->getPackedParameterOffsets(l,p.size());
+    model_->setParameters(l,p);
+    for (Teuchos::Ordinal i = 0; i < l.size(); ++i)
+      this->recordParameter(l[i],p(offsets[i],offsets[i+1]-offsets[i]));
+  }
+
+  void CachingModelEvaluator::recordParameter(const int l, const Teuchos::ArrayView<const double>& p)
+  {
+    if (l >= static_cast<int>(currentParameters_.size())) {
+      currentParameters_.resize(l+1);
+      currentParameterIsSet_.resize(l+1,false);
+    }
+    currentParameters_[l].assign(p.begin(),p.end());
+    currentParameterIsSet_[l] = true;
+  }
+
+  bool CachingModelEvaluator::isTransient() const
+  {
+    return model_->isTransient();
+  }
+
+  double CachingModelEvaluator::getCurrentTime() const
+  {
+    return model_->getCurrentTime();
+  }
+
+  double CachingModelEvaluator::getTentativeTime() const
+  {
+    return model_->getTentativeTime();
+  }
+
+  bool CachingModelEvaluator::solvedTentativeStep() const
+  {
+    return model_->solvedTentativeStep();
+  }
+
+  double CachingModelEvaluator::getCurrentTimeStepSize() const
+  {
+    return model_->getCurrentTimeStepSize();
+  }
+
+  double CachingModelEvaluator::getDesiredTimeStepSize() const
+  {
+    return model_->getDesiredTimeStepSize();
+  }
+
+  double CachingModelEvaluator::getMaxTimeStepSize() const
+  {
+    return model_->getMaxTimeStepSize();
+  }
+
+  void CachingModelEvaluator::setNextTimeStepSize(const double& dt)
+  {
+    model_->setNextTimeStepSize(dt);
+  }
+
+  void CachingModelEvaluator::acceptTimeStep()
+  {
+    model_->acceptTimeStep();
+  }
+
+  void CachingModelEvaluator::setParameterList(const Teuchos::RCP<Teuchos::ParameterList>& paramList)
+  {
+    paramList->validateParametersAndSetDefaults(*(this->getValidParameters()));
+    this->setMyParamList(paramList);
+
+    const double budgetMB = paramList->get<double>("Memory Budget (MB)");
+    TEUCHOS_TEST_FOR_EXCEPTION(budgetMB < 0.0, std::logic_error,
+			       "Error: the \"Memory Budget (MB)\" of the CachingModelEvaluator for the model \""
+			       << this->name() << "\" must be non-negative!");
+    memoryBudget_ = static_cast<std::size_t>(budgetMB * 1024.0 * 1024.0);
+    diskCacheDirectory_ = paramList->get<std::string>("Disk Cache Directory");
+
+    this->evictToBudget();
+  }
+
+  Teuchos::RCP<const Teuchos::ParameterList> CachingModelEvaluator::getValidParameters() const
+  {
+    return validParameters_;
+  }
+
+  void CachingModelEvaluator::registerComm(const Teuchos::RCP<const Teuchos::Comm<int> >& comm)
+  {
+    comm_ = comm;
+  }
+
+  void CachingModelEvaluator::clearCache()
+  {
+    if (haveCurrentSolve_ && retiredCurrentSolve_.empty())
+      retiredCurrentSolve_.splice(retiredCurrentSolve_.begin(),entries_,currentSolve_);
+    entries_.clear();
+    hashToEntry_.clear();
+    memoryUsage_ = 0;
+
+    for (std::set<std::string>::const_iterator f = diskCacheFiles_.begin(); f != diskCacheFiles_.end(); ++f)
+      std::remove(f->c_str());
+    diskCacheFiles_.clear();
+  }
+
+  int CachingModelEvaluator::getNumberOfCacheHits() const
+  {
+    return numberOfCacheHits_;
+  }
+
+  int CachingModelEvaluator::getNumberOfDiskCacheHits() const
+  {
+    return numberOfDiskCacheHits_;
+  }
+
+  int CachingModelEvaluator::getNumberOfCacheMisses() const
+  {
+    return numberOfCacheMisses_;
+  }
+
+  int CachingModelEvaluator::getNumberOfCachedEntries() const
+  {
+    return static_cast<int>(entries_.size());
+  }
+
+  std::size_t CachingModelEvaluator::getMemoryUsage() const
+  {
+    return memoryUsage_;
+  }
+
+  std::size_t CachingModelEvaluator::hashParameters() const
+  {
+    std::hash<double> hashDouble;
+    std::size_t seed = currentParameters_.size();
+    for (std::size_t l = 0; l < currentParameters_.size(); ++l) {
+      seed ^= (currentParameterIsSet_[l] ? 1 : 0) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+      for (std::vector<double>::const_iterator v = currentParameters_[l].begin();
+	   v != currentParameters_[l].end(); ++v)
+	seed ^= hashDouble(*v) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    }
+    return seed;
+  }
+
+  bool CachingModelEvaluator::matchesCurrentParameters(const CacheEntry& e) const
+  {
+    return (e.parameterIsSet == currentParameterIsSet_) && (e.parameters == currentParameters_);
+  }
+
+  std::size_t CachingModelEvaluator::sizeInBytes(const CacheEntry& e) const
+  {
+    std::size_t numValues = 0;
+    for (std::size_t l = 0; l < e.parameters.size(); ++l)
+      numValues += e.parameters[l].size();
+    for (std::size_t j = 0; j < e.responses.size(); ++j)
+      numValues += e.responses[j].size();
+    return numValues * sizeof(double);
+  }
+
+  void CachingModelEvaluator::insertInMemory(CacheEntry&& e)
+  {
+    const std::size_t size = this->sizeInBytes(e);
+    entries_.push_front(std::move(e));
+    hashToEntry_.insert(std::make_pair(entries_.front().hash,entries_.begin()));
+    memoryUsage_ += size;
+  }
+
+  void CachingModelEvaluator::eraseFromMemory(const EntryIterator e)
+  {
+    typedef std::unordered_multimap<std::size_t,EntryIterator>::iterator HashIterator;
+    std::pair<HashIterator,HashIterator> range = hashToEntry_.equal_range(e->hash);
+    for (HashIterator i = range.first; i != range.second; ++i) {
+      if (i->second == e) {
+	hashToEntry_.erase(i);
+	break;
+      }
+    }
+
+    memoryUsage_ -= this->sizeInBytes(*e);
+
+    // Splicing keeps the iterator of the last solve valid
+    if (haveCurrentSolve_ && (e == currentSolve_))
+      retiredCurrentSolve_.splice(retiredCurrentSolve_.begin(),entries_,e);
+    else
+      entries_.erase(e);
+  }
+
+  void CachingModelEvaluator::setCurrentSolve(const EntryIterator e)
+  {
+    currentSolve_ = e;
+    haveCurrentSolve_ = true;
+    retiredCurrentSolve_.clear();
+  }
+
+  void CachingModelEvaluator::evictToBudget()
+  {
+    // Count the least recently used entries that must go.  With
+    // collective hits, all processes hold the entries in the same
+    // order, so evicting the largest count keeps them identical.
+    int numToEvict = 0;
+    std::size_t usage = memoryUsage_;
+    for (std::list<CacheEntry>::reverse_iterator e = entries_.rbegin();
+	 (usage > memoryBudget_) && (e != entries_.rend()); ++e) {
+      usage -= this->sizeInBytes(*e);
+      ++numToEvict;
+    }
+    if (nonnull(comm_)) {
+      int globalNumToEvict = 0;
+      Teuchos::reduceAll(*comm_,Teuchos::REDUCE_MAX,numToEvict,Teuchos::outArg(globalNumToEvict));
+      numToEvict = globalNumToEvict;
+    }
+
+    for (int n = 0; (n < numToEvict) && (!entries_.empty()); ++n) {
+      EntryIterator lru = --entries_.end();
+      if ( (diskCacheDirectory_ != "") && (!lru->onDisk) )
+	this->writeToDisk(*lru);
+      this->eraseFromMemory(lru);
+    }
+  }
+
+  std::string CachingModelEvaluator::diskCacheFileName(const std::size_t hash) const
+  {
+    // Model names may contain characters that are not valid in file names.
+    std::string modelName = this->name();
+    for (std::string::iterator c = modelName.begin(); c != modelName.end(); ++c)
+      if (!std::isalnum(static_cast<unsigned char>(*c)))
+	*c = '_';
+
+    std::ostringstream os;
+    os << diskCacheDirectory_ << "/pike_cache_" << modelName
+       << "_p" << Teuchos::DefaultComm<int>::getComm()->getRank()
+       << "_" << std::hex << hash << ".bin";
+    return os.str();
+  }
+
+  namespace {
+    void writeValues(std::ostream& os, const std::vector<double>& v)
+    {
+      const std::size_t size = v.size();
+      os.write(reinterpret_cast<const char*>(&size),sizeof(size));
+      if (size > 0)
+	os.write(reinterpret_cast<const char*>(&v[0]),size*sizeof(double));
+    }
+
+    bool readValues(std::istream& is, std::vector<double>& v)
+    {
+      std::size_t size = 0;
+      if (!is.read(reinterpret_cast<char*>(&size),sizeof(size)))
+	return false;
+      v.resize(size);
+      if (size > 0)
+	is.read(reinterpret_cast<char*>(&v[0]),size*sizeof(double));
+      return static_cast<bool>(is);
+    }
+  }
+
+  void CachingModelEvaluator::writeToDisk(const CacheEntry& e)
+  {
+    // Entries with colliding hashes are appended to the same file.
+    // A file not yet written by this object is truncated so that
+    // stale entries from other runs are never read.
+    const std::string fileName = this->diskCacheFileName(e.hash);
+    const bool newFile = diskCacheFiles_.insert(fileName).second;
+    std::ofstream os(fileName.c_str(), std::ios::binary | (newFile ? std::ios::trunc : std::ios::app));
+    TEUCHOS_TEST_FOR_EXCEPTION(!os, std::runtime_error,
+			       "Error: the CachingModelEvaluator for the model \"" << this->name()
+			       << "\" failed to open the disk cache file \"" << fileName << "\"!");
+
+    const std::size_t numParameters = e.parameters.size();
+    os.write(reinterpret_cast<const char*>(&numParameters),sizeof(numParameters));
+    for (std::size_t l = 0; l < numParameters; ++l) {
+      const char isSet = e.parameterIsSet[l] ? 1 : 0;
+      os.write(&isSet,1);
+      writeValues(os,e.parameters[l]);
+    }
+    const std::size_t numResponses = e.responses.size();
+    os.write(reinterpret_cast<const char*>(&numResponses),sizeof(numResponses));
+    for (std::size_t j = 0; j < numResponses; ++j)
+      writeValues(os,e.responses[j]);
+    const char flags[2] = {static_cast<char>(e.locallyConverged), static_cast<char>(e.globallyConverged)};
+    os.write(flags,2);
+  }
+
+  bool CachingModelEvaluator::readFromDisk(const std::size_t hash, CacheEntry& e) const
+  {
+    const std::string fileName = this->diskCacheFileName(hash);
+    if (diskCacheFiles_.find(fileName) == diskCacheFiles_.end())
+      return false;
+
+    std::ifstream is(fileName.c_str(), std::ios::binary);
+    if (!is)
+      return false;
+
+    std::size_t numParameters = 0;
+    while (is.read(reinterpret_cast<char*>(&numParameters),sizeof(numParameters))) {
+      e.hash = hash;
+      e.parameters.resize(numParameters);
+      e.parameterIsSet.resize(numParameters);
+      for (std::size_t l = 0; l < numParameters; ++l) {
+	char isSet = 0;
+	is.read(&isSet,1);
+	e.parameterIsSet[l] = (isSet != 0);
+	if (!readValues(is,e.parameters[l]))
+	  return false;
+      }
+      std::size_t numResponses = 0;
+      if (!is.read(reinterpret_cast<char*>(&numResponses),sizeof(numResponses)))
+	return false;
+      e.responses.resize(numResponses);
+      for (std::size_t j = 0; j < numResponses; ++j)
+	if (!readValues(is,e.responses[j]))
+	  return false;
+      char flags[2];
+      if (!is.read(flags,2))
+	return false;
+      e.locallyConverged = (flags[0] != 0);
+      e.globallyConverged = (flags[1] != 0);
+      e.onDisk = true;
+
+      if (this->matchesCurrentParameters(e))
+	return true;
+    }
+    return false;
+  }
+
+  // Non-member ctor
+  Teuchos::RCP<CachingModelEvaluator>
+  cachingModelEvaluator(const Teuchos::RCP<pike::BlackBoxModelEvaluator>& model)
+  {
+    return Teuchos::rcp(new CachingModelEvaluator(model));
+  }
+
+}
@@ -0,0 +1,198 @@
+#ifndef PIKE_BLACK_BOX_MODEL_EVALUATOR_CACHING_HPP
+#define PIKE_BLACK_BOX_MODEL_EVALUATOR_CACHING_HPP
+
+#include "Pike_BlackBoxModelEvaluator.hpp"
+#include "Teuchos_RCP.hpp"
+#include "Teuchos_ParameterListAcceptorDefaultBase.hpp"
+#include <vector>
+#include <string>
+#include <list>
+#include <unordered_map>
+#include <set>
+
+namespace Teuchos {
+  template<typename > class Comm;
+}
+
+namespace pike {
+
+  /** \brief A BlackBoxModelEvaluator decorator that memoizes solves
+      on the values of the parameters.
+
+      Every call to setParameter() is forwarded to the wrapped model
+      and recorded.  On a call to solve(), the complete set of
+      parameter values is hashed and looked up in the cache.  On a hit
+      the wrapped model is not solved; the responses and convergence
+      flags of the cached solve are restored instead.  On a miss the
+      wrapped model is solved and its responses are added to the
+      cache.
+
+      Cached entries are kept in memory in least recently used order
+      and are evicted once the "Memory Budget (MB)" is exceeded.  The
+      responses are served from the entry of the last solve without
+      copying it.  If that entry is evicted or cleared, it is kept
+      outside of the cache until the next solve.  If a
+      "Disk Cache Directory" is given, evicted entries are written to
+      that directory and are searched on a memory miss before the
+      wrapped model is solved.  The disk tier is not bounded.  It is
+      scratch space private to this object: only files written by
+      this object are read, and they are removed by clearCache() and
+      in the destructor.
+
+      Keys are compared exactly (bitwise on the parameter values), so
+      only repeated evaluations at identical parameter points hit the
+      cache.  Parameters that were never set through this decorator
+      are part of the key as "unset".  Changing parameters of the
+      wrapped model directly bypasses the decorator and invalidates
+      the cache.
+
+      Transient models are not cached: if the wrapped model returns
+      true for isTransient(), all calls are forwarded.
+
+      If the wrapped model solves on more than one process, the comm
+      of the model must be registered with registerComm().  A solve
+      is then answered from the cache only if it is a hit on every
+      process of the comm, and all processes evict the same entries.
+      Otherwise a process that missed would enter a collective solve
+      of the wrapped model alone.  Without a registered comm all
+      decisions are local to each process.
+   */
+  class CachingModelEvaluator : public pike::BlackBoxModelEvaluator,
+				public Teuchos::ParameterListAcceptorDefaultBase {
+
+  public:
+
+    CachingModelEvaluator(const Teuchos::RCP<pike::BlackBoxModelEvaluator>& model);
+
+    ~CachingModelEvaluator();
+
+    // Base methods
+    std::string name() const;
+    void solve();
+    bool isLocallyConverged() const;
+    bool isGloballyConverged() const;
+
+    // Response support
+    Teuchos::ArrayView<const double> getResponse(const int i) const;
+    int getResponseIndex(const std::string& rName) const;
+    std::string getResponseName(const int i) const;
+    bool supportsResponse(const std::string& rName) const;
+    int getNumberOfResponses() const;
+    int getResponseSize(const int j) const;
+    void getResponses(const Teuchos::ArrayView<const int>& j, const Teuchos::ArrayView<double>& g) const;
+
+    // Parameter support
+    bool supportsParameter(const std::string& pName) const;
+    int getNumberOfParameters() const;
+    std::string getParameterName(const int l) const;
+    int getParameterIndex(const std::string& pName) const;
+    void setParameter(const int l, const Teuchos::ArrayView<const double>& p);
+    Teuchos::ArrayView<const double> getParameter(const int l) const;
+    int getParameterSize(const int l) const;
+    void setParameters(const Teuchos::ArrayView<const int>& l, const Teuchos::ArrayView<const double>& p);
+
+    // Transient support
+    bool isTransient() const;
+    double getCurrentTime() const;
+    double getTentativeTime() const;
+    bool solvedTentativeStep() const;
+    double getCurrentTimeStepSize() const;
+    double getDesiredTimeStepSize() const;
+    double getMaxTimeStepSize() const;
+    void setNextTimeStepSize(const double& dt);
+    void acceptTimeStep();
+
+    void setParameterList(const Teuchos::RCP<Teuchos::ParameterList>& paramList);
+
+    Teuchos::RCP<const Teuchos::ParameterList> getValidParameters() const;
+
+    //! Registers the comm of the wrapped model.  Cache hits and evictions are then decided collectively over it.
+    void registerComm(const Teuchos::RCP<const Teuchos::Comm<int> >& comm);
+
+    //! Removes all cache entries, including the files written to the disk cache directory.
+    void clearCache();
+
+    //! Number of calls to solve() answered from the memory or disk cache.
+    int getNumberOfCacheHits() const;
+
+    //! Number of calls to solve() answered from the disk cache.
+    int getNumberOfDiskCacheHits() const;
+
+    //! Number of calls to solve() that required a solve of the wrapped model.
+    int getNumberOfCacheMisses() const;
+
+    //! Number of entries currently held in memory.
+    int getNumberOfCachedEntries() const;
+
+    //! Number of bytes of parameter and response data currently held in memory.
+    std::size_t getMemoryUsage() const;
+
+  private:
+
+    struct CacheEntry {
+      std::size_t hash;
+      //! Parameter values of the solve.  Unset parameters are empty.
+      std::vector<std::vector<double> > parameters;
+      std::vector<bool> parameterIsSet;
+      std::vector<std::vector<double> > responses;
+      bool locallyConverged;
+      bool globallyConverged;
+      //! True if the entry was already written to (or read from) the disk cache.
+      bool onDisk;
+    };
+
+    typedef std::list<CacheEntry>::iterator EntryIterator;
+
+    std::size_t hashParameters() const;
+    bool matchesCurrentParameters(const CacheEntry& e) const;
+    //! Records the value of a parameter set through this decorator.
+    void recordParameter(const int l, const Teuchos::ArrayView<const double>& p);
+    std::size_t sizeInBytes(const CacheEntry& e) const;
+    //! Adds the entry at the front of the LRU list without evicting.
+    void insertInMemory(CacheEntry&& e);
+    //! Removes the entry from the cache.  The entry of the last solve is retired instead of destroyed.
+    void eraseFromMemory(const EntryIterator e);
+    void setCurrentSolve(const EntryIterator e);
+    void evictToBudget();
+    std::string diskCacheFileName(const std::size_t hash) const;
+    void writeToDisk(const CacheEntry& e);
+    bool readFromDisk(const std::size_t hash, CacheEntry& e) const;
+
+    Teuchos::RCP<pike::BlackBoxModelEvaluator> model_;
+    Teuchos::RCP<const Teuchos::Comm<int> > comm_;
+    Teuchos::RCP<Teuchos::ParameterList> validParameters_;
+
+    std::size_t memoryBudget_;
+    std::string diskCacheDirectory_;
+    //! Disk cache files written by this object.
+    std::set<std::string> diskCacheFiles_;
+
+    //! Most recently used entries are at the front.
+    std::list<CacheEntry> entries_;
+    std::unordered_multimap<std::size_t,EntryIterator> hashToEntry_;
+    std::size_t memoryUsage_;
+
+    //! The parameter values most recently set through this decorator.
+    std::vector<std::vector<double> > currentParameters_;
+    std::vector<bool> currentParameterIsSet_;
+
+    //! Entry of the last solve (cached or not) that serves the responses and convergence flags.
+    bool haveCurrentSolve_;
+    EntryIterator currentSolve_;
+    //! Holds the entry of the last solve once it left the cache.
+    std::list<CacheEntry> retiredCurrentSolve_;
+
+    int numberOfCacheHits_;
+    int numberOfDiskCacheHits_;
+    int numberOfCacheMisses_;
+  };
+
+  /** \brief Non-member ctor
+      \relates CachingModelEvaluator
+  */
+  Teuchos::RCP<CachingModelEvaluator>
+  cachingModelEvaluator(const Teuchos::RCP<pike::BlackBoxModelEvaluator>& model);
+
+}
+
+#endif
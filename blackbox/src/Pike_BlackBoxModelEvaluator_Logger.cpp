@@ -50,6 +50,17 @@ namespace pike {
     log_->push_back(this->name()+": getResponse()");
     return model_->getResponse(i);
   }
+
+  int ModelEvaluatorLogger::getResponseSize(const int j) const
+  {
+    return model_->getResponseSize(j);
+  }
+
+  void ModelEvaluatorLogger::getResponses(const Teuchos::ArrayView<const int>& j, const Teuchos::ArrayView<double>& g) const
+  {
+    log_->push_back(this->name()+": getResponses()");
+    model_->getResponses(j,g);
+  }
   
   int ModelEvaluatorLogger::getResponseIndex(const std::string& rName) const
   {
@@ -97,6 +108,23 @@ namespace pike {
     return model_->setParameter(l,p);
   }
 
+  Teuchos::ArrayView<const double> ModelEvaluatorLogger::getParameter(const int l) const
+  {
+    log_->push_back(this->name()+": getParameter(l)");
+    return model_->getParameter(l);
+  }
+
+  int ModelEvaluatorLogger::getParameterSize(const int l) const
+  {
+    return model_->getParameterSize(l);
+  }
+
+  void ModelEvaluatorLogger::setParameters(const Teuchos::ArrayView<const int>& l, const Teuchos::ArrayView<const double>& p)
+  {
+    log_->push_back(this->name()+": setParameters(l,p)");
+    model_->setParameters(l,p);
+  }
+
   bool ModelEvaluatorLogger::isTransient() const
   {
     return model_->isTransient();
@@ -36,6 +36,8 @@ namespace pike {
     std::string getResponseName(const int i) const;
     bool supportsResponse(const std::string& rName) const;
     int getNumberOfResponses() const;
+    int getResponseSize(const int j) const;
+    void getResponses(const Teuchos::ArrayView<const int>& j, const Teuchos::ArrayView<double>& g) const;
 
     // Parameter support
     bool supportsParameter(const std::string& pName) const;
@@ -43,6 +45,9 @@ namespace pike {
     std::string getParameterName(const int l) const;
     int getParameterIndex(const std::string& pName) const;
     void setParameter(const int l, const Teuchos::ArrayView<const double>& p);
+    Teuchos::ArrayView<const double> getParameter(const int l) const;
+    int getParameterSize(const int l) const;
+    void setParameters(const Teuchos::ArrayView<const int>& l, const Teuchos::ArrayView<const double>& p);
 
     // Transient support
     bool isTransient() const;
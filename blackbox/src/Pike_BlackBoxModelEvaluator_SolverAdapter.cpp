@@ -10,13 +10,25 @@ namespace pike {
   {
     solver_ = solver;
 
-    std::vector<Teuchos::RCP<const pike::BlackBoxModelEvaluator> > models = 
-      solver_->getModelEvaluators();
+    const Teuchos::ArrayView<const Teuchos::RCP<const pike::BlackBoxModelEvaluator> > models = 
+      solver_->getModelEvaluatorsView();
+
+    // Not ideal.  const_cast or friend class with nonconst private
+    // accessor or put public nonconst accessor on solver base.  None
+    // are appealing.  This best protects users.
+    models_.clear();
+    transientModels_.clear();
+    for (Teuchos::ArrayView<const Teuchos::RCP<const pike::BlackBoxModelEvaluator> >::iterator m = models.begin();
+	 m != models.end(); ++m) {
+      models_.push_back(const_cast<pike::BlackBoxModelEvaluator*>(m->get()));
+      if ((*m)->isTransient())
+	transientModels_.push_back(models_.back());
+    }
 
     parameterNames_.clear();
     parameterNameToIndex_.clear();
     parameterIndexToModelIndices_.clear();
-    for (std::size_t m = 0; m < models.size(); ++m) {
+    for (std::size_t m = 0; m < models_.size(); ++m) {
       for (int p=0; p < models[m]->getNumberOfParameters(); ++p) {
 
 	// Make sure that different model evaluators don't have the
@@ -50,7 +62,7 @@ namespace pike {
     responseNames_.clear();
     responseNameToIndex_.clear();
     responseIndexToModelIndices_.clear();
-    for (std::size_t m = 0; m < models.size(); ++m) {
+    for (std::size_t m = 0; m < models_.size(); ++m) {
       for (int r=0; r < models[m]->getNumberOfResponses(); ++r) {
 
 	// Make sure that multiple model evaluators do not have the same response
@@ -120,13 +132,50 @@ namespace pike {
     TEUCHOS_ASSERT(l >= 0);
     TEUCHOS_ASSERT(l < static_cast<int>(parameterNames_.size()));
     
-    const std::vector<std::pair<int,int>>& meToSet = parameterIndexToModelIndices_[l];
+    const std::vector<std::pair<int,int> >& meToSet = parameterIndexToModelIndices_[l];
+    for (std::vector<std::pair<int,int> >::const_iterator me = meToSet.begin(); me != meToSet.end(); ++me)
+      models_[me->first]->setParameter(me->second,p);
+  }
 
-    // Not ideal.  const_cast or friend class with nonconst private
-    // accessor or put public nonconst accessor on solver base.  None
-    // are appealing.  This best protects users.
-    for (int i=0; i < static_cast<int>(meToSet.size()); ++i)
-    const_cast<pike::BlackBoxModelEvaluator&>(*(solver_->getModelEvaluators()[parameterIndexToModelIndices_[l][i].first])).setParameter(parameterIndexToModelIndices_[l][i].second,p);
+  Teuchos::ArrayView<const double> SolverAdapterModelEvaluator::getParameter(const int l) const
+  {
+    TEUCHOS_ASSERT(l >= 0);
+    TEUCHOS_ASSERT(l < static_cast<int>(parameterNames_.size()));
+
+    // All models sharing this parameter are set to the same value, so
+    // return the value of the first.
+    const std::pair<int,int>& meToGet = parameterIndexToModelIndices_[l][0];
+    return models_[meToGet.first]->getParameter(meToGet.second);
+  }
+
+  int SolverAdapterModelEvaluator::getParameterSize(const int l) const
+  {
+    TEUCHOS_ASSERT(l >= 0);
+    TEUCHOS_ASSERT(l < static_cast<int>(parameterNames_.size()));
+    const std::pair<int,int>& me = parameterIndexToModelIndices_[l][0];
+    return models_[me.first]->getParameterSize(me.second);
+  }
+
+  void SolverAdapterModelEvaluator::setParameters(const Teuchos::ArrayView<const int>& l, const Teuchos::ArrayView<const double>& p)
+  {
+    const std::vector<Teuchos::Ordinal> offsets = this->getPackedParameterOffsets(l,p.size());
+
+    // Gather the parameters of each model so that every model gets a
+    // single batched call
+    std::vector<std::vector<int> > modelIndices(models_.size());
+    std::vector<std::vector<double> > modelValues(models_.size());
+    for (Teuchos::Ordinal i = 0; i < l.size(); ++i) {
+      TEUCHOS_ASSERT( (l[i] >= 0) && (l[i] < static_cast<int>(parameterNames_.size())) );
+      const std::vector<std::pair<int,int> >& meToSet = parameterIndexToModelIndices_[l[i]];
+      for (std::vector<std::pair<int,int> >::const_iterator me = meToSet.begin(); me != meToSet.end(); ++me) {
+	modelIndices[me->first].push_back(me->second);
+	modelValues[me->first].insert(modelValues[me->first].end(),p.begin()+offsets[i],p.begin()+offsets[i+1]);
+      }
+    }
+
+    for (std::size_t m = 0; m < models_.size(); ++m)
+      if (modelIndices[m].size() > 0)
+	models_[m]->setParameters(Teuchos::arrayViewFromVector(modelIndices[m]),Teuchos::arrayViewFromVector(modelValues[m]));
   }
 
   bool SolverAdapterModelEvaluator::supportsResponse(const std::string& rName) const
@@ -154,78 +203,85 @@ namespace pike {
 
   Teuchos::ArrayView<const double> SolverAdapterModelEvaluator::getResponse(const int i) const
   {
-    return solver_->getModelEvaluators()[responseIndexToModelIndices_[i].first]->getResponse(responseIndexToModelIndices_[i].second);
+    return models_[responseIndexToModelIndices_[i].first]->getResponse(responseIndexToModelIndices_[i].second);
   }
 
-  bool SolverAdapterModelEvaluator::isTransient() const
+  int SolverAdapterModelEvaluator::getResponseSize(const int i) const
   {
-    auto models = solver_->getModelEvaluators();
-    bool tmpIsTransient = false;
+    return models_[responseIndexToModelIndices_[i].first]->getResponseSize(responseIndexToModelIndices_[i].second);
+  }
 
+  void SolverAdapterModelEvaluator::getResponses(const Teuchos::ArrayView<const int>& j, const Teuchos::ArrayView<double>& g) const
+  {
+    const std::vector<Teuchos::Ordinal> offsets = this->getPackedResponseOffsets(j,g.size());
+
+    // Forward each run of consecutive responses of the same model in
+    // one batched call that writes directly into g
+    std::vector<int> modelIndices;
+    for (Teuchos::Ordinal begin = 0; begin < j.size(); ) {
+      const int m = responseIndexToModelIndices_[j[begin]].first;
+      modelIndices.clear();
+      Teuchos::Ordinal end = begin;
+      while ( (end < j.size()) && (responseIndexToModelIndices_[j[end]].first == m) ) {
+	modelIndices.push_back(responseIndexToModelIndices_[j[end]].second);
+	++end;
+      }
+      models_[m]->getResponses(Teuchos::arrayViewFromVector(modelIndices),g(offsets[begin],offsets[end]-offsets[begin]));
+      begin = end;
+    }
+  }
+
+  bool SolverAdapterModelEvaluator::isTransient() const
+  {
     // returns true if any me is true, false otherwise
-    for (auto me=models.cbegin(); me != models.cend(); ++me)
-      tmpIsTransient = ((*me)->isTransient() || tmpIsTransient);
-    
-    return tmpIsTransient;
+    return (transientModels_.size() > 0);
   }
 
   double SolverAdapterModelEvaluator::getCurrentTime() const
   {
-    auto models = solver_->getModelEvaluators();    
     double currentTime = -1.0;
 
-    for (auto me=models.cbegin(); me != models.cend(); ++me) {
-      if ((*me)->isTransient())
-	currentTime = (*me)->getCurrentTime();
-    }
+    for (ModelConstIterator me = transientModels_.begin(); me != transientModels_.end(); ++me)
+      currentTime = (*me)->getCurrentTime();
 
     return currentTime;
   }
 
   double SolverAdapterModelEvaluator::getTentativeTime() const
   {
-    auto models = solver_->getModelEvaluators();    
     double tentativeTime = -1.0;
 
-    for (auto me=models.cbegin(); me != models.cend(); ++me) {
-      if ((*me)->isTransient())
-	tentativeTime = (*me)->getTentativeTime();
-    }
+    for (ModelConstIterator me = transientModels_.begin(); me != transientModels_.end(); ++me)
+      tentativeTime = (*me)->getTentativeTime();
 
     return tentativeTime;
   }
 
   bool SolverAdapterModelEvaluator::solvedTentativeStep() const
   {
-    auto models = solver_->getModelEvaluators();    
     bool tmpSolvedTentativeStep = false;
 
-    for (auto me=models.cbegin(); me != models.cend(); ++me) {
-      if ((*me)->isTransient())
-        tmpSolvedTentativeStep = (*me)->solvedTentativeStep();
-    }
+    for (ModelConstIterator me = transientModels_.begin(); me != transientModels_.end(); ++me)
+      tmpSolvedTentativeStep = (*me)->solvedTentativeStep();
 
     return tmpSolvedTentativeStep;    
   }
 
   double SolverAdapterModelEvaluator::getCurrentTimeStepSize() const
   {
-    auto models = solver_->getModelEvaluators();    
     double currentTimeStepSize = -1.0;
     
-    for (auto me=models.cbegin(); me != models.cend(); ++me) {
+    for (ModelConstIterator me = models_.begin(); me != models_.end(); ++me)
       currentTimeStepSize = (*me)->getCurrentTimeStepSize();
-    }
 
     return currentTimeStepSize;
   }
 
   double SolverAdapterModelEvaluator::getDesiredTimeStepSize() const
   {
-    auto models = solver_->getModelEvaluators();    
     double desiredTimeStepSize = std::numeric_limits<double>::max();
 
-    for (auto me=models.cbegin(); me != models.cend(); ++me)
+    for (ModelConstIterator me = models_.begin(); me != models_.end(); ++me)
       desiredTimeStepSize = std::min( (*me)->getDesiredTimeStepSize(), desiredTimeStepSize );
     
     return desiredTimeStepSize;
@@ -233,10 +289,9 @@ namespace pike {
 
   double SolverAdapterModelEvaluator::getMaxTimeStepSize() const
   {
-    auto models = solver_->getModelEvaluators();    
     double maxTimeStepSize = std::numeric_limits<double>::max();
 
-    for (auto me=models.cbegin(); me != models.cend(); ++me)
+    for (ModelConstIterator me = models_.begin(); me != models_.end(); ++me)
       maxTimeStepSize = std::min( (*me)->getMaxTimeStepSize(), maxTimeStepSize );
     
     return maxTimeStepSize; 
@@ -244,18 +299,14 @@ namespace pike {
   
   void SolverAdapterModelEvaluator::setNextTimeStepSize(const double& dt)
   {
-    auto models = solver_->getModelEvaluators();    
-    for (auto me=models.begin(); me != models.end(); ++me)
-      if ((*me)->isTransient())
-	Teuchos::rcp_const_cast<pike::BlackBoxModelEvaluator>(*me)->setNextTimeStepSize(dt);
+    for (ModelConstIterator me = transientModels_.begin(); me != transientModels_.end(); ++me)
+      (*me)->setNextTimeStepSize(dt);
   }
   
   void SolverAdapterModelEvaluator::acceptTimeStep()
   {
-    auto models = solver_->getModelEvaluators();    
-    for (auto me=models.begin(); me != models.end(); ++me)
-      if ((*me)->isTransient())
-	Teuchos::rcp_const_cast<pike::BlackBoxModelEvaluator>(*me)->acceptTimeStep();
+    for (ModelConstIterator me = transientModels_.begin(); me != transientModels_.end(); ++me)
+      (*me)->acceptTimeStep();
   }
 
 }
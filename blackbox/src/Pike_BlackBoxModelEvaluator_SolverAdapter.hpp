@@ -6,6 +6,7 @@
 #include <utility>
 #include <string>
 #include <map>
+#include <vector>
 
 namespace pike {
 
@@ -36,12 +37,17 @@ namespace pike {
     std::string getParameterName(const int l) const;
     int getParameterIndex(const std::string& pName) const;
     void setParameter(const int l, const Teuchos::ArrayView<const double>& p);
+    Teuchos::ArrayView<const double> getParameter(const int l) const;
+    int getParameterSize(const int l) const;
+    void setParameters(const Teuchos::ArrayView<const int>& l, const Teuchos::ArrayView<const double>& p);
 
     bool supportsResponse(const std::string& rName) const;
     int getNumberOfResponses() const;
     std::string getResponseName(const int i) const;
     int getResponseIndex(const std::string& rName) const;
     Teuchos::ArrayView<const double> getResponse(const int i) const;
+    int getResponseSize(const int i) const;
+    void getResponses(const Teuchos::ArrayView<const int>& j, const Teuchos::ArrayView<double>& g) const;
 
     bool isTransient() const;
     double getCurrentTime() const;
@@ -54,9 +60,21 @@ namespace pike {
     void acceptTimeStep();
 
   private:
+    typedef std::vector<pike::BlackBoxModelEvaluator*>::const_iterator ModelConstIterator;
+
     std::string name_;
     Teuchos::RCP<pike::Solver> solver_;
 
+    /** \brief The models registered with the solver, cached in setSolver().
+
+	The solver owns the models and is kept alive by solver_, so
+	raw pointers are safe and avoid copying and reference
+	counting the RCPs on every call.
+    */
+    std::vector<pike::BlackBoxModelEvaluator*> models_;
+    //! The transient subset of models_.
+    std::vector<pike::BlackBoxModelEvaluator*> transientModels_;
+
     std::map<std::string,int> parameterNameToIndex_;
     std::vector<std::string> parameterNames_;
     //! Stores the model index and the parameter index in that model for the parameter. Note that multiple underlying model evaluators can support the same parameter. 
@@ -0,0 +1,23 @@
+#include "Pike_DataTransfer.hpp"
+
+namespace pike {
+
+  bool DataTransfer::changedTarget(const std::string& ) const
+  {
+    return true;
+  }
+
+  void DataTransfer::targetSolved(const std::string& )
+  { }
+
+  double DataTransfer::getChangeNormSquared() const
+  {
+    return -1.0;
+  }
+
+  double DataTransfer::getTargetNormSquared() const
+  {
+    return -1.0;
+  }
+
+}
@@ -25,6 +25,44 @@ namespace pike {
     virtual const std::vector<std::string>& getSourceModelNames() const = 0;
     
     virtual const std::vector<std::string>& getTargetModelNames() const = 0;
+
+    /** \brief Returns true if the data this transfer wrote to the
+	target model changed by more than the transfer's change
+	tolerance since the last call to targetSolved() for that
+	model.
+
+	Solvers use this to skip solves of models whose inputs have
+	not changed since their last solve.  Comparing against the
+	data at the target's last solve, not against the previous
+	transfer, keeps many small changes below the tolerance from
+	adding up.  The default implementation conservatively returns
+	true.  Transfers that can cheaply compare target values should
+	override this and targetSolved().
+    */
+    virtual bool changedTarget(const std::string& targetModelName) const;
+
+    /** \brief Called by the solver after the target model was
+	solved with the data currently written to it.  The default
+	implementation does nothing.
+    */
+    virtual void targetSolved(const std::string& targetModelName);
+
+    /** \brief Returns the squared L2 norm of the change of the
+	target data made by the last call to doTransfer().
+
+	Transfers should accumulate this while they write the targets
+	(new value minus the value being overwritten), so measuring it
+	costs no extra pass over the data.  Used by the "Global
+	Coupling Residual" status test.  The default implementation
+	returns a negative value, meaning the change is not measured.
+    */
+    virtual double getChangeNormSquared() const;
+
+    /** \brief Returns the squared L2 norm of the target data written
+	by the last call to doTransfer(), for relative coupling
+	residuals.  Negative if not measured (the default).
+    */
+    virtual double getTargetNormSquared() const;
   };
 
 }
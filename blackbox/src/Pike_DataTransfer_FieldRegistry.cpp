@@ -0,0 +1,73 @@
+#include "Pike_DataTransfer_FieldRegistry.hpp"
+#include "Pike_FieldRegistry.hpp"
+#include "Teuchos_Assert.hpp"
+
+namespace pike {
+
+  FieldRegistryDataTransfer::FieldRegistryDataTransfer(const std::string& myName,
+						       const Teuchos::RCP<pike::FieldRegistry>& registry) :
+    name_(myName),
+    registry_(registry)
+  {
+    TEUCHOS_ASSERT(nonnull(registry_));
+  }
+
+  void FieldRegistryDataTransfer::addField(const std::string& fieldName)
+  {
+    TEUCHOS_TEST_FOR_EXCEPTION(!registry_->hasField(fieldName), std::logic_error,
+			       "Error: pike::FieldRegistryDataTransfer::addField() - the field \"" << fieldName
+			       << "\" added to the transfer \"" << name_ << "\" is not registered!");
+    fieldNames_.push_back(fieldName);
+  }
+
+  void FieldRegistryDataTransfer::addSourceModelName(const std::string& modelName)
+  {
+    sourceNames_.push_back(modelName);
+  }
+
+  void FieldRegistryDataTransfer::addTargetModelName(const std::string& modelName)
+  {
+    targetNames_.push_back(modelName);
+  }
+
+  Teuchos::RCP<const pike::FieldRegistry> FieldRegistryDataTransfer::getFieldRegistry() const
+  {
+    return registry_;
+  }
+
+  std::string FieldRegistryDataTransfer::name() const
+  {
+    return name_;
+  }
+
+  bool FieldRegistryDataTransfer::doTransfer(const pike::Solver&)
+  {
+    for (std::vector<std::string>::const_iterator f = fieldNames_.begin(); f != fieldNames_.end(); ++f)
+      registry_->publish(*f);
+    return true;
+  }
+
+  bool FieldRegistryDataTransfer::transferSucceeded() const
+  {
+    return true;
+  }
+
+  const std::vector<std::string>& FieldRegistryDataTransfer::getSourceModelNames() const
+  {
+    return sourceNames_;
+  }
+    
+  const std::vector<std::string>& FieldRegistryDataTransfer::getTargetModelNames() const
+  {
+    return targetNames_;
+  }
+
+  // Non-member ctor
+  Teuchos::RCP<pike::FieldRegistryDataTransfer>
+  fieldRegistryDataTransfer(const std::string& name,
+			    const Teuchos::RCP<pike::FieldRegistry>& registry)
+  {
+    return Teuchos::rcp(new pike::FieldRegistryDataTransfer(name,registry));
+  }
+
+}
@@ -0,0 +1,67 @@
+#ifndef PIKE_DATA_TRANSFER_FIELD_REGISTRY_HPP
+#define PIKE_DATA_TRANSFER_FIELD_REGISTRY_HPP
+
+#include "Pike_DataTransfer.hpp"
+#include "Teuchos_RCP.hpp"
+#include <vector>
+#include <string>
+
+namespace pike {
+
+  class FieldRegistry;
+
+  /** \brief A DataTransfer that publishes fields of a
+      pike::FieldRegistry.
+
+      doTransfer() publishes each added field, making the values
+      written by the source model visible to the target models
+      without copying.  Fields not written since their last publish
+      are left as is, so the transfer can safely be run more than
+      once per iteration.  The source and target model names are
+      only used by the solvers to order the transfers.
+   */
+  class FieldRegistryDataTransfer : public pike::DataTransfer {
+
+  public:
+
+    FieldRegistryDataTransfer(const std::string& myName,
+			      const Teuchos::RCP<pike::FieldRegistry>& registry);
+
+    //! Adds a registered field to publish in doTransfer().
+    void addField(const std::string& fieldName);
+
+    void addSourceModelName(const std::string& modelName);
+
+    void addTargetModelName(const std::string& modelName);
+
+    Teuchos::RCP<const pike::FieldRegistry> getFieldRegistry() const;
+
+    std::string name() const;
+
+    bool doTransfer(const pike::Solver& solver);
+
+    bool transferSucceeded() const;
+
+    const std::vector<std::string>& getSourceModelNames() const;
+    
+    const std::vector<std::string>& getTargetModelNames() const;
+
+  private:
+
+    std::string name_;
+    Teuchos::RCP<pike::FieldRegistry> registry_;
+    std::vector<std::string> fieldNames_;
+    std::vector<std::string> sourceNames_;
+    std::vector<std::string> targetNames_;
+  };
+
+  /** \brief Non-member ctor
+      \relates FieldRegistryDataTransfer
+  */
+  Teuchos::RCP<pike::FieldRegistryDataTransfer>
+  fieldRegistryDataTransfer(const std::string& name,
+			    const Teuchos::RCP<pike::FieldRegistry>& registry);
+
+}
+
+#endif
@@ -49,6 +49,26 @@ namespace pike {
     return transfer_->getTargetModelNames();
   }
 
+  bool DataTransferLogger::changedTarget(const std::string& targetModelName) const
+  {
+    return transfer_->changedTarget(targetModelName);
+  }
+
+  void DataTransferLogger::targetSolved(const std::string& targetModelName)
+  {
+    transfer_->targetSolved(targetModelName);
+  }
+
+  double DataTransferLogger::getChangeNormSquared() const
+  {
+    return transfer_->getChangeNormSquared();
+  }
+
+  double DataTransferLogger::getTargetNormSquared() const
+  {
+    return transfer_->getTargetNormSquared();
+  }
+
   // Non-member ctor
   Teuchos::RCP<pike::DataTransferLogger> 
   dataTransferLogger(const Teuchos::RCP<pike::DataTransfer>& transfer)
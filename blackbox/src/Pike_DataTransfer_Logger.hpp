@@ -34,6 +34,14 @@ namespace pike {
     
     const std::vector<std::string>& getTargetModelNames() const;
 
+    bool changedTarget(const std::string& targetModelName) const;
+
+    void targetSolved(const std::string& targetModelName);
+
+    double getChangeNormSquared() const;
+
+    double getTargetNormSquared() const;
+
   private:
     
     Teuchos::RCP<std::vector<std::string> > log_;
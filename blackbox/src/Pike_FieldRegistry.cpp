@@ -0,0 +1,101 @@
+#include "Pike_FieldRegistry.hpp"
+#include "Teuchos_Assert.hpp"
+
+namespace pike {
+
+  FieldRegistry::FieldRegistry() {}
+
+  void FieldRegistry::registerField(const std::string& name, const std::size_t size, const double initialValue)
+  {
+    TEUCHOS_TEST_FOR_EXCEPTION(this->hasField(name), std::logic_error,
+			       "Error: pike::FieldRegistry::registerField() - the field \"" << name
+			       << "\" is already registered!");
+    Field& f = fields_[name];
+    f.buffers[0].assign(size,initialValue);
+    f.buffers[1].assign(size,initialValue);
+    f.front = 0;
+    f.version = 0;
+    f.written = false;
+  }
+
+  bool FieldRegistry::hasField(const std::string& name) const
+  {
+    return (fields_.find(name) != fields_.end());
+  }
+
+  std::size_t FieldRegistry::getFieldSize(const std::string& name) const
+  {
+    return this->getField(name).buffers[0].size();
+  }
+
+  Teuchos::ArrayView<double> FieldRegistry::getNonconstSourceBuffer(const std::string& name)
+  {
+    Field& f = this->getField(name);
+    f.written = true;
+    return Teuchos::arrayViewFromVector(f.buffers[1-f.front]);
+  }
+
+  Teuchos::ArrayView<const double> FieldRegistry::getTargetView(const std::string& name) const
+  {
+    const Field& f = this->getField(name);
+    return Teuchos::arrayViewFromVector(f.buffers[f.front]);
+  }
+
+  bool FieldRegistry::publish(const std::string& name)
+  {
+    return this->publish(this->getField(name));
+  }
+
+  void FieldRegistry::publishAll()
+  {
+    for (std::unordered_map<std::string,Field>::iterator f = fields_.begin(); f != fields_.end(); ++f)
+      this->publish(f->second);
+  }
+
+  bool FieldRegistry::publish(Field& f)
+  {
+    if (!f.written)
+      return false;
+
+    f.front = 1 - f.front;
+    ++f.version;
+    f.written = false;
+    return true;
+  }
+
+  int FieldRegistry::getVersion(const std::string& name) const
+  {
+    return this->getField(name).version;
+  }
+
+  std::vector<std::string> FieldRegistry::getFieldNames() const
+  {
+    std::vector<std::string> names;
+    for (std::unordered_map<std::string,Field>::const_iterator f = fields_.begin(); f != fields_.end(); ++f)
+      names.push_back(f->first);
+    return names;
+  }
+
+  FieldRegistry::Field& FieldRegistry::getField(const std::string& name)
+  {
+    std::unordered_map<std::string,Field>::iterator f = fields_.find(name);
+    TEUCHOS_TEST_FOR_EXCEPTION(f == fields_.end(), std::logic_error,
+			       "Error: pike::FieldRegistry - the field \"" << name << "\" is not registered!");
+    return f->second;
+  }
+
+  const FieldRegistry::Field& FieldRegistry::getField(const std::string& name) const
+  {
+    std::unordered_map<std::string,Field>::const_iterator f = fields_.find(name);
+    TEUCHOS_TEST_FOR_EXCEPTION(f == fields_.end(), std::logic_error,
+			       "Error: pike::FieldRegistry - the field \"" << name << "\" is not registered!");
+    return f->second;
+  }
+
+  // Non-member ctor
+  Teuchos::RCP<pike::FieldRegistry> fieldRegistry()
+  {
+    return Teuchos::rcp(new pike::FieldRegistry);
+  }
+
+}
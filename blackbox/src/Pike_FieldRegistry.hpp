@@ -0,0 +1,101 @@
+#ifndef PIKE_FIELD_REGISTRY_HPP
+#define PIKE_FIELD_REGISTRY_HPP
+
+#include "Pike_BlackBox_config.hpp"
+#include "Teuchos_RCP.hpp"
+#include "Teuchos_ArrayView.hpp"
+#include <unordered_map>
+#include <vector>
+#include <string>
+
+namespace pike {
+
+  /** \brief Registry of named, double buffered coupling fields shared
+      by applications in the same process.
+
+      A source application writes a field into the back buffer
+      returned by getNonconstSourceBuffer().  Target applications read
+      the front buffer through getTargetView().  publish() swaps the
+      front and back buffers, so that moving a field from a source to
+      its targets is a pointer swap instead of a copy.
+
+      Requesting the back buffer with getNonconstSourceBuffer() marks
+      the field as written.  publish() only swaps the buffers of a
+      field written since its last publish, so publishing repeatedly
+      (e.g. when a solver runs a transfer more than once per
+      iteration) does not bring back the stale values of the back
+      buffer.
+
+      The double buffering gives block Jacobi semantics: targets keep
+      reading the values published at the previous transfer while the
+      source writes the next values.  Use a
+      pike::FieldRegistryDataTransfer to publish the fields at the
+      point where the solver performs its transfers.
+
+      IMPORTANT: After publish(), the back buffer holds the values
+      published two transfers ago, not the current ones, so a source
+      must overwrite the complete field on every solve.  Views
+      returned by getNonconstSourceBuffer() and getTargetView() are
+      invalidated by publish() and must be requested again.
+   */
+  class FieldRegistry {
+
+  public:
+
+    FieldRegistry();
+
+    /** \brief Registers a field.  Both buffers are initialized to initialValue.
+
+	Throws if a field with the same name is already registered.
+    */
+    void registerField(const std::string& name, const std::size_t size, const double initialValue = 0.0);
+
+    bool hasField(const std::string& name) const;
+
+    std::size_t getFieldSize(const std::string& name) const;
+
+    //! Returns the back buffer of the field for the source application to write and marks the field as written.
+    Teuchos::ArrayView<double> getNonconstSourceBuffer(const std::string& name);
+
+    //! Returns a read only view of the last published values of the field.
+    Teuchos::ArrayView<const double> getTargetView(const std::string& name) const;
+
+    //! Swaps the front and back buffers of the field if it was written since the last publish.  Returns true if the buffers were swapped.
+    bool publish(const std::string& name);
+
+    //! Publishes all fields.
+    void publishAll();
+
+    //! Returns the number of times the buffers of the field were swapped.
+    int getVersion(const std::string& name) const;
+
+    //! Returns the names of all registered fields.
+    std::vector<std::string> getFieldNames() const;
+
+  private:
+
+    struct Field {
+      std::vector<double> buffers[2];
+      //! Index of the buffer read by the targets.
+      int front;
+      int version;
+      //! True if the back buffer was requested since the last swap.
+      bool written;
+    };
+
+    bool publish(Field& f);
+
+    Field& getField(const std::string& name);
+    const Field& getField(const std::string& name) const;
+
+    std::unordered_map<std::string,Field> fields_;
+  };
+
+  /** \brief Non-member ctor
+      \relates FieldRegistry
+  */
+  Teuchos::RCP<pike::FieldRegistry> fieldRegistry();
+
+}
+
+#endif
@@ -0,0 +1,290 @@
+#include "Pike_FiniteDifferenceSensitivity.hpp"
+#include "Pike_BlackBoxModelEvaluator.hpp"
+#include "Teuchos_Comm.hpp"
+#include "Teuchos_CommHelpers.hpp"
+#include "Teuchos_ParameterList.hpp"
+#include "Teuchos_VerboseObjectParameterListHelpers.hpp"
+#include "Teuchos_Assert.hpp"
+#include <cmath>
+#include <map>
+
+namespace pike {
+
+  FiniteDifferenceSensitivity::
+  FiniteDifferenceSensitivity(const Teuchos::RCP<const Teuchos::Comm<int> >& globalComm,
+			      const int numberOfLanes) :
+    globalComm_(globalComm),
+    numberOfLanes_(numberOfLanes),
+    relativePerturbation_(1.0e-6),
+    absolutePerturbation_(1.0e-8),
+    centralDifference_(false),
+    warmStart_(true),
+    numberOfRows_(0),
+    numberOfColumns_(0),
+    allSolvesConverged_(false)
+  {
+    TEUCHOS_TEST_FOR_EXCEPTION( (numberOfLanes < 1) || (numberOfLanes > globalComm->getSize()), std::logic_error,
+				"Error: pike::FiniteDifferenceSensitivity - the number of lanes (" << numberOfLanes
+				<< ") must be between 1 and the size of the global comm (" << globalComm->getSize() << ")!");
+
+    // Contiguous blocks of processes form a lane
+    laneIndex_ = static_cast<int>( (static_cast<long>(globalComm->getRank()) * numberOfLanes) / globalComm->getSize() );
+    laneComm_ = globalComm->split(laneIndex_,globalComm->getRank());
+
+    validParameters_ = Teuchos::parameterList("Valid Parameters: FiniteDifferenceSensitivity");
+    validParameters_->set("Relative Perturbation",1.0e-6,"The perturbation of a parameter entry p is h = Relative Perturbation * |p| + Absolute Perturbation.");
+    validParameters_->set("Absolute Perturbation",1.0e-8,"The perturbation of a parameter entry p is h = Relative Perturbation * |p| + Absolute Perturbation.");
+    validParameters_->set("Difference Type","Forward","Either \"Forward\" (one perturbed solve per column) or \"Central\" (two perturbed solves per column).");
+    validParameters_->set("Warm Start From Nominal",true,"If true, every lane solves the nominal point before its perturbed solves so that they start from the nominal converged state.  If false, the nominal solve is distributed as an additional task.");
+    Teuchos::setupVerboseObjectSublist(validParameters_.get());
+  }
+
+  Teuchos::RCP<const Teuchos::Comm<int> > FiniteDifferenceSensitivity::getLaneComm() const
+  { return laneComm_; }
+
+  int FiniteDifferenceSensitivity::getLaneIndex() const
+  { return laneIndex_; }
+
+  int FiniteDifferenceSensitivity::getNumberOfLanes() const
+  { return numberOfLanes_; }
+
+  void FiniteDifferenceSensitivity::setModel(const Teuchos::RCP<pike::BlackBoxModelEvaluator>& model)
+  {
+    model_ = model;
+  }
+
+  void FiniteDifferenceSensitivity::solveAndGatherResponses(std::vector<double>& g, int& converged)
+  {
+    model_->solve();
+    if (!model_->isLocallyConverged())
+      converged = 0;
+
+    g.clear();
+    for (int j = 0; j < model_->getNumberOfResponses(); ++j) {
+      const Teuchos::ArrayView<const double> r = model_->getResponse(j);
+      g.insert(g.end(),r.begin(),r.end());
+    }
+  }
+
+  void FiniteDifferenceSensitivity::computeSensitivities(const std::vector<std::vector<double> >& nominalParameters)
+  {
+    // Every process must throw, otherwise the others hang in the
+    // collectives below
+    const int localNullModel = is_null(model_) ? 1 : 0;
+    const int localSizeMismatch =
+      ( (localNullModel == 0) && (static_cast<int>(nominalParameters.size()) != model_->getNumberOfParameters()) ) ? 1 : 0;
+    // The max and min of the number of responses must agree
+    const int localNumberOfResponses = (localNullModel == 0) ? model_->getNumberOfResponses() : 0;
+    int localArgumentErrors[4] = {localNullModel, localSizeMismatch, localNumberOfResponses, -localNumberOfResponses};
+    int argumentErrors[4] = {0, 0, 0, 0};
+    Teuchos::reduceAll(*globalComm_,Teuchos::REDUCE_MAX,4,localArgumentErrors,argumentErrors);
+    TEUCHOS_TEST_FOR_EXCEPTION(argumentErrors[0] != 0, std::logic_error,
+			       "Error: pike::FiniteDifferenceSensitivity::computeSensitivities() - setModel() must be called first on all processes!");
+    TEUCHOS_TEST_FOR_EXCEPTION(argumentErrors[1] != 0, std::logic_error,
+			       "Error: pike::FiniteDifferenceSensitivity::computeSensitivities() - the number of nominal parameters ("
+			       << nominalParameters.size() << " on this process) does not match the number of parameters of the model \""
+			       << model_->name() << "\" (" << model_->getNumberOfParameters() << ") on at least one process!");
+    TEUCHOS_TEST_FOR_EXCEPTION(argumentErrors[2] != -argumentErrors[3], std::logic_error,
+			       "Error: pike::FiniteDifferenceSensitivity::computeSensitivities() - the number of responses of the model \""
+			       << model_->name() << "\" differs between processes!");
+
+    // Map columns to (parameter index, entry)
+    columnOffsets_.resize(nominalParameters.size());
+    std::vector<std::pair<int,int> > columnToParameter;
+    for (std::size_t l = 0; l < nominalParameters.size(); ++l) {
+      columnOffsets_[l] = static_cast<int>(columnToParameter.size());
+      for (std::size_t i = 0; i < nominalParameters[l].size(); ++i)
+	columnToParameter.push_back(std::make_pair(static_cast<int>(l),static_cast<int>(i)));
+    }
+    numberOfColumns_ = static_cast<int>(columnToParameter.size());
+
+    for (std::size_t l = 0; l < nominalParameters.size(); ++l)
+      model_->setParameter(static_cast<int>(l),Teuchos::ArrayView<const double>(nominalParameters[l]));
+
+    int converged = 1;
+
+    // Tasks are distributed round-robin over the lanes.  Without a
+    // warm start, task 0 is the nominal solve and task k+1 is column
+    // k.  With a warm start, every lane solves the nominal point and
+    // task k is column k.
+    const int nominalTasks = warmStart_ ? 0 : 1;
+    const int numberOfTasks = numberOfColumns_ + nominalTasks;
+
+    std::vector<double> localNominal;
+    bool computedNominal = false;
+    if (warmStart_) {
+      this->solveAndGatherResponses(localNominal,converged);
+      computedNominal = true;
+    }
+
+    // Results of the columns owned by this lane: either the perturbed
+    // responses (forward) or the difference quotient (central).
+    std::map<int,std::vector<double> > localColumns;
+    std::vector<double> perturbationSizes(numberOfColumns_,0.0);
+
+    for (int task = laneIndex_; task < numberOfTasks; task += numberOfLanes_) {
+
+      if (task < nominalTasks) {
+	this->solveAndGatherResponses(localNominal,converged);
+	computedNominal = true;
+	continue;
+      }
+
+      const int k = task - nominalTasks;
+      const int l = columnToParameter[k].first;
+      const int i = columnToParameter[k].second;
+      const double p = nominalParameters[l][i];
+      double h = relativePerturbation_ * std::fabs(p) + absolutePerturbation_;
+      if (h == 0.0)
+	h = relativePerturbation_;
+      perturbationSizes[k] = h;
+
+      std::vector<double> perturbed(nominalParameters[l]);
+      std::vector<double> gPlus;
+      perturbed[i] = p + h;
+      model_->setParameter(l,Teuchos::ArrayView<const double>(perturbed));
+      this->solveAndGatherResponses(gPlus,converged);
+
+      if (centralDifference_) {
+	std::vector<double> gMinus;
+	perturbed[i] = p - h;
+	model_->setParameter(l,Teuchos::ArrayView<const double>(perturbed));
+	this->solveAndGatherResponses(gMinus,converged);
+	for (std::size_t r = 0; r < gPlus.size(); ++r)
+	  gPlus[r] = (gPlus[r] - gMinus[r]) / (2.0 * h);
+      }
+
+      localColumns[k] = gPlus;
+      model_->setParameter(l,Teuchos::ArrayView<const double>(nominalParameters[l]));
+    }
+
+    // Lanes that did not solve anything do not know the response
+    // sizes, so agree on them through a max reduction.
+    const int numberOfResponses = model_->getNumberOfResponses();
+    std::vector<int> localSizes(numberOfResponses,-1);
+    if (computedNominal || !localColumns.empty())
+      for (int j = 0; j < numberOfResponses; ++j)
+	localSizes[j] = static_cast<int>(model_->getResponse(j).size());
+    std::vector<int> sizes(numberOfResponses,-1);
+    if (numberOfResponses > 0)
+      Teuchos::reduceAll(*globalComm_,Teuchos::REDUCE_MAX,numberOfResponses,&localSizes[0],&sizes[0]);
+
+    rowOffsets_.resize(numberOfResponses);
+    numberOfRows_ = 0;
+    for (int j = 0; j < numberOfResponses; ++j) {
+      TEUCHOS_TEST_FOR_EXCEPTION(sizes[j] < 0, std::logic_error,
+				 "Error: pike::FiniteDifferenceSensitivity::computeSensitivities() - no lane solved the model \""
+				 << model_->name() << "\"!");
+      rowOffsets_[j] = numberOfRows_;
+      numberOfRows_ += sizes[j];
+    }
+
+    // Pack the local results and sum them over all lanes.  Only the
+    // root of each lane contributes so that lanes with more than one
+    // process are not counted multiple times.  The nominal responses
+    // are contributed by lane 0.
+    const bool contributes = (laneComm_->getRank() == 0);
+    const std::size_t matrixSize = static_cast<std::size_t>(numberOfRows_) * numberOfColumns_;
+    // The last two entries count the processes with a failed solve
+    // and with responses whose size changed between solves.
+    std::vector<double> localBuffer(matrixSize + numberOfRows_ + numberOfColumns_ + 2, 0.0);
+    double& sizeErrors = localBuffer[localBuffer.size() - 1];
+    if (contributes) {
+      for (std::map<int,std::vector<double> >::const_iterator c = localColumns.begin(); c != localColumns.end(); ++c) {
+	if (static_cast<int>(c->second.size()) != numberOfRows_) {
+	  sizeErrors = 1.0;
+	  continue;
+	}
+	std::copy(c->second.begin(),c->second.end(),localBuffer.begin() + static_cast<std::size_t>(c->first) * numberOfRows_);
+	localBuffer[matrixSize + numberOfRows_ + c->first] = perturbationSizes[c->first];
+      }
+      if ( (laneIndex_ == 0) && computedNominal ) {
+	if (static_cast<int>(localNominal.size()) != numberOfRows_)
+	  sizeErrors = 1.0;
+	else
+	  std::copy(localNominal.begin(),localNominal.end(),localBuffer.begin() + matrixSize);
+      }
+    }
+    localBuffer[localBuffer.size() - 2] = converged ? 0.0 : 1.0;
+
+    std::vector<double> globalBuffer(localBuffer.size());
+    Teuchos::reduceAll(*globalComm_,Teuchos::REDUCE_SUM,static_cast<int>(localBuffer.size()),&localBuffer[0],&globalBuffer[0]);
+
+    TEUCHOS_TEST_FOR_EXCEPTION(globalBuffer.back() != 0.0, std::logic_error,
+			       "Error: pike::FiniteDifferenceSensitivity::computeSensitivities() - the size of the responses of the model \""
+			       << model_->name() << "\" changed between solves!");
+
+    sensitivities_.assign(globalBuffer.begin(),globalBuffer.begin() + matrixSize);
+    nominalResponses_.assign(globalBuffer.begin() + matrixSize,globalBuffer.begin() + matrixSize + numberOfRows_);
+    allSolvesConverged_ = (globalBuffer[globalBuffer.size() - 2] == 0.0);
+
+    if (!centralDifference_) {
+      for (int k = 0; k < numberOfColumns_; ++k) {
+	const double h = globalBuffer[matrixSize + numberOfRows_ + k];
+	for (int r = 0; r < numberOfRows_; ++r) {
+	  double& entry = sensitivities_[static_cast<std::size_t>(k) * numberOfRows_ + r];
+	  entry = (entry - nominalResponses_[r]) / h;
+	}
+      }
+    }
+  }
+
+  int FiniteDifferenceSensitivity::getNumberOfRows() const
+  { return numberOfRows_; }
+
+  int FiniteDifferenceSensitivity::getNumberOfColumns() const
+  { return numberOfColumns_; }
+
+  Teuchos::ArrayView<const double> FiniteDifferenceSensitivity::getSensitivityColumn(const int k) const
+  {
+    TEUCHOS_ASSERT( (k >= 0) && (k < numberOfColumns_) );
+    return Teuchos::ArrayView<const double>(&sensitivities_[static_cast<std::size_t>(k) * numberOfRows_],numberOfRows_);
+  }
+
+  double FiniteDifferenceSensitivity::getSensitivity(const int j, const int jEntry, const int l, const int lEntry) const
+  {
+    TEUCHOS_ASSERT( (j >= 0) && (j < static_cast<int>(rowOffsets_.size())) );
+    TEUCHOS_ASSERT( (l >= 0) && (l < static_cast<int>(columnOffsets_.size())) );
+    const int row = rowOffsets_[j] + jEntry;
+    const int column = columnOffsets_[l] + lEntry;
+    TEUCHOS_ASSERT( (row >= 0) && (row < numberOfRows_) );
+    TEUCHOS_ASSERT( (column >= 0) && (column < numberOfColumns_) );
+    return sensitivities_[static_cast<std::size_t>(column) * numberOfRows_ + row];
+  }
+
+  Teuchos::ArrayView<const double> FiniteDifferenceSensitivity::getNominalResponse(const int j) const
+  {
+    TEUCHOS_ASSERT( (j >= 0) && (j < static_cast<int>(rowOffsets_.size())) );
+    const int end = (j+1 < static_cast<int>(rowOffsets_.size())) ? rowOffsets_[j+1] : numberOfRows_;
+    return Teuchos::ArrayView<const double>(&nominalResponses_[0] + rowOffsets_[j],end - rowOffsets_[j]);
+  }
+
+  bool FiniteDifferenceSensitivity::allSolvesConverged() const
+  { return allSolvesConverged_; }
+
+  void FiniteDifferenceSensitivity::setParameterList(const Teuchos::RCP<Teuchos::ParameterList>& paramList)
+  {
+    paramList->validateParametersAndSetDefaults(*(this->getValidParameters()));
+    this->setMyParamList(paramList);
+
+    relativePerturbation_ = paramList->get<double>("Relative Perturbation");
+    absolutePerturbation_ = paramList->get<double>("Absolute Perturbation");
+    warmStart_ = paramList->get<bool>("Warm Start From Nominal");
+
+    const std::string type = paramList->get<std::string>("Difference Type");
+    TEUCHOS_TEST_FOR_EXCEPTION( (type != "Forward") && (type != "Central"), std::logic_error,
+				"Error: pike::FiniteDifferenceSensitivity - the \"Difference Type\" \"" << type
+				<< "\" is not valid.  Choose \"Forward\" or \"Central\".");
+    centralDifference_ = (type == "Central");
+
+    TEUCHOS_TEST_FOR_EXCEPTION( (relativePerturbation_ < 0.0) || (absolutePerturbation_ < 0.0) ||
+				(relativePerturbation_ + absolutePerturbation_ == 0.0), std::logic_error,
+				"Error: pike::FiniteDifferenceSensitivity - the perturbations must be non-negative and not both zero!");
+  }
+
+  Teuchos::RCP<const Teuchos::ParameterList> FiniteDifferenceSensitivity::getValidParameters() const
+  {
+    return validParameters_;
+  }
+
+}
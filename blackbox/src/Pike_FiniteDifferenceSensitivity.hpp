@@ -0,0 +1,149 @@
+#ifndef PIKE_FINITE_DIFFERENCE_SENSITIVITY_HPP
+#define PIKE_FINITE_DIFFERENCE_SENSITIVITY_HPP
+
+#include "Pike_BlackBox_config.hpp"
+#include "Teuchos_RCP.hpp"
+#include "Teuchos_ArrayView.hpp"
+#include "Teuchos_ParameterListAcceptorDefaultBase.hpp"
+#include <vector>
+#include <string>
+
+namespace Teuchos { template<typename> class Comm; }
+
+namespace pike {
+
+  class BlackBoxModelEvaluator;
+
+  /** \brief Computes the dense sensitivity matrix dg/dp of the
+      responses of a BlackBoxModelEvaluator with respect to its
+      parameters using finite differences.
+
+      The perturbed solves are run concurrently on "lanes".  The
+      global communicator is split into the requested number of
+      contiguous lanes and the user builds one replica of the model
+      (typically a SolverAdapterModelEvaluator wrapping the complete
+      coupled system) on each lane communicator.  The columns of dg/dp
+      are then distributed round-robin over the lanes.  With as many
+      lanes as parameter entries, the sensitivities cost two
+      wall-clock solves (or a single one if "Warm Start From Nominal"
+      is disabled) instead of Np+1.
+
+      Usage:
+      \code
+      pike::FiniteDifferenceSensitivity fd(globalComm,numberOfLanes);
+      fd.setParameterList(p);
+      Teuchos::RCP<pike::BlackBoxModelEvaluator> model = buildMyCoupledSystem(fd.getLaneComm());
+      fd.setModel(model);
+      fd.computeSensitivities(nominalParameters);
+      Teuchos::ArrayView<const double> dgdp_k = fd.getSensitivityColumn(k);
+      \endcode
+
+      If "Warm Start From Nominal" is true (default), every lane
+      first solves the nominal point so that its perturbed solves
+      start from the nominal converged state held by the model.
+      Subsequent perturbed solves on the same lane start from the
+      previous perturbed state, which is within one perturbation of
+      the nominal state.  If false, the nominal solve is distributed
+      as one more task and every lane starts from whatever state its
+      model currently holds.
+
+      On return, the parameters of every lane's model are reset to the
+      nominal values, but the model state corresponds to the last
+      solve performed on that lane.
+
+      The rows of the sensitivity matrix are the concatenated entries
+      of all responses (in response index order) and the columns are
+      the concatenated entries of all parameters (in parameter index
+      order).
+
+      The responses must be replicated: getResponse() must return the
+      complete response on every process of a lane.  Only the values
+      of the first process of each lane are used.
+
+      Errors in the arguments or in the response sizes are reduced
+      over the global comm, so they are thrown on all processes
+      instead of leaving the other processes waiting in a collective.
+   */
+  class FiniteDifferenceSensitivity : public Teuchos::ParameterListAcceptorDefaultBase {
+
+  public:
+
+    /** \brief Splits the global comm into lanes.  Collective on globalComm.
+
+	\param[in] globalComm Communicator containing all lanes.
+	\param[in] numberOfLanes Number of concurrent perturbed solves.  Must be between 1 and the size of globalComm.
+    */
+    FiniteDifferenceSensitivity(const Teuchos::RCP<const Teuchos::Comm<int> >& globalComm,
+				const int numberOfLanes);
+
+    //! Returns the communicator of the lane that this process belongs to.
+    Teuchos::RCP<const Teuchos::Comm<int> > getLaneComm() const;
+
+    //! Returns the index of the lane that this process belongs to.
+    int getLaneIndex() const;
+
+    int getNumberOfLanes() const;
+
+    //! Sets the replica of the model owned by this process's lane.
+    void setModel(const Teuchos::RCP<pike::BlackBoxModelEvaluator>& model);
+
+    /** \brief Computes dg/dp at the nominal parameter values.  Collective on the global comm.
+
+	\param[in] nominalParameters Values for each parameter index of the model.
+    */
+    void computeSensitivities(const std::vector<std::vector<double> >& nominalParameters);
+
+    //! Number of rows of dg/dp (total number of response entries).
+    int getNumberOfRows() const;
+
+    //! Number of columns of dg/dp (total number of parameter entries).
+    int getNumberOfColumns() const;
+
+    //! Returns column k of dg/dp.
+    Teuchos::ArrayView<const double> getSensitivityColumn(const int k) const;
+
+    //! Returns d(g_j[jEntry])/d(p_l[lEntry]).
+    double getSensitivity(const int j, const int jEntry, const int l, const int lEntry) const;
+
+    //! Returns the response j at the nominal parameter values.
+    Teuchos::ArrayView<const double> getNominalResponse(const int j) const;
+
+    //! Returns true if all nominal and perturbed solves on all lanes were locally converged.
+    bool allSolvesConverged() const;
+
+    void setParameterList(const Teuchos::RCP<Teuchos::ParameterList>& paramList);
+
+    Teuchos::RCP<const Teuchos::ParameterList> getValidParameters() const;
+
+  private:
+
+    //! Solves the model and returns the concatenated responses.
+    void solveAndGatherResponses(std::vector<double>& g, int& converged);
+
+    Teuchos::RCP<const Teuchos::Comm<int> > globalComm_;
+    Teuchos::RCP<const Teuchos::Comm<int> > laneComm_;
+    int numberOfLanes_;
+    int laneIndex_;
+    Teuchos::RCP<pike::BlackBoxModelEvaluator> model_;
+    Teuchos::RCP<Teuchos::ParameterList> validParameters_;
+
+    double relativePerturbation_;
+    double absolutePerturbation_;
+    bool centralDifference_;
+    bool warmStart_;
+
+    //! Offset of the first row of each response.
+    std::vector<int> rowOffsets_;
+    //! Offset of the first column of each parameter.
+    std::vector<int> columnOffsets_;
+    int numberOfRows_;
+    int numberOfColumns_;
+    //! Column-major dense dg/dp.
+    std::vector<double> sensitivities_;
+    std::vector<double> nominalResponses_;
+    bool allSolvesConverged_;
+  };
+
+}
+
+#endif
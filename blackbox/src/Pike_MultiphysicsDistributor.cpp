@@ -8,6 +8,11 @@
 
 #include "Pike_BlackBox_config.hpp"  // for debug define
 #include "Pike_MultiphysicsDistributor.hpp"
+#include "Pike_SharedMemoryBuffer.hpp"
+#include "Pike_NeighborExchange.hpp"
+#include "Pike_RmaTransferWindow.hpp"
+#include "Teuchos_CommHelpers.hpp"
+#include <cmath>
 
 namespace pike {
   int translateMpiRank(const int& rankA, 
@@ -36,9 +41,62 @@ namespace pike {
     return rankB;
   }
 
+  std::vector<int> apportionProcesses(const std::vector<double>& work,
+				      const int numProcesses)
+  {
+    const int numApps = static_cast<int>(work.size());
+    TEUCHOS_TEST_FOR_EXCEPTION(numProcesses < numApps, std::logic_error,
+			       "Error: pike::apportionProcesses() - can not split " << numProcesses
+			       << " processes between " << numApps << " applications!");
+
+    double totalWork = 0.0;
+    for (std::vector<double>::const_iterator w = work.begin(); w != work.end(); ++w)
+      totalWork += std::max(*w,0.0);
+
+    // Ideal shares, rounded down
+    std::vector<double> ideal(numApps);
+    std::vector<int> counts(numApps);
+    int assigned = 0;
+    for (int a = 0; a < numApps; ++a) {
+      ideal[a] = (totalWork > 0.0) ? 
+	static_cast<double>(numProcesses) * std::max(work[a],0.0) / totalWork :
+	static_cast<double>(numProcesses) / static_cast<double>(numApps);
+      counts[a] = static_cast<int>(std::floor(ideal[a]));
+      assigned += counts[a];
+    }
+
+    // Largest remainders get the leftover processes
+    while (assigned < numProcesses) {
+      int best = 0;
+      for (int a = 1; a < numApps; ++a)
+	if ( (ideal[a] - counts[a]) > (ideal[best] - counts[best]) )
+	  best = a;
+      ++counts[best];
+      ++assigned;
+    }
+
+    // Every application needs a process.  Take them from the largest.
+    for (int a = 0; a < numApps; ++a) {
+      if (counts[a] == 0) {
+	const int largest = static_cast<int>(std::max_element(counts.begin(),counts.end()) - counts.begin());
+	--counts[largest];
+	counts[a] = 1;
+      }
+    }
+
+    return counts;
+  }
+
   MultiphysicsDistributor::MultiphysicsDistributor(const std::string& distributorName) :
     myName_(distributorName),
-    setupCalled_(false)
+    setupCalled_(false),
+    automaticPlacement_(false),
+    processesPerNode_(-1),
+    numberOfNodes_(0),
+    estimatedInterNodeVolume_(0.0),
+    loadBalanceWindow_(10),
+    measuredIterationTime_(0.0),
+    predictedIterationTime_(0.0)
   { }
 
   MultiphysicsDistributor::ApplicationIndex
@@ -49,6 +107,9 @@ namespace pike {
 				std::logic_error,
 				"Duplicate Name Error: The application name \"" << name 
 				<< "\" has already been used! Each application must have a unique name.");
+    TEUCHOS_TEST_FOR_EXCEPTION(automaticPlacement_, std::logic_error,
+			       "Error: pike::MultiphysicsDistributor - the application \"" << name
+			       << "\" is registered with explicit ranks, but other applications were registered with addApplicationByCount()!  Explicit and automatic placement can not be mixed.");
 
     const ApplicationIndex index = applications_.size(); 
     applicationNameToIndex_[name] = index;
@@ -78,6 +139,9 @@ namespace pike {
 				std::logic_error,
 				"Duplicate Name Error: The application name \"" << name 
 				<< "\" has already been used! Each application must have a unique name.");
+    TEUCHOS_TEST_FOR_EXCEPTION(automaticPlacement_, std::logic_error,
+			       "Error: pike::MultiphysicsDistributor - the application \"" << name
+			       << "\" is registered with explicit ranks, but other applications were registered with addApplicationByCount()!  Explicit and automatic placement can not be mixed.");
 
     const ApplicationIndex index = applications_.size(); 
     applicationNameToIndex_[name] = index;
@@ -92,10 +156,39 @@ namespace pike {
     return index;
   }
 
+  MultiphysicsDistributor::ApplicationIndex
+  MultiphysicsDistributor::addApplicationByCount(const std::string& name,
+						 const int numProcesses)
+  {
+    TEUCHOS_TEST_FOR_EXCEPTION( (applicationNameToIndex_.find(name) != applicationNameToIndex_.end()),
+				std::logic_error,
+				"Duplicate Name Error: The application name \"" << name 
+				<< "\" has already been used! Each application must have a unique name.");
+    TEUCHOS_TEST_FOR_EXCEPTION( (!automaticPlacement_ && (applications_.size() > 0)), std::logic_error,
+			       "Error: pike::MultiphysicsDistributor - the application \"" << name
+			       << "\" is registered by count, but other applications were registered with explicit ranks!  Explicit and automatic placement can not be mixed.");
+    TEUCHOS_TEST_FOR_EXCEPTION(numProcesses < 1, std::logic_error,
+			       "Error: pike::MultiphysicsDistributor - the application \"" << name
+			       << "\" must run on at least one process!");
+
+    automaticPlacement_ = true;
+
+    const ApplicationIndex index = applications_.size(); 
+    applicationNameToIndex_[name] = index;
+
+    // Ranks are assigned in setup()
+    ApplicationData app;
+    app.name = name;
+    app.numProcesses = numProcesses;
+    applications_.push_back(app);
+    return index;
+  }
+
   MultiphysicsDistributor::TransferIndex
   MultiphysicsDistributor::addTransfer(const std::string& name,
 				       const ApplicationIndex a,
-				       const ApplicationIndex b)
+				       const ApplicationIndex b,
+				       const double volume)
   {
     TEUCHOS_TEST_FOR_EXCEPTION( (transferNameToIndex_.find(name) != transferNameToIndex_.end()),
 				std::logic_error,
@@ -109,6 +202,7 @@ namespace pike {
     transfers_.push_back(apps);
     transferNames_.push_back(name);
     transferNameToIndex_[name] = index;
+    transferVolumes_.push_back(volume);
     std::vector<int> dummy;
     transferRanks_.push_back(dummy); // Actual ranks determined during setup
     return index;
@@ -116,7 +210,8 @@ namespace pike {
 
   MultiphysicsDistributor::TransferIndex
   MultiphysicsDistributor::addTransfer(const std::string& name,
-				       const std::vector<ApplicationIndex>& appIndices)
+				       const std::vector<ApplicationIndex>& appIndices,
+				       const double volume)
   {
     TEUCHOS_TEST_FOR_EXCEPTION( (transferNameToIndex_.find(name) != transferNameToIndex_.end()),
 				std::logic_error,
@@ -127,13 +222,14 @@ namespace pike {
     transfers_.push_back(appIndices);
     transferNames_.push_back(name);
     transferNameToIndex_[name] = index;
+    transferVolumes_.push_back(volume);
     std::vector<int> dummy;
     transferRanks_.push_back(dummy); // Actual ranks determined during setup
     return index;
   }
   
   MultiphysicsDistributor::TransferIndex 
-  MultiphysicsDistributor::addTransferByRanks(const std::string& name, const std::vector<int>& mpiRanks)
+  MultiphysicsDistributor::addTransferByRanks(const std::string& name, const std::vector<int>& mpiRanks, const double volume)
   {
     TEUCHOS_TEST_FOR_EXCEPTION( (transferNameToIndex_.find(name) != transferNameToIndex_.end()),
 				std::logic_error,
@@ -146,6 +242,7 @@ namespace pike {
     transfers_.push_back(dummy);  // don't need application indices - ranks explicitly set
     transferNames_.push_back(name);
     transferNameToIndex_[name] = index;
+    transferVolumes_.push_back(volume);
     transferRanks_.push_back(mpiRanks);
     return index;
   }
@@ -164,11 +261,18 @@ namespace pike {
     TEUCHOS_TEST_FOR_EXCEPTION((applications_.size() < 1),
 			       std::logic_error,
 			       "Error: No apps were registered with the distributor!");
+
+    this->discoverNodes();
+
+    if (automaticPlacement_)
+      this->placeApplications();
     
     this->buildComms();
 
     this->buildOStreams();
 
+    this->estimateInterNodeVolume();
+
     //*************************************
     // Print the comm details
     //*************************************
@@ -194,20 +298,245 @@ namespace pike {
 	}
 	*pout_ << std::endl;
       }
+
+      for (std::size_t app = 0; app < applications_.size(); ++app) {
+	std::set<int> nodes;
+	for (std::vector<int>::const_iterator r=applications_[app].processes.begin(); r != applications_[app].processes.end(); ++r)
+	  nodes.insert(nodeOfRank_[*r]);
+	*out_ << "Application Nodes(" << applications_[app].name << ") = ";
+	for (std::set<int>::const_iterator n=nodes.begin(); n != nodes.end(); ++n) {
+	  if (n != nodes.begin())
+	    *out_ << ",";
+	  *out_ << *n;
+	}
+	*out_ << std::endl;
+      }
+      *out_ << "Number of Nodes = " << numberOfNodes_ << std::endl;
+      *out_ << "Estimated Inter-Node Transfer Volume = " << estimatedInterNodeVolume_ << std::endl;
       
     }
 
     setupCalled_ = true;
   }
 
+  void
+  MultiphysicsDistributor::discoverNodes()
+  {
+    const Teuchos::MpiComm<int>* mpiGlobalComm = dynamic_cast<const Teuchos::MpiComm<int>* >(globalComm_.get());
+    TEUCHOS_ASSERT(mpiGlobalComm != 0);
+    MPI_Comm rawGlobalComm = (*mpiGlobalComm->getRawMpiComm())();
+
+    if (processesPerNode_ > 0) {
+      // User defined layout: consecutive blocks of ranks
+      nodeOfRank_.resize(globalComm_->getSize());
+      for (int r = 0; r < globalComm_->getSize(); ++r)
+	nodeOfRank_[r] = r / processesPerNode_;
+      numberOfNodes_ = (globalComm_->getSize() + processesPerNode_ - 1) / processesPerNode_;
+      return;
+    }
+
+    // Identify each node by the lowest global rank on it
+    MPI_Comm nodeComm;
+    MPI_Comm_split_type(rawGlobalComm,MPI_COMM_TYPE_SHARED,globalComm_->getRank(),MPI_INFO_NULL,&nodeComm);
+    int nodeLeader = globalComm_->getRank();
+    MPI_Bcast(&nodeLeader,1,MPI_INT,0,nodeComm);
+    MPI_Comm_free(&nodeComm);
+
+    std::vector<int> leaders(globalComm_->getSize());
+    MPI_Allgather(&nodeLeader,1,MPI_INT,&leaders[0],1,MPI_INT,rawGlobalComm);
+
+    // Number the nodes in order of their leaders
+    std::map<int,int> leaderToNode;
+    for (std::vector<int>::const_iterator l = leaders.begin(); l != leaders.end(); ++l)
+      leaderToNode.insert(std::make_pair(*l,0));
+    int node = 0;
+    for (std::map<int,int>::iterator l = leaderToNode.begin(); l != leaderToNode.end(); ++l, ++node)
+      l->second = node;
+    numberOfNodes_ = node;
+
+    nodeOfRank_.resize(leaders.size());
+    for (std::size_t r = 0; r < leaders.size(); ++r)
+      nodeOfRank_[r] = leaderToNode[leaders[r]];
+  }
+
+  void
+  MultiphysicsDistributor::placeApplications()
+  {
+    const std::size_t numApps = applications_.size();
+
+    int requiredProcesses = 0;
+    for (std::size_t a = 0; a < numApps; ++a)
+      requiredProcesses += applications_[a].numProcesses;
+    TEUCHOS_TEST_FOR_EXCEPTION(requiredProcesses > globalComm_->getSize(), std::logic_error,
+			       "Error: pike::MultiphysicsDistributor - the applications require " << requiredProcesses
+			       << " processes but the global comm only has " << globalComm_->getSize() << "!");
+
+    // Coupling weight between each pair of applications.  A transfer
+    // between more than two applications adds its volume to every
+    // pair.
+    std::vector<std::vector<double> > weight(numApps,std::vector<double>(numApps,0.0));
+    std::vector<double> totalWeight(numApps,0.0);
+    for (std::size_t t = 0; t < transfers_.size(); ++t) {
+      const std::vector<ApplicationIndex>& apps = transfers_[t];
+      for (std::size_t i = 0; i < apps.size(); ++i) {
+	for (std::size_t j = 0; j < apps.size(); ++j) {
+	  if (apps[i] != apps[j]) {
+	    weight[apps[i]][apps[j]] += transferVolumes_[t];
+	    totalWeight[apps[i]] += transferVolumes_[t];
+	  }
+	}
+      }
+    }
+
+    // Greedy ordering: start with the most coupled application, then
+    // repeatedly append the application most strongly coupled to the
+    // ones already ordered.  Strongly coupled applications end up
+    // next to each other and are packed onto the same node below.
+    std::vector<ApplicationIndex> order;
+    std::vector<bool> ordered(numApps,false);
+    std::vector<double> connection(numApps,0.0);
+    while (order.size() < numApps) {
+      ApplicationIndex next = numApps;
+      for (std::size_t a = 0; a < numApps; ++a) {
+	if (ordered[a])
+	  continue;
+	if ( (next == numApps) ||
+	     (connection[a] > connection[next]) ||
+	     ((connection[a] == connection[next]) && (totalWeight[a] > totalWeight[next])) )
+	  next = a;
+      }
+      ordered[next] = true;
+      order.push_back(next);
+      for (std::size_t a = 0; a < numApps; ++a)
+	connection[a] += weight[next][a];
+    }
+
+    // Free ranks of each node
+    std::vector<std::vector<int> > freeRanks(numberOfNodes_);
+    for (int r = 0; r < globalComm_->getSize(); ++r)
+      freeRanks[nodeOfRank_[r]].push_back(r);
+
+    // Place the applications in order.  An application that fits on
+    // a node is never split across nodes: it goes on the node of the
+    // previously placed application if there is room (to keep
+    // coupled applications together), otherwise on the node with the
+    // least room that still holds it.  Only an application that fits
+    // on no node spans several, taking the emptiest nodes first.
+    int previousNode = -1;
+    for (std::vector<ApplicationIndex>::const_iterator a = order.begin(); a != order.end(); ++a) {
+      ApplicationData& app = applications_[*a];
+      const std::size_t numProcesses = static_cast<std::size_t>(app.numProcesses);
+
+      int node = -1;
+      if ( (previousNode >= 0) && (freeRanks[previousNode].size() >= numProcesses) )
+	node = previousNode;
+      else {
+	for (int n = 0; n < numberOfNodes_; ++n)
+	  if ( (freeRanks[n].size() >= numProcesses) &&
+	       ((node < 0) || (freeRanks[n].size() < freeRanks[node].size())) )
+	    node = n;
+      }
+
+      std::vector<int> nodes;
+      if (node >= 0)
+	nodes.push_back(node);
+      else {
+	std::vector<std::pair<std::size_t,int> > freeAndNode;
+	for (int n = 0; n < numberOfNodes_; ++n)
+	  if (freeRanks[n].size() > 0)
+	    freeAndNode.push_back(std::make_pair(freeRanks[n].size(),-n));
+	std::sort(freeAndNode.rbegin(),freeAndNode.rend());
+	for (std::size_t i = 0; i < freeAndNode.size(); ++i)
+	  nodes.push_back(-freeAndNode[i].second);
+      }
+
+      app.processes.clear();
+      for (std::vector<int>::const_iterator n = nodes.begin(); n != nodes.end(); ++n) {
+	std::vector<int>& ranks = freeRanks[*n];
+	const std::size_t take = std::min(ranks.size(),numProcesses - app.processes.size());
+	app.processes.insert(app.processes.end(),ranks.begin(),ranks.begin() + take);
+	ranks.erase(ranks.begin(),ranks.begin() + take);
+	previousNode = *n;
+	if (app.processes.size() == numProcesses)
+	  break;
+      }
+      std::sort(app.processes.begin(),app.processes.end());
+      app.startProcess = app.processes[0];
+    }
+  }
+
+  double
+  MultiphysicsDistributor::interNodeFraction(const std::vector<int>& ranksA,
+					     const std::vector<int>& ranksB) const
+  {
+    if (ranksA.empty() || ranksB.empty())
+      return 0.0;
+
+    const int numRanks = static_cast<int>(nodeOfRank_.size());
+    std::vector<double> countA(numberOfNodes_,0.0);
+    for (std::vector<int>::const_iterator r = ranksA.begin(); r != ranksA.end(); ++r) {
+      TEUCHOS_TEST_FOR_EXCEPTION( (*r < 0) || (*r >= numRanks), std::logic_error,
+				  "Error: pike::MultiphysicsDistributor - the rank " << *r
+				  << " is not in the global comm of size " << numRanks << "!");
+      countA[nodeOfRank_[*r]] += 1.0;
+    }
+    std::vector<double> countB(numberOfNodes_,0.0);
+    for (std::vector<int>::const_iterator r = ranksB.begin(); r != ranksB.end(); ++r) {
+      TEUCHOS_TEST_FOR_EXCEPTION( (*r < 0) || (*r >= numRanks), std::logic_error,
+				  "Error: pike::MultiphysicsDistributor - the rank " << *r
+				  << " is not in the global comm of size " << numRanks << "!");
+      countB[nodeOfRank_[*r]] += 1.0;
+    }
+
+    double intraNode = 0.0;
+    for (int n = 0; n < numberOfNodes_; ++n)
+      intraNode += countA[n] * countB[n];
+
+    return 1.0 - intraNode / (static_cast<double>(ranksA.size()) * static_cast<double>(ranksB.size()));
+  }
+
+  void
+  MultiphysicsDistributor::estimateInterNodeVolume()
+  {
+    estimatedInterNodeVolume_ = 0.0;
+    for (std::size_t t = 0; t < transfers_.size(); ++t) {
+      const std::vector<ApplicationIndex>& apps = transfers_[t];
+      if (apps.size() < 2) {
+	// Registered by ranks
+	estimatedInterNodeVolume_ += transferVolumes_[t] * this->interNodeFraction(transferRanks_[t],transferRanks_[t]);
+	continue;
+      }
+      const double numPairs = 0.5 * static_cast<double>(apps.size() * (apps.size() - 1));
+      for (std::size_t i = 0; i < apps.size(); ++i)
+	for (std::size_t j = i+1; j < apps.size(); ++j)
+	  estimatedInterNodeVolume_ += transferVolumes_[t] / numPairs *
+	    this->interNodeFraction(applications_[apps[i]].processes,applications_[apps[j]].processes);
+    }
+  }
+
   void
   MultiphysicsDistributor::buildComms()
   {    
+    // All comms are built with MPI_Comm_create_group, which is only
+    // collective over the processes of the new comm.  Building a comm
+    // does not involve processes outside of the application or
+    // transfer, so setup time does not grow with the size of the
+    // global comm times the number of apps and transfers.
+    const Teuchos::MpiComm<int>* mpiGlobalComm = dynamic_cast<const Teuchos::MpiComm<int>* >(globalComm_.get());
+    TEUCHOS_ASSERT(mpiGlobalComm != 0);
+    MPI_Comm rawGlobalComm = (*mpiGlobalComm->getRawMpiComm())();
+    MPI_Group globalGroup;
+    MPI_Comm_group(rawGlobalComm,&globalGroup);
+
+    // Each comm gets its own tag so that concurrent creations on
+    // overlapping groups can not be confused.
+    int tag = 0;
+
     // Application comms
     applicationComms_.resize(applications_.size());
-    for (std::size_t app = 0; app != applications_.size(); ++app) {
+    for (std::size_t app = 0; app != applications_.size(); ++app, ++tag) {
       applicationComms_[app] = 
-	globalComm_->createSubcommunicator(Teuchos::arrayViewFromVector(applications_[app].processes));
+	this->createSubcommunicator(rawGlobalComm,globalGroup,applications_[app].processes,tag);
     }
 
     // Build transfer comms
@@ -223,9 +552,34 @@ namespace pike {
     }
 
     transferComms_.resize(transfers_.size());
-    for (std::size_t t = 0; t < transferRanks_.size(); ++t)
-      transferComms_[t] = globalComm_->createSubcommunicator(Teuchos::arrayViewFromVector(transferRanks_[t]));
+    for (std::size_t t = 0; t < transferRanks_.size(); ++t, ++tag)
+      transferComms_[t] = this->createSubcommunicator(rawGlobalComm,globalGroup,transferRanks_[t],tag);
+
+    MPI_Group_free(&globalGroup);
+
+    // Node local transfer comms are only built on request, see
+    // buildTransferNodeComm()
+    transferNodeComms_.assign(transfers_.size(),Teuchos::null);
+  }
 
+  Teuchos::RCP<const Teuchos::Comm<int> >
+  MultiphysicsDistributor::createSubcommunicator(MPI_Comm rawGlobalComm,
+						 MPI_Group globalGroup,
+						 const std::vector<int>& sortedRanks,
+						 const int tag) const
+  {
+    // Processes outside of the group don't participate
+    if (!std::binary_search(sortedRanks.begin(),sortedRanks.end(),globalComm_->getRank()))
+      return Teuchos::null;
+
+    MPI_Group group;
+    MPI_Group_incl(globalGroup,static_cast<int>(sortedRanks.size()),sortedRanks.data(),&group);
+    MPI_Comm rawSubComm;
+    // MPI only guarantees tags up to 32767
+    MPI_Comm_create_group(rawGlobalComm,group,tag % 32768,&rawSubComm);
+    MPI_Group_free(&group);
+
+    return Teuchos::rcp(new Teuchos::MpiComm<int>(Teuchos::opaqueWrapper(rawSubComm,MPI_Comm_free)));
   }
 
   void
@@ -280,6 +634,21 @@ namespace pike {
     return worldRank;
   }
 
+  std::size_t MultiphysicsDistributor::getNumberOfApplications() const
+  { return applications_.size(); }
+
+  std::size_t MultiphysicsDistributor::getNumberOfTransfers() const
+  { return transfers_.size(); }
+
+  const std::vector<MultiphysicsDistributor::ApplicationIndex>&
+  MultiphysicsDistributor::getTransferApplications(const TransferIndex index) const
+  {
+#ifdef HAVE_PIKE_DEBUG
+    TEUCHOS_ASSERT( (index >= 0) && (index < transfers_.size()) );
+#endif
+    return transfers_[index];
+  }
+
   std::string MultiphysicsDistributor::getApplicationName(const ApplicationIndex appIndex) const
   {
 #ifdef HAVE_PIKE_DEBUG
@@ -356,6 +725,232 @@ namespace pike {
     return transferComms_[index];
   }
 
+  Teuchos::RCP<const Teuchos::Comm<int> >
+  MultiphysicsDistributor::getTransferNodeComm(const TransferIndex index) const
+  {
+#ifdef HAVE_PIKE_DEBUG
+    TEUCHOS_ASSERT( (index >= 0) && (index < transfers_.size()) );
+#endif
+    return this->buildTransferNodeComm(index);
+  }
+
+  bool MultiphysicsDistributor::transferIsNodeLocal(const TransferIndex index) const
+  {
+#ifdef HAVE_PIKE_DEBUG
+    TEUCHOS_ASSERT( (index >= 0) && (index < transfers_.size()) );
+#endif
+    if (is_null(transferComms_[index]))
+      return false;
+    return (this->buildTransferNodeComm(index)->getSize() == transferComms_[index]->getSize());
+  }
+
+  Teuchos::RCP<pike::SharedMemoryBuffer>
+  MultiphysicsDistributor::createTransferSharedMemoryBuffer(const TransferIndex index,
+							    const std::size_t localSize) const
+  {
+    TEUCHOS_TEST_FOR_EXCEPTION(!this->transferExistsOnProcess(index), std::logic_error,
+			       "Error: pike::MultiphysicsDistributor::createTransferSharedMemoryBuffer() - the transfer \""
+			       << transferNames_[index] << "\" is not active on this process!");
+    return pike::sharedMemoryBuffer(this->buildTransferNodeComm(index),localSize);
+  }
+
+  const Teuchos::RCP<const Teuchos::Comm<int> >&
+  MultiphysicsDistributor::buildTransferNodeComm(const TransferIndex index) const
+  {
+    if (is_null(transferNodeComms_[index]) && nonnull(transferComms_[index])) {
+      const Teuchos::MpiComm<int>* mpiTransferComm = dynamic_cast<const Teuchos::MpiComm<int>* >(transferComms_[index].get());
+      TEUCHOS_ASSERT(mpiTransferComm != 0);
+      MPI_Comm rawNodeComm;
+      MPI_Comm_split_type((*mpiTransferComm->getRawMpiComm())(),
+			  MPI_COMM_TYPE_SHARED,
+			  transferComms_[index]->getRank(),
+			  MPI_INFO_NULL,
+			  &rawNodeComm);
+      transferNodeComms_[index] = 
+	Teuchos::rcp(new Teuchos::MpiComm<int>(Teuchos::opaqueWrapper(rawNodeComm,MPI_Comm_free)));
+    }
+    return transferNodeComms_[index];
+  }
+
+  Teuchos::RCP<pike::NeighborExchange>
+  MultiphysicsDistributor::createTransferNeighborExchange(const TransferIndex index,
+							  const std::vector<int>& sources,
+							  const std::vector<int>& receiveCounts,
+							  const std::vector<int>& destinations,
+							  const std::vector<int>& sendCounts) const
+  {
+    TEUCHOS_TEST_FOR_EXCEPTION(!this->transferExistsOnProcess(index), std::logic_error,
+			       "Error: pike::MultiphysicsDistributor::createTransferNeighborExchange() - the transfer \""
+			       << transferNames_[index] << "\" is not active on this process!");
+    return pike::neighborExchange(transferComms_[index],sources,receiveCounts,destinations,sendCounts);
+  }
+
+  Teuchos::RCP<pike::RmaTransferWindow>
+  MultiphysicsDistributor::createTransferRmaWindow(const TransferIndex index,
+						   const std::size_t localSize) const
+  {
+    TEUCHOS_TEST_FOR_EXCEPTION(!this->transferExistsOnProcess(index), std::logic_error,
+			       "Error: pike::MultiphysicsDistributor::createTransferRmaWindow() - the transfer \""
+			       << transferNames_[index] << "\" is not active on this process!");
+    return pike::rmaTransferWindow(transferComms_[index],localSize);
+  }
+
+  const std::vector<int>& MultiphysicsDistributor::getApplicationRanks(const ApplicationIndex index) const
+  {
+#ifdef HAVE_PIKE_DEBUG
+    TEUCHOS_ASSERT( (index >= 0) && (index < applications_.size()) );    
+#endif
+    return applications_[index].processes;
+  }
+
+  double MultiphysicsDistributor::getTransferVolume(const TransferIndex index) const
+  {
+#ifdef HAVE_PIKE_DEBUG
+    TEUCHOS_ASSERT( (index >= 0) && (index < transfers_.size()) );
+#endif
+    return transferVolumes_[index];
+  }
+
+  void MultiphysicsDistributor::setProcessesPerNode(const int numProcesses)
+  {
+    TEUCHOS_TEST_FOR_EXCEPTION(setupCalled_, std::logic_error,
+			       "Error: pike::MultiphysicsDistributor::setProcessesPerNode() - must be called before setup()!");
+    TEUCHOS_TEST_FOR_EXCEPTION(numProcesses < 1, std::logic_error,
+			       "Error: pike::MultiphysicsDistributor::setProcessesPerNode() - a node must hold at least one process!");
+    processesPerNode_ = numProcesses;
+  }
+
+  int MultiphysicsDistributor::getProcessesPerNode() const
+  { return processesPerNode_; }
+
+  int MultiphysicsDistributor::getNumberOfNodes() const
+  { return numberOfNodes_; }
+
+  int MultiphysicsDistributor::getNodeIndex(const int globalRank) const
+  {
+#ifdef HAVE_PIKE_DEBUG
+    TEUCHOS_ASSERT( (globalRank >= 0) && (globalRank < static_cast<int>(nodeOfRank_.size())) );
+#endif
+    return nodeOfRank_[globalRank];
+  }
+
+  double MultiphysicsDistributor::getEstimatedInterNodeVolume() const
+  { return estimatedInterNodeVolume_; }
+
+  void MultiphysicsDistributor::setLoadBalanceWindow(const int numSamples)
+  {
+    TEUCHOS_TEST_FOR_EXCEPTION(numSamples < 1, std::logic_error,
+			       "Error: pike::MultiphysicsDistributor::setLoadBalanceWindow() - the window must hold at least one sample!");
+    loadBalanceWindow_ = numSamples;
+    for (std::vector<std::deque<double> >::iterator t = solveTimes_.begin(); t != solveTimes_.end(); ++t)
+      while (static_cast<int>(t->size()) > loadBalanceWindow_)
+	t->pop_front();
+  }
+
+  int MultiphysicsDistributor::getLoadBalanceWindow() const
+  { return loadBalanceWindow_; }
+
+  void MultiphysicsDistributor::recordSolveTime(const ApplicationIndex index, const double seconds)
+  {
+    TEUCHOS_ASSERT(index < applications_.size());
+    if (solveTimes_.size() < applications_.size())
+      solveTimes_.resize(applications_.size());
+    solveTimes_[index].push_back(seconds);
+    if (static_cast<int>(solveTimes_[index].size()) > loadBalanceWindow_)
+      solveTimes_[index].pop_front();
+  }
+
+  double MultiphysicsDistributor::getAverageSolveTime(const ApplicationIndex index) const
+  {
+    TEUCHOS_ASSERT(index < applications_.size());
+    if ( (index >= solveTimes_.size()) || solveTimes_[index].empty() )
+      return 0.0;
+    double sum = 0.0;
+    for (std::deque<double>::const_iterator t = solveTimes_[index].begin(); t != solveTimes_[index].end(); ++t)
+      sum += *t;
+    return sum / static_cast<double>(solveTimes_[index].size());
+  }
+
+  std::vector<int> MultiphysicsDistributor::computeRecommendedLayout()
+  {
+    TEUCHOS_TEST_FOR_EXCEPTION(!setupCalled_, std::logic_error,
+			       "Error: pike::MultiphysicsDistributor::computeRecommendedLayout() - setup() must be called first!");
+
+    // The slowest process of an application determines its time
+    const int numApps = static_cast<int>(applications_.size());
+    std::vector<double> localTimes(numApps,0.0);
+    for (int a = 0; a < numApps; ++a)
+      if (this->appExistsOnProcess(a))
+	localTimes[a] = this->getAverageSolveTime(a);
+    std::vector<double> times(numApps,0.0);
+    Teuchos::reduceAll(*globalComm_,Teuchos::REDUCE_MAX,numApps,&localTimes[0],&times[0]);
+
+    // The recommended layout places the applications on disjoint
+    // ranks, so the counts must sum to the number of distinct
+    // processes in use, not to the sum of the application sizes.
+    // Otherwise processes shared by overlapping applications would be
+    // counted twice.
+    std::set<int> usedProcesses;
+    for (int a = 0; a < numApps; ++a)
+      usedProcesses.insert(applications_[a].processes.begin(),applications_[a].processes.end());
+
+    // Unmeasured applications keep their process count.  The rest of
+    // the processes are split between the measured applications in
+    // proportion to their work.
+    recommendedProcessCounts_.resize(numApps);
+    std::vector<int> measured;
+    std::vector<double> work;
+    int measuredProcesses = static_cast<int>(usedProcesses.size());
+    measuredIterationTime_ = 0.0;
+    for (int a = 0; a < numApps; ++a) {
+      const int numProcesses = static_cast<int>(applications_[a].processes.size());
+      recommendedProcessCounts_[a] = numProcesses;
+      measuredIterationTime_ = std::max(times[a],measuredIterationTime_);
+      if (times[a] > 0.0) {
+	measured.push_back(a);
+	work.push_back(times[a] * numProcesses);
+      }
+      else
+	measuredProcesses -= numProcesses;
+    }
+    TEUCHOS_TEST_FOR_EXCEPTION(measuredProcesses < static_cast<int>(measured.size()), std::logic_error,
+			       "Error: pike::MultiphysicsDistributor::computeRecommendedLayout() - the applications without recorded times use "
+			       << static_cast<int>(usedProcesses.size()) - measuredProcesses << " of the " << usedProcesses.size()
+			       << " processes, which leaves too few for the " << measured.size() << " measured applications!");
+
+    predictedIterationTime_ = 0.0;
+    if (measured.size() > 0) {
+      const std::vector<int> counts = pike::apportionProcesses(work,measuredProcesses);
+      for (std::size_t m = 0; m < measured.size(); ++m) {
+	recommendedProcessCounts_[measured[m]] = counts[m];
+	predictedIterationTime_ = std::max(work[m] / counts[m], predictedIterationTime_);
+      }
+    }
+
+    return recommendedProcessCounts_;
+  }
+
+  double MultiphysicsDistributor::getMeasuredIterationTime() const
+  { return measuredIterationTime_; }
+
+  double MultiphysicsDistributor::getPredictedIterationTime() const
+  { return predictedIterationTime_; }
+
+  void MultiphysicsDistributor::printRecommendedLayout(std::ostream& os) const
+  {
+    TEUCHOS_TEST_FOR_EXCEPTION(recommendedProcessCounts_.size() != applications_.size(), std::logic_error,
+			       "Error: pike::MultiphysicsDistributor::printRecommendedLayout() - computeRecommendedLayout() must be called first!");
+    os << "Recommended Layout (measured iteration time = " << measuredIterationTime_
+       << ", predicted iteration time = " << predictedIterationTime_ << "):" << std::endl;
+    int beginRank = 0;
+    for (std::size_t a = 0; a < applications_.size(); ++a) {
+      os << "  " << applications_[a].name << ": " << recommendedProcessCounts_[a]
+	 << " processes, ranks [" << beginRank << "," << beginRank + recommendedProcessCounts_[a] - 1 << "]"
+	 << std::endl;
+      beginRank += recommendedProcessCounts_[a];
+    }
+  }
+
   int MultiphysicsDistributor::getPrintRank(const ApplicationIndex index) const
   {
 #ifdef HAVE_PIKE_DEBUG
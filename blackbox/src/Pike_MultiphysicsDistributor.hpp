@@ -7,12 +7,19 @@
 #include "Teuchos_FancyOStream.hpp"
 #include "Teuchos_VerboseObject.hpp"
 #include "Teuchos_Describable.hpp"
+#include "mpi.h"
 #include <map>
 #include <vector>
+#include <deque>
 #include <string>
+#include <iosfwd>
 
 namespace pike {
 
+  class SharedMemoryBuffer;
+  class NeighborExchange;
+  class RmaTransferWindow;
+
   /** \brief Translates rank on comm A to its corresponding rank on comm B.
       
       @param rankA Rank of a process on Comm A
@@ -26,6 +33,21 @@ namespace pike {
 		       const Teuchos::Comm<int>& commA,
 		       const Teuchos::Comm<int>& commB);
 
+  /** \brief Splits numProcesses between applications in proportion to their work.
+
+      Each application gets at least one process.  Fractional shares
+      are rounded with the largest remainder method, so the counts
+      always sum to numProcesses.
+
+      @param work Work of each application, e.g. solve time multiplied by the number of processes it ran on.
+      @param numProcesses Total number of processes to split.  Must be at least the number of applications.
+      @returns The number of processes for each application.
+
+      \relates pike::MultiphysicsDistributor
+   */
+  std::vector<int> apportionProcesses(const std::vector<double>& work,
+				      const int numProcesses);
+
   /** \brief Multiphysics driver utility that builds MPI
       sub-communicators and specialized ostreams for applications and
       data transfers.
@@ -65,32 +87,51 @@ namespace pike {
      */
     ApplicationIndex addApplication(const std::string& name, const int beginRank, const int endRank);
 
+    /** \brief Register a new application by the number of processes it needs and let the distributor place it.
+
+	Turns on automatic placement: during setup() the distributor
+	discovers the node layout with MPI_Comm_split_type and assigns
+	ranks so that applications coupled by high volume transfers
+	share a node.  Applications are placed on disjoint sets of
+	ranks, and an application that fits on a node is not split
+	across nodes.  Can not be mixed with the addApplication() methods that
+	take explicit ranks.
+
+	\param[in] name Name of the application.
+	\param[in] numProcesses Number of processes the application runs on.
+	\returns Index of the application.
+     */
+    ApplicationIndex addApplicationByCount(const std::string& name, const int numProcesses);
+
     /** \brief Tells this object that an active coupling between two physics exisits and that a union of the two applicaiton subcommunicators should be built for coupled data transfer.
 
        \param[in] a Index of the fist application involved in the transfer.
        \param[in] b Index of the second application involved in the transfer.
        \param[in] name Name of the transfer. Must be unique.
+       \param[in] volume Relative amount of data moved by the transfer.  Used by automatic placement and the inter-node traffic estimate.
        \returns The transfer index.
 
        This is a simplification of the general addTranfer that takes a std::vector as its argument.  Most couplings are between two codes, and this case comes up so often that we have a specialized ctor for it.
      */
-    TransferIndex addTransfer(const std::string& name, const ApplicationIndex a, const ApplicationIndex b);
+    TransferIndex addTransfer(const std::string& name, const ApplicationIndex a, const ApplicationIndex b, const double volume = 1.0);
 
     /** \brief Tells this object that an active coupling between multiple physics exisits and that a union of the applicaiton subcommunicators should be built for coupled data transfer.
  
        \param[in] appIndices Indices of the applications involved in the transfer.
        \param[in] name Name of the transfer.  Must be unique.
+       \param[in] volume Relative amount of data moved by the transfer.  Used by automatic placement and the inter-node traffic estimate.
        \returns The transfer index.
     */
-    TransferIndex addTransfer(const std::string& name, const std::vector<ApplicationIndex>& appIndices);
+    TransferIndex addTransfer(const std::string& name, const std::vector<ApplicationIndex>& appIndices, const double volume = 1.0);
 
     /** \brief Tells this object that an active coupling between multiple physics exisits and that a subcommunicator should be built using the specified ranks.
  
        \param[in] name Name of the transfer.  Must be unique.
        \param[in] mpiRanks MPI Ranks corresponding to the global comm that are involved in the transfer.
+       \param[in] volume Relative amount of data moved by the transfer.  Used by the inter-node traffic estimate.
        \returns The transfer index.
     */
-    TransferIndex addTransferByRanks(const std::string& name, const std::vector<int>& mpiRanks);
+    TransferIndex addTransferByRanks(const std::string& name, const std::vector<int>& mpiRanks, const double volume = 1.0);
 
     /** \brief Builds the application subcommunicators and any coupling subcommunicators. 
   
@@ -100,6 +141,15 @@ namespace pike {
      */
     void setup(const Teuchos::RCP<const Teuchos::Comm<int> >& globalComm, bool printCommDistribution = false);
 
+    //! Returns the number of registered applications.
+    std::size_t getNumberOfApplications() const;
+
+    //! Returns the number of registered transfers.
+    std::size_t getNumberOfTransfers() const;
+
+    //! Returns the applications coupled by the transfer.  Empty for transfers registered with addTransferByRanks().
+    const std::vector<ApplicationIndex>& getTransferApplications(const TransferIndex transferIndex) const;
+
     /** \brief Returns the application name given the application index. */
     std::string getApplicationName(const ApplicationIndex appIndex) const;
 
@@ -127,6 +177,148 @@ namespace pike {
     /** \brief Returns the subcommunicator for the transfer index.  Returns a null RCP if neither of the coupled applications is active on this process.*/ 
     Teuchos::RCP<const Teuchos::Comm<int> > getTransferComm(const TransferIndex transferIndex) const;
 
+    /** \brief Returns the subcommunicator of the transfer comm containing the processes that share memory (are on the same node) with this process.  Returns a null RCP if the transfer is not active on this process.
+
+	The node comm is built on the first request for the transfer
+	(by this method, transferIsNodeLocal() or
+	createTransferSharedMemoryBuffer()), so that first request is
+	collective over the transfer comm.
+    */
+    Teuchos::RCP<const Teuchos::Comm<int> > getTransferNodeComm(const TransferIndex transferIndex) const;
+
+    /** \brief Returns true if all processes of the transfer share memory with this process, i.e. the transfer comm and the transfer node comm are the same size.  Returns false if the transfer is not active on this process.  May build the node comm (see getTransferNodeComm()). */
+    bool transferIsNodeLocal(const TransferIndex transferIndex) const;
+
+    /** \brief Allocates an MPI-3 shared memory buffer over the transfer node comm.
+
+	Collective over the transfer node comm.  Data transfers can
+	use the buffer to exchange data between co-located
+	applications by direct load/store instead of message copies.
+	Throws if the transfer is not active on this process.
+
+	\param[in] transferIndex Index of the transfer.
+	\param[in] localSize Number of doubles in the segment owned by this process.
+    */
+    Teuchos::RCP<pike::SharedMemoryBuffer> 
+    createTransferSharedMemoryBuffer(const TransferIndex transferIndex, const std::size_t localSize) const;
+
+    /** \brief Builds a persistent neighborhood exchange for a transfer from the send/receive pattern of this process.
+
+	Collective over the transfer comm.  The distributed graph comm
+	and the persistent requests are created once, so a transfer
+	that repeats the same pattern every iteration only starts and
+	completes requests.  Throws if the transfer is not active on
+	this process.
+
+	\param[in] transferIndex Index of the transfer.
+	\param[in] sources Transfer comm ranks this process receives from.
+	\param[in] receiveCounts Number of doubles received from each source.
+	\param[in] destinations Transfer comm ranks this process sends to.
+	\param[in] sendCounts Number of doubles sent to each destination.
+    */
+    Teuchos::RCP<pike::NeighborExchange>
+    createTransferNeighborExchange(const TransferIndex transferIndex,
+				   const std::vector<int>& sources,
+				   const std::vector<int>& receiveCounts,
+				   const std::vector<int>& destinations,
+				   const std::vector<int>& sendCounts) const;
+
+    /** \brief Allocates a one-sided (RMA) transfer window over the transfer comm.
+
+	Collective over the transfer comm.  Source processes put their
+	data into the targets' segments as soon as their solve is
+	finished, and targets only synchronize when they need the
+	data.  Throws if the transfer is not active on this process.
+
+	\param[in] transferIndex Index of the transfer.
+	\param[in] localSize Number of doubles that other processes of the transfer can put into this process.
+    */
+    Teuchos::RCP<pike::RmaTransferWindow>
+    createTransferRmaWindow(const TransferIndex transferIndex, const std::size_t localSize) const;
+
+    //! Returns the global comm ranks of the application.  With automatic placement, only valid after setup().
+    const std::vector<int>& getApplicationRanks(const ApplicationIndex index) const;
+
+    //! Returns the volume of the transfer.
+    double getTransferVolume(const TransferIndex index) const;
+
+    /** \brief Overrides the node layout that setup() discovers with MPI_Comm_split_type.
+
+	Consecutive blocks of numProcesses global ranks are treated as
+	one node by automatic placement and the inter-node volume
+	estimate.  Useful to simulate a multi-node layout, or to place
+	applications on a smaller unit such as a socket.  Must be
+	called before setup().
+    */
+    void setProcessesPerNode(const int numProcesses);
+
+    //! Returns the node size set by setProcessesPerNode(), or -1 if setup() discovers the node layout.
+    int getProcessesPerNode() const;
+
+    //! Returns the number of shared memory nodes of the global comm.  Valid after setup().
+    int getNumberOfNodes() const;
+
+    //! Returns the node index of a process of the global comm.  Valid after setup().
+    int getNodeIndex(const int globalRank) const;
+
+    /** \brief Returns the estimated volume of transfer data that crosses node boundaries.  Valid after setup().
+
+	Assumes that the volume of a transfer is spread evenly over all
+	pairs of processes of the coupled applications.  Transfers
+	registered by ranks are treated as an exchange between all of
+	their ranks.
+    */
+    double getEstimatedInterNodeVolume() const;
+
+    //! Sets the number of most recent solve times per application used for load balancing.  Defaults to 10.
+    void setLoadBalanceWindow(const int numSamples);
+
+    int getLoadBalanceWindow() const;
+
+    /** \brief Records the wall time of one solve of an application on this process.
+
+	Call on the processes of the application after each solve.
+	Only the most recent samples (see setLoadBalanceWindow()) are
+	kept.
+    */
+    void recordSolveTime(const ApplicationIndex index, const double seconds);
+
+    //! Returns the average recorded solve time of the application on this process.  Zero if nothing was recorded.
+    double getAverageSolveTime(const ApplicationIndex index) const;
+
+    /** \brief Computes process counts that equalize the time per coupled iteration.
+
+	Collective over the global comm.  The time of each application
+	is the largest average solve time over its processes.  The work
+	of an application is estimated as its time multiplied by its
+	current number of processes, assuming perfect strong scaling.
+	The recommended layout is disjoint, like the one built by
+	addApplicationByCount(): the counts sum to the number of
+	distinct processes currently used, so processes shared by
+	overlapping applications are only counted once.  Applications
+	without recorded times keep their process count and the
+	remaining processes are split between the other applications in
+	proportion to their work.
+
+	The counts can be used in addApplicationByCount() for the next
+	run or at a restart boundary.
+
+	\returns The recommended number of processes for each application.
+    */
+    std::vector<int> computeRecommendedLayout();
+
+    //! Returns the time per coupled iteration measured by the last computeRecommendedLayout(), i.e. the time of the slowest application.
+    double getMeasuredIterationTime() const;
+
+    //! Returns the time per coupled iteration predicted for the last recommended layout.
+    double getPredictedIterationTime() const;
+
+    /** \brief Prints the recommended layout of the last computeRecommendedLayout() as contiguous rank ranges.
+
+	Should be called only on one process, e.g. through getSerialOStream().
+    */
+    void printRecommendedLayout(std::ostream& os) const;
+
     /** \brief Returns the rank of the print process for the given application index.  This rank corresponds to the global communicator. */
     int getPrintRank(const ApplicationIndex index) const;
 
@@ -153,9 +345,38 @@ namespace pike {
 
     };
 
+    //! Determines the node of each process of the global comm.
+    void discoverNodes();
+
+    //! Assigns ranks to applications registered with addApplicationByCount().
+    void placeApplications();
+
+    //! Computes the estimated inter-node transfer volume.
+    void estimateInterNodeVolume();
+
+    //! Returns the fraction of an even exchange between the two rank sets that crosses node boundaries.
+    double interNodeFraction(const std::vector<int>& ranksA, const std::vector<int>& ranksB) const;
+
     //! Builds all communicators.
     void buildComms();
 
+    /** \brief Builds a subcommunicator of the global comm with MPI_Comm_create_group.
+
+	Only collective over the processes in sortedRanks.  Returns a
+	null RCP on processes that are not in sortedRanks.
+    */
+    Teuchos::RCP<const Teuchos::Comm<int> > createSubcommunicator(MPI_Comm rawGlobalComm,
+								  MPI_Group globalGroup,
+								  const std::vector<int>& sortedRanks,
+								  const int tag) const;
+
+    /** \brief Returns the node comm of the transfer, building it on the first call.
+
+	The first call is collective over the transfer comm.  Returns a
+	null RCP if the transfer is not active on this process.
+    */
+    const Teuchos::RCP<const Teuchos::Comm<int> >& buildTransferNodeComm(const TransferIndex index) const;
+
     //! Builds all ostreams.
     void buildOStreams();
 
@@ -186,10 +407,40 @@ namespace pike {
     //! A nonnull RCP means that this transfer is instantiatied on this process.  A transfer comm must represent at least the union of all application comms.
     std::vector<Teuchos::RCP<const Teuchos::Comm<int> > > transferComms_;
 
+    //! Node local subcommunicators of transferComms_, built on request with MPI_Comm_split_type(MPI_COMM_TYPE_SHARED).  Null until requested or if the transfer is not active on this process.
+    mutable std::vector<Teuchos::RCP<const Teuchos::Comm<int> > > transferNodeComms_;
+
     std::vector<std::vector<int> > transferRanks_;
 
     std::vector<std::string> transferNames_;
 
+    std::vector<double> transferVolumes_;
+
+    //! True if applications are placed by the distributor (registered with addApplicationByCount()).
+    bool automaticPlacement_;
+
+    //! Node size set by setProcessesPerNode().  -1 means the node layout is discovered.
+    int processesPerNode_;
+
+    //! Node index of each process of the global comm.
+    std::vector<int> nodeOfRank_;
+
+    int numberOfNodes_;
+
+    double estimatedInterNodeVolume_;
+
+    //! Number of samples kept in solveTimes_.
+    int loadBalanceWindow_;
+
+    //! Most recent solve times of each application on this process.
+    std::vector<std::deque<double> > solveTimes_;
+
+    std::vector<int> recommendedProcessCounts_;
+
+    double measuredIterationTime_;
+
+    double predictedIterationTime_;
+
     std::map<std::string,TransferIndex> transferNameToIndex_;
 
     //! Serial ostream that prints to global process 0.
@@ -0,0 +1,196 @@
+#include "Pike_NeighborExchange.hpp"
+#include "Teuchos_DefaultMpiComm.hpp"
+#include "Teuchos_CommHelpers.hpp"
+#include "Teuchos_Assert.hpp"
+
+namespace pike {
+
+  NeighborExchange::NeighborExchange(const Teuchos::RCP<const Teuchos::Comm<int> >& comm,
+				     const std::vector<int>& sources,
+				     const std::vector<int>& receiveCounts,
+				     const std::vector<int>& destinations,
+				     const std::vector<int>& sendCounts) :
+    receiveCounts_(receiveCounts),
+    sendCounts_(sendCounts),
+    active_(false),
+    numberOfExchanges_(0)
+  {
+    TEUCHOS_ASSERT(nonnull(comm));
+    const Teuchos::MpiComm<int>* mpiComm = dynamic_cast<const Teuchos::MpiComm<int>* >(comm.get());
+    TEUCHOS_TEST_FOR_EXCEPTION(mpiComm == 0, std::logic_error,
+			       "Error: pike::NeighborExchange requires a Teuchos::MpiComm!");
+
+    // Check the pattern on all processes before the collective graph
+    // comm creation so that a bad pattern on one process throws on
+    // every process instead of hanging the others.
+    int localErrors[3];
+    localErrors[0] = (sources.size() != receiveCounts.size()) ? 1 : 0;
+    localErrors[1] = (destinations.size() != sendCounts.size()) ? 1 : 0;
+    localErrors[2] = 0;
+    for (std::vector<int>::const_iterator r = sources.begin(); r != sources.end(); ++r)
+      if ( (*r < 0) || (*r >= comm->getSize()) )
+	localErrors[2] = 1;
+    for (std::vector<int>::const_iterator r = destinations.begin(); r != destinations.end(); ++r)
+      if ( (*r < 0) || (*r >= comm->getSize()) )
+	localErrors[2] = 1;
+    int globalErrors[3];
+    Teuchos::reduceAll(*comm,Teuchos::REDUCE_MAX,3,localErrors,globalErrors);
+
+    TEUCHOS_TEST_FOR_EXCEPTION(globalErrors[0] != 0, std::logic_error,
+			       "Error: pike::NeighborExchange - the number of sources does not match the number of receive counts on at least one process (this process has "
+			       << sources.size() << " sources and " << receiveCounts.size() << " receive counts)!");
+    TEUCHOS_TEST_FOR_EXCEPTION(globalErrors[1] != 0, std::logic_error,
+			       "Error: pike::NeighborExchange - the number of destinations does not match the number of send counts on at least one process (this process has "
+			       << destinations.size() << " destinations and " << sendCounts.size() << " send counts)!");
+    TEUCHOS_TEST_FOR_EXCEPTION(globalErrors[2] != 0, std::logic_error,
+			       "Error: pike::NeighborExchange - a source or destination rank is out of range on at least one process!");
+
+    // No reordering so that graph comm ranks match the original comm
+    MPI_Dist_graph_create_adjacent((*mpiComm->getRawMpiComm())(),
+				   static_cast<int>(sources.size()),
+				   sources.data(),
+				   MPI_UNWEIGHTED,
+				   static_cast<int>(destinations.size()),
+				   destinations.data(),
+				   MPI_UNWEIGHTED,
+				   MPI_INFO_NULL,
+				   0,
+				   &rawGraphComm_);
+    graphComm_ = Teuchos::rcp(new Teuchos::MpiComm<int>(Teuchos::opaqueWrapper(rawGraphComm_,MPI_Comm_free)));
+
+    receiveOffsets_.resize(receiveCounts_.size());
+    int size = 0;
+    for (std::size_t s = 0; s < receiveCounts_.size(); ++s) {
+      receiveOffsets_[s] = size;
+      size += receiveCounts_[s];
+    }
+    receiveBuffer_.resize(size,0.0);
+
+    sendOffsets_.resize(sendCounts_.size());
+    size = 0;
+    for (std::size_t d = 0; d < sendCounts_.size(); ++d) {
+      sendOffsets_[d] = size;
+      size += sendCounts_[d];
+    }
+    sendBuffer_.resize(size,0.0);
+
+#if MPI_VERSION >= 4
+    requests_.resize(1);
+    MPI_Neighbor_alltoallv_init(sendBuffer_.data(),
+				sendCounts_.data(),
+				sendOffsets_.data(),
+				MPI_DOUBLE,
+				receiveBuffer_.data(),
+				receiveCounts_.data(),
+				receiveOffsets_.data(),
+				MPI_DOUBLE,
+				rawGraphComm_,
+				MPI_INFO_NULL,
+				&requests_[0]);
+#else
+    // Each edge gets its own tag, built from the sender and receiver
+    // ranks, so that messages of different edges can never match
+    // each other.  The tag wraps at MPI_TAG_UB, which is still safe
+    // since each process lists a neighbor at most once.
+    const int commSize = comm->getSize();
+    const int myRank = comm->getRank();
+    int* tagUpperBound = 0;
+    int hasTagUpperBound = 0;
+    MPI_Comm_get_attr(rawGraphComm_,MPI_TAG_UB,&tagUpperBound,&hasTagUpperBound);
+    const long maxTag = hasTagUpperBound ? static_cast<long>(*tagUpperBound) : 32767L;
+    requests_.resize(sources.size() + destinations.size());
+    for (std::size_t s = 0; s < sources.size(); ++s) {
+      const int tag = static_cast<int>((static_cast<long>(sources[s]) * commSize + myRank) % (maxTag + 1));
+      MPI_Recv_init(receiveBuffer_.data() + receiveOffsets_[s], receiveCounts_[s], MPI_DOUBLE,
+		    sources[s], tag, rawGraphComm_, &requests_[s]);
+    }
+    for (std::size_t d = 0; d < destinations.size(); ++d) {
+      const int tag = static_cast<int>((static_cast<long>(myRank) * commSize + destinations[d]) % (maxTag + 1));
+      MPI_Send_init(sendBuffer_.data() + sendOffsets_[d], sendCounts_[d], MPI_DOUBLE,
+		    destinations[d], tag, rawGraphComm_, &requests_[sources.size() + d]);
+    }
+#endif
+  }
+
+  NeighborExchange::~NeighborExchange()
+  {
+    if (active_)
+      this->wait();
+    for (std::vector<MPI_Request>::iterator r = requests_.begin(); r != requests_.end(); ++r)
+      MPI_Request_free(&(*r));
+  }
+
+  Teuchos::RCP<const Teuchos::Comm<int> > NeighborExchange::getGraphComm() const
+  { return graphComm_; }
+
+  int NeighborExchange::getNumberOfSources() const
+  { return static_cast<int>(receiveCounts_.size()); }
+
+  int NeighborExchange::getNumberOfDestinations() const
+  { return static_cast<int>(sendCounts_.size()); }
+
+  Teuchos::ArrayView<double> NeighborExchange::getNonconstSendView(const int d)
+  {
+    TEUCHOS_ASSERT( (d >= 0) && (d < static_cast<int>(sendCounts_.size())) );
+    if (sendCounts_[d] == 0)
+      return Teuchos::ArrayView<double>();
+    return Teuchos::ArrayView<double>(&sendBuffer_[sendOffsets_[d]],sendCounts_[d]);
+  }
+
+  Teuchos::ArrayView<const double> NeighborExchange::getReceiveView(const int s) const
+  {
+    TEUCHOS_ASSERT( (s >= 0) && (s < static_cast<int>(receiveCounts_.size())) );
+    if (receiveCounts_[s] == 0)
+      return Teuchos::ArrayView<const double>();
+    return Teuchos::ArrayView<const double>(&receiveBuffer_[receiveOffsets_[s]],receiveCounts_[s]);
+  }
+
+  void NeighborExchange::start()
+  {
+    TEUCHOS_TEST_FOR_EXCEPTION(active_, std::logic_error,
+			       "Error: pike::NeighborExchange::start() - the previous exchange has not been completed with wait()!");
+    if (requests_.size() > 0)
+      MPI_Startall(static_cast<int>(requests_.size()),requests_.data());
+    active_ = true;
+  }
+
+  void NeighborExchange::wait()
+  {
+    TEUCHOS_TEST_FOR_EXCEPTION(!active_, std::logic_error,
+			       "Error: pike::NeighborExchange::wait() - no exchange was started!");
+    if (requests_.size() > 0)
+      MPI_Waitall(static_cast<int>(requests_.size()),requests_.data(),MPI_STATUSES_IGNORE);
+    active_ = false;
+    ++numberOfExchanges_;
+  }
+
+  void NeighborExchange::exchange()
+  {
+    this->start();
+    this->wait();
+  }
+
+  bool NeighborExchange::usesPersistentCollective() const
+  {
+#if MPI_VERSION >= 4
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  int NeighborExchange::getNumberOfExchanges() const
+  { return numberOfExchanges_; }
+
+  // Non-member ctor
+  Teuchos::RCP<pike::NeighborExchange>
+  neighborExchange(const Teuchos::RCP<const Teuchos::Comm<int> >& comm,
+		   const std::vector<int>& sources,
+		   const std::vector<int>& receiveCounts,
+		   const std::vector<int>& destinations,
+		   const std::vector<int>& sendCounts)
+  {
+    return Teuchos::rcp(new pike::NeighborExchange(comm,sources,receiveCounts,destinations,sendCounts));
+  }
+
+}
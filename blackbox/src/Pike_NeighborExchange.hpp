@@ -0,0 +1,120 @@
+#ifndef PIKE_NEIGHBOR_EXCHANGE_HPP
+#define PIKE_NEIGHBOR_EXCHANGE_HPP
+
+#include "Pike_BlackBox_config.hpp"
+#include "Teuchos_RCP.hpp"
+#include "Teuchos_Comm.hpp"
+#include "Teuchos_ArrayView.hpp"
+#include "mpi.h"
+#include <vector>
+
+namespace pike {
+
+  /** \brief A persistent neighborhood exchange for a data transfer
+      that repeats the same communication pattern every iteration.
+
+      The constructor builds a distributed graph communicator
+      (MPI_Dist_graph_create_adjacent) from the declared sources and
+      destinations of this process, allocates packed send and receive
+      buffers, and creates the persistent requests once.  Each
+      exchange then only starts and completes the requests.
+
+      With MPI-4 the exchange is a single persistent
+      MPI_Neighbor_alltoallv_init request.  Otherwise it falls back to
+      persistent point-to-point requests (MPI_Send_init/MPI_Recv_init)
+      on the graph communicator with a distinct tag per edge.
+
+      Usage per iteration: fill the send views, call exchange() (or
+      start() and wait() to overlap work), then read the receive
+      views.  The views stay valid for the lifetime of the object.
+
+      NOTE: The constructor and destructor are collective over the
+      comm.  The constructor checks the pattern sizes and ranks on all
+      processes first and throws on every process if any of them is
+      invalid.  Each process must list a neighbor at most once in
+      sources and at most once in destinations, and the pattern must
+      be consistent: if process a lists b as a destination with n
+      values, b must list a as a source with n values.
+   */
+  class NeighborExchange {
+
+  public:
+
+    /** \brief Builds the graph comm and the persistent requests.
+
+	\param[in] comm The comm the ranks refer to, normally a transfer comm.
+	\param[in] sources Ranks this process receives from.
+	\param[in] receiveCounts Number of doubles received from each source.
+	\param[in] destinations Ranks this process sends to.
+	\param[in] sendCounts Number of doubles sent to each destination.
+    */
+    NeighborExchange(const Teuchos::RCP<const Teuchos::Comm<int> >& comm,
+		     const std::vector<int>& sources,
+		     const std::vector<int>& receiveCounts,
+		     const std::vector<int>& destinations,
+		     const std::vector<int>& sendCounts);
+
+    ~NeighborExchange();
+
+    //! Returns the distributed graph comm.  Ranks are the same as in the original comm.
+    Teuchos::RCP<const Teuchos::Comm<int> > getGraphComm() const;
+
+    int getNumberOfSources() const;
+
+    int getNumberOfDestinations() const;
+
+    //! Returns the send buffer for the d-th destination.
+    Teuchos::ArrayView<double> getNonconstSendView(const int d);
+
+    //! Returns the values received from the s-th source in the last completed exchange.
+    Teuchos::ArrayView<const double> getReceiveView(const int s) const;
+
+    //! Starts the exchange.  The send views must not be modified until wait() returns.
+    void start();
+
+    //! Completes an exchange started with start().
+    void wait();
+
+    //! Equivalent to start() followed by wait().
+    void exchange();
+
+    //! Returns true if the exchange uses a persistent neighborhood collective (MPI-4).
+    bool usesPersistentCollective() const;
+
+    //! Returns the number of completed exchanges.
+    int getNumberOfExchanges() const;
+
+  private:
+
+    // Not copyable: the persistent requests point into the buffers.
+    NeighborExchange(const NeighborExchange&);
+    NeighborExchange& operator=(const NeighborExchange&);
+
+    Teuchos::RCP<const Teuchos::Comm<int> > graphComm_;
+    MPI_Comm rawGraphComm_;
+
+    std::vector<int> receiveCounts_;
+    std::vector<int> receiveOffsets_;
+    std::vector<int> sendCounts_;
+    std::vector<int> sendOffsets_;
+    std::vector<double> receiveBuffer_;
+    std::vector<double> sendBuffer_;
+
+    std::vector<MPI_Request> requests_;
+    bool active_;
+    int numberOfExchanges_;
+  };
+
+  /** \brief Non-member ctor.
+      \relates NeighborExchange
+  */
+  Teuchos::RCP<pike::NeighborExchange>
+  neighborExchange(const Teuchos::RCP<const Teuchos::Comm<int> >& comm,
+		   const std::vector<int>& sources,
+		   const std::vector<int>& receiveCounts,
+		   const std::vector<int>& destinations,
+		   const std::vector<int>& sendCounts);
+
+}
+
+#endif
@@ -0,0 +1,64 @@
+#include "Pike_ResidualHistory.hpp"
+#include "Teuchos_Assert.hpp"
+#include <cmath>
+#include <limits>
+
+namespace pike {
+
+  ResidualHistory::ResidualHistory(const std::size_t capacity) :
+    values_(capacity),
+    newest_(0),
+    size_(0)
+  {
+    TEUCHOS_ASSERT(capacity > 0);
+  }
+
+  void ResidualHistory::setCapacity(const std::size_t capacity)
+  {
+    TEUCHOS_ASSERT(capacity > 0);
+    values_.assign(capacity,0.0);
+    this->clear();
+  }
+
+  std::size_t ResidualHistory::capacity() const
+  { return values_.size(); }
+
+  std::size_t ResidualHistory::size() const
+  { return size_; }
+
+  void ResidualHistory::push(const double residual)
+  {
+    newest_ = (size_ == 0) ? 0 : (newest_ + 1) % values_.size();
+    values_[newest_] = residual;
+    if (size_ < values_.size())
+      ++size_;
+  }
+
+  void ResidualHistory::clear()
+  {
+    newest_ = 0;
+    size_ = 0;
+  }
+
+  double ResidualHistory::operator[](const std::size_t i) const
+  {
+    TEUCHOS_ASSERT(i < size_);
+    return values_[(newest_ + values_.size() - i) % values_.size()];
+  }
+
+  double ResidualHistory::contractionRate(const std::size_t numIterations) const
+  {
+    TEUCHOS_ASSERT(numIterations > 0);
+    TEUCHOS_TEST_FOR_EXCEPTION(numIterations >= size_, std::logic_error,
+			       "Error: pike::ResidualHistory::contractionRate() - the rate over " << numIterations
+			       << " iterations needs " << numIterations + 1 << " residuals, but only " << size_
+			       << " are stored!");
+
+    const double newest = (*this)[0];
+    const double oldest = (*this)[numIterations];
+    if (oldest == 0.0)
+      return (newest == 0.0) ? 0.0 : std::numeric_limits<double>::infinity();
+    return std::pow(newest / oldest, 1.0 / static_cast<double>(numIterations));
+  }
+
+}
@@ -0,0 +1,57 @@
+#ifndef PIKE_RESIDUAL_HISTORY_HPP
+#define PIKE_RESIDUAL_HISTORY_HPP
+
+#include <vector>
+#include <cstddef>
+
+namespace pike {
+
+  /** \brief Fixed size ring buffer of the most recent residual norms of an iteration.
+
+      Pushing a residual into a full buffer overwrites the oldest one,
+      so the storage is allocated once.  Entry 0 is the newest
+      residual.  Used by the status tests that estimate the
+      contraction rate of a fixed-point iteration.
+   */
+  class ResidualHistory {
+
+  public:
+
+    ResidualHistory(const std::size_t capacity = 1);
+
+    //! Sets the maximum number of stored residuals and clears the history.
+    void setCapacity(const std::size_t capacity);
+
+    std::size_t capacity() const;
+
+    //! Returns the number of stored residuals.
+    std::size_t size() const;
+
+    //! Adds the residual of the newest iteration.
+    void push(const double residual);
+
+    void clear();
+
+    //! Returns the residual from i iterations ago (0 is the newest).
+    double operator[](const std::size_t i) const;
+
+    /** \brief Returns the estimated contraction rate over the last numIterations iterations.
+
+	This is the geometric mean of the ratios of consecutive
+	residuals, (r_k / r_{k-n})^{1/n}.  A rate below one means the
+	iteration contracts, a rate of one or above means it stagnates
+	or diverges.  If the older residual is zero, the rate is zero
+	when the newest residual is also zero and infinite otherwise.
+	Requires size() > numIterations.
+    */
+    double contractionRate(const std::size_t numIterations) const;
+
+  private:
+    std::vector<double> values_;
+    std::size_t newest_;
+    std::size_t size_;
+  };
+
+}
+
+#endif
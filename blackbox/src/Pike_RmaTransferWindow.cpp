@@ -0,0 +1,130 @@
+#include "Pike_RmaTransferWindow.hpp"
+#include "Teuchos_DefaultMpiComm.hpp"
+#include "Teuchos_Assert.hpp"
+
+namespace pike {
+
+  RmaTransferWindow::RmaTransferWindow(const Teuchos::RCP<const Teuchos::Comm<int> >& comm,
+				       const std::size_t localSize) :
+    comm_(comm),
+    localSize_(localSize),
+    data_(0),
+    dataWindow_(MPI_WIN_NULL),
+    version_(0),
+    versionWindow_(MPI_WIN_NULL)
+  {
+    TEUCHOS_ASSERT(nonnull(comm_));
+    const Teuchos::MpiComm<int>* mpiComm = dynamic_cast<const Teuchos::MpiComm<int>* >(comm_.get());
+    TEUCHOS_TEST_FOR_EXCEPTION(mpiComm == 0, std::logic_error,
+			       "Error: pike::RmaTransferWindow requires a Teuchos::MpiComm!");
+    MPI_Comm rawComm = (*mpiComm->getRawMpiComm())();
+
+    MPI_Win_allocate(static_cast<MPI_Aint>(localSize_*sizeof(double)),
+		     sizeof(double),
+		     MPI_INFO_NULL,
+		     rawComm,
+		     &data_,
+		     &dataWindow_);
+
+    MPI_Win_allocate(static_cast<MPI_Aint>(sizeof(long)),
+		     sizeof(long),
+		     MPI_INFO_NULL,
+		     rawComm,
+		     &version_,
+		     &versionWindow_);
+
+    MPI_Win_lock_all(MPI_MODE_NOCHECK,dataWindow_);
+    MPI_Win_lock_all(MPI_MODE_NOCHECK,versionWindow_);
+
+    // Initial values must be in place before any process can access
+    // them.
+    for (std::size_t i = 0; i < localSize_; ++i)
+      data_[i] = 0.0;
+    *version_ = 0;
+    MPI_Win_sync(dataWindow_);
+    MPI_Win_sync(versionWindow_);
+    MPI_Barrier(rawComm);
+  }
+
+  RmaTransferWindow::~RmaTransferWindow()
+  {
+    if (versionWindow_ != MPI_WIN_NULL) {
+      MPI_Win_unlock_all(versionWindow_);
+      MPI_Win_free(&versionWindow_);
+    }
+    if (dataWindow_ != MPI_WIN_NULL) {
+      MPI_Win_unlock_all(dataWindow_);
+      MPI_Win_free(&dataWindow_);
+    }
+  }
+
+  Teuchos::RCP<const Teuchos::Comm<int> > RmaTransferWindow::getComm() const
+  { return comm_; }
+
+  void RmaTransferWindow::put(const int targetRank, const std::size_t offset, const Teuchos::ArrayView<const double>& values)
+  {
+    TEUCHOS_ASSERT( (targetRank >= 0) && (targetRank < comm_->getSize()) );
+    if (values.size() == 0)
+      return;
+    MPI_Put(values.getRawPtr(),
+	    static_cast<int>(values.size()),
+	    MPI_DOUBLE,
+	    targetRank,
+	    static_cast<MPI_Aint>(offset),
+	    static_cast<int>(values.size()),
+	    MPI_DOUBLE,
+	    dataWindow_);
+  }
+
+  void RmaTransferWindow::flush(const int targetRank)
+  {
+    TEUCHOS_ASSERT( (targetRank >= 0) && (targetRank < comm_->getSize()) );
+    MPI_Win_flush(targetRank,dataWindow_);
+  }
+
+  void RmaTransferWindow::publish(const int targetRank)
+  {
+    // The data must be complete at the target before the version
+    // changes.
+    this->flush(targetRank);
+    const long one = 1;
+    MPI_Accumulate(&one,1,MPI_LONG,targetRank,0,1,MPI_LONG,MPI_SUM,versionWindow_);
+    MPI_Win_flush(targetRank,versionWindow_);
+  }
+
+  long RmaTransferWindow::getVersion() const
+  {
+    // Read atomically with respect to the accumulates of the sources
+    long version = 0;
+    const long dummy = 0;
+    MPI_Fetch_and_op(&dummy,&version,MPI_LONG,comm_->getRank(),0,MPI_NO_OP,versionWindow_);
+    MPI_Win_flush(comm_->getRank(),versionWindow_);
+    return version;
+  }
+
+  long RmaTransferWindow::waitForVersion(const long minVersion) const
+  {
+    long version = this->getVersion();
+    while (version < minVersion)
+      version = this->getVersion();
+    return version;
+  }
+
+  Teuchos::ArrayView<const double> RmaTransferWindow::getLocalView() const
+  {
+    // Synchronize the public and private copies of the window
+    MPI_Win_sync(dataWindow_);
+    if (localSize_ == 0)
+      return Teuchos::ArrayView<const double>();
+    return Teuchos::ArrayView<const double>(data_,localSize_);
+  }
+
+  // Non-member ctor
+  Teuchos::RCP<pike::RmaTransferWindow>
+  rmaTransferWindow(const Teuchos::RCP<const Teuchos::Comm<int> >& comm,
+		    const std::size_t localSize)
+  {
+    return Teuchos::rcp(new pike::RmaTransferWindow(comm,localSize));
+  }
+
+}
@@ -0,0 +1,104 @@
+#ifndef PIKE_RMA_TRANSFER_WINDOW_HPP
+#define PIKE_RMA_TRANSFER_WINDOW_HPP
+
+#include "Pike_BlackBox_config.hpp"
+#include "Teuchos_RCP.hpp"
+#include "Teuchos_Comm.hpp"
+#include "Teuchos_ArrayView.hpp"
+#include "mpi.h"
+
+namespace pike {
+
+  /** \brief One-sided (RMA) backend for data transfers.
+
+      Each process of the comm exposes a receive segment of doubles
+      and a version counter in MPI windows.  Both windows are kept in
+      a passive target epoch (MPI_Win_lock_all) for the lifetime of
+      the object, so no process has to participate when another
+      process accesses its memory.
+
+      A source process calls put() as soon as its solve() finishes
+      and then publish(), which completes the puts at the target
+      (MPI_Win_flush) and atomically increments the target's version
+      counter.  A target only synchronizes when it needs the data:
+      getVersion() reads its counter and waitForVersion() polls until
+      the expected number of publishes arrived.  Source and target
+      timelines are therefore decoupled.
+
+      IMPORTANT: The window does not prevent a source from
+      overwriting data that a target has not read yet.  If a segment
+      is reused every iteration, the coupling algorithm must order
+      the iterations (for example, a target only advances after
+      waitForVersion() and a source only puts after the target's
+      next request).
+
+      NOTE: The constructor and destructor are collective over the
+      comm.
+   */
+  class RmaTransferWindow {
+
+  public:
+
+    /** \brief Allocates the windows.
+
+	\param[in] comm Comm of the processes involved in the transfer, normally a transfer comm.
+	\param[in] localSize Number of doubles that other processes can put into this process.
+    */
+    RmaTransferWindow(const Teuchos::RCP<const Teuchos::Comm<int> >& comm,
+		      const std::size_t localSize);
+
+    ~RmaTransferWindow();
+
+    Teuchos::RCP<const Teuchos::Comm<int> > getComm() const;
+
+    /** \brief Starts putting values into the segment of targetRank at offset.
+
+	The put is only guaranteed to be complete at the target after
+	publish() or flush() for targetRank.  The values must not be
+	modified until then.
+    */
+    void put(const int targetRank, const std::size_t offset, const Teuchos::ArrayView<const double>& values);
+
+    //! Completes all puts to targetRank without notifying it.
+    void flush(const int targetRank);
+
+    //! Completes all puts to targetRank and increments its version counter.
+    void publish(const int targetRank);
+
+    //! Returns the number of publishes received by this process.
+    long getVersion() const;
+
+    /** \brief Blocks until this process received at least minVersion publishes.  Returns the version.
+
+	Polls the version counter, so it only returns if enough source
+	processes call publish().
+    */
+    long waitForVersion(const long minVersion) const;
+
+    //! Returns the local segment.  The values reflect all puts that were published to this process.
+    Teuchos::ArrayView<const double> getLocalView() const;
+
+  private:
+
+    // Not copyable: the windows are freed in the destructor.
+    RmaTransferWindow(const RmaTransferWindow&);
+    RmaTransferWindow& operator=(const RmaTransferWindow&);
+
+    Teuchos::RCP<const Teuchos::Comm<int> > comm_;
+    std::size_t localSize_;
+    double* data_;
+    MPI_Win dataWindow_;
+    long* version_;
+    MPI_Win versionWindow_;
+  };
+
+  /** \brief Non-member ctor.
+      \relates RmaTransferWindow
+  */
+  Teuchos::RCP<pike::RmaTransferWindow>
+  rmaTransferWindow(const Teuchos::RCP<const Teuchos::Comm<int> >& comm,
+		    const std::size_t localSize);
+
+}
+
+#endif
@@ -0,0 +1,105 @@
+#include "Pike_SharedMemoryBuffer.hpp"
+#include "Teuchos_DefaultMpiComm.hpp"
+#include "Teuchos_Assert.hpp"
+
+namespace pike {
+
+  SharedMemoryBuffer::SharedMemoryBuffer(const Teuchos::RCP<const Teuchos::Comm<int> >& comm,
+					 const std::size_t localSize) :
+    comm_(comm),
+    window_(MPI_WIN_NULL)
+  {
+    TEUCHOS_ASSERT(nonnull(comm_));
+    const Teuchos::MpiComm<int>* mpiComm = dynamic_cast<const Teuchos::MpiComm<int>* >(comm_.get());
+    TEUCHOS_TEST_FOR_EXCEPTION(mpiComm == 0, std::logic_error,
+			       "Error: pike::SharedMemoryBuffer requires a Teuchos::MpiComm!");
+    rawComm_ = (*mpiComm->getRawMpiComm())();
+
+    // All processes must share memory.  Splitting by node must not
+    // break up the comm.
+    {
+      MPI_Comm nodeComm;
+      MPI_Comm_split_type(rawComm_,MPI_COMM_TYPE_SHARED,comm_->getRank(),MPI_INFO_NULL,&nodeComm);
+      int nodeSize = -1;
+      MPI_Comm_size(nodeComm,&nodeSize);
+      MPI_Comm_free(&nodeComm);
+      TEUCHOS_TEST_FOR_EXCEPTION(nodeSize != comm_->getSize(), std::logic_error,
+				 "Error: pike::SharedMemoryBuffer - the comm spans more than one shared memory node!  Only "
+				 << nodeSize << " of the " << comm_->getSize() << " processes share memory with process "
+				 << comm_->getRank() << ".");
+    }
+
+    double* localBase = 0;
+    MPI_Win_allocate_shared(static_cast<MPI_Aint>(localSize*sizeof(double)),
+			    sizeof(double),
+			    MPI_INFO_NULL,
+			    rawComm_,
+			    &localBase,
+			    &window_);
+
+    segments_.resize(comm_->getSize());
+    sizes_.resize(comm_->getSize());
+    for (int r = 0; r < comm_->getSize(); ++r) {
+      MPI_Aint segmentBytes = 0;
+      int dispUnit = 0;
+      double* base = 0;
+      MPI_Win_shared_query(window_,r,&segmentBytes,&dispUnit,&base);
+      segments_[r] = base;
+      sizes_[r] = static_cast<std::size_t>(segmentBytes) / sizeof(double);
+    }
+
+    MPI_Win_lock_all(MPI_MODE_NOCHECK,window_);
+  }
+
+  SharedMemoryBuffer::~SharedMemoryBuffer()
+  {
+    if (window_ != MPI_WIN_NULL) {
+      MPI_Win_unlock_all(window_);
+      MPI_Win_free(&window_);
+    }
+  }
+
+  Teuchos::RCP<const Teuchos::Comm<int> > SharedMemoryBuffer::getComm() const
+  { return comm_; }
+
+  std::size_t SharedMemoryBuffer::getSize(const int rank) const
+  {
+    TEUCHOS_ASSERT( (rank >= 0) && (rank < static_cast<int>(sizes_.size())) );
+    return sizes_[rank];
+  }
+
+  Teuchos::ArrayView<double> SharedMemoryBuffer::getLocalView()
+  { return this->getNonconstView(comm_->getRank()); }
+
+  Teuchos::ArrayView<const double> SharedMemoryBuffer::getView(const int rank) const
+  {
+    TEUCHOS_ASSERT( (rank >= 0) && (rank < static_cast<int>(segments_.size())) );
+    if (sizes_[rank] == 0)
+      return Teuchos::ArrayView<const double>();
+    return Teuchos::ArrayView<const double>(segments_[rank],sizes_[rank]);
+  }
+
+  Teuchos::ArrayView<double> SharedMemoryBuffer::getNonconstView(const int rank)
+  {
+    TEUCHOS_ASSERT( (rank >= 0) && (rank < static_cast<int>(segments_.size())) );
+    if (sizes_[rank] == 0)
+      return Teuchos::ArrayView<double>();
+    return Teuchos::ArrayView<double>(segments_[rank],sizes_[rank]);
+  }
+
+  void SharedMemoryBuffer::synchronize()
+  {
+    MPI_Win_sync(window_);
+    MPI_Barrier(rawComm_);
+    MPI_Win_sync(window_);
+  }
+
+  // Non-member ctor
+  Teuchos::RCP<pike::SharedMemoryBuffer>
+  sharedMemoryBuffer(const Teuchos::RCP<const Teuchos::Comm<int> >& comm,
+		     const std::size_t localSize)
+  {
+    return Teuchos::rcp(new pike::SharedMemoryBuffer(comm,localSize));
+  }
+
+}
@@ -0,0 +1,91 @@
+#ifndef PIKE_SHARED_MEMORY_BUFFER_HPP
+#define PIKE_SHARED_MEMORY_BUFFER_HPP
+
+#include "Pike_BlackBox_config.hpp"
+#include "Teuchos_RCP.hpp"
+#include "Teuchos_Comm.hpp"
+#include "Teuchos_ArrayView.hpp"
+#include "mpi.h"
+#include <vector>
+
+namespace pike {
+
+  /** \brief A buffer of doubles in an MPI-3 shared memory window.
+
+      Each process of the communicator owns a segment of the window,
+      but every process can load from and store to the segments of
+      all other processes directly.  This allows data transfers
+      between applications that run on the same node to exchange
+      data without MPI message copies.
+
+      The communicator must only contain processes that share memory
+      (for example, the comm returned by
+      pike::MultiphysicsDistributor::getTransferNodeComm()),
+      otherwise the constructor throws.
+
+      The window is kept in a passive target epoch for its lifetime.
+      Call synchronize() between writing a segment and reading it on
+      another process.  synchronize() is collective over the comm.
+
+      NOTE: The constructor and destructor are collective over the
+      comm.
+   */
+  class SharedMemoryBuffer {
+
+  public:
+
+    /** \brief Allocates the shared window.
+
+	\param[in] comm Comm of the processes sharing the buffer.  All processes must be on the same node.
+	\param[in] localSize Number of doubles in the segment owned by this process.  Can differ between processes and can be zero.
+     */
+    SharedMemoryBuffer(const Teuchos::RCP<const Teuchos::Comm<int> >& comm,
+		       const std::size_t localSize);
+
+    ~SharedMemoryBuffer();
+
+    Teuchos::RCP<const Teuchos::Comm<int> > getComm() const;
+
+    //! Returns the number of doubles in the segment owned by rank of the comm.
+    std::size_t getSize(const int rank) const;
+
+    //! Returns the segment owned by this process.
+    Teuchos::ArrayView<double> getLocalView();
+
+    //! Returns a read only view of the segment owned by rank of the comm.
+    Teuchos::ArrayView<const double> getView(const int rank) const;
+
+    //! Returns the segment owned by rank of the comm.
+    Teuchos::ArrayView<double> getNonconstView(const int rank);
+
+    /** \brief Makes stores from all processes visible to all processes.
+
+	Collective over the comm.  Performs a memory sync, a barrier
+	and a second memory sync.
+    */
+    void synchronize();
+
+  private:
+
+    // Not copyable: the window is freed in the destructor.
+    SharedMemoryBuffer(const SharedMemoryBuffer&);
+    SharedMemoryBuffer& operator=(const SharedMemoryBuffer&);
+
+    Teuchos::RCP<const Teuchos::Comm<int> > comm_;
+    MPI_Comm rawComm_;
+    MPI_Win window_;
+    //! Base address of each segment, queried once at construction.
+    std::vector<double*> segments_;
+    std::vector<std::size_t> sizes_;
+  };
+
+  /** \brief Non-member ctor.
+      \relates SharedMemoryBuffer
+  */
+  Teuchos::RCP<pike::SharedMemoryBuffer>
+  sharedMemoryBuffer(const Teuchos::RCP<const Teuchos::Comm<int> >& comm,
+		     const std::size_t localSize);
+
+}
+
+#endif
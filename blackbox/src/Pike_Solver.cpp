@@ -0,0 +1,65 @@
+#include "Pike_Solver.hpp"
+#include "Pike_BlackBoxModelEvaluator.hpp"
+#include "Pike_DataTransfer.hpp"
+
+namespace pike {
+
+  int Solver::getModelEvaluatorIndex(const std::string& meName) const
+  {
+    const std::vector<Teuchos::RCP<const pike::BlackBoxModelEvaluator> > models = this->getModelEvaluators();
+    for (std::size_t i = 0; i < models.size(); ++i)
+      if (models[i]->name() == meName)
+	return static_cast<int>(i);
+
+    TEUCHOS_TEST_FOR_EXCEPTION(true,std::logic_error,"pike::Solver::getModelEvaluatorIndex(): Failed to find the ModelEvaluator named \"" << meName << "\" in the solver.");
+    return -1;
+  }
+
+  Teuchos::RCP<const pike::BlackBoxModelEvaluator> Solver::getModelEvaluator(const int index) const
+  {
+    const std::vector<Teuchos::RCP<const pike::BlackBoxModelEvaluator> > models = this->getModelEvaluators();
+    TEUCHOS_TEST_FOR_EXCEPTION( (index < 0) || (index >= static_cast<int>(models.size())), std::logic_error,
+				"pike::Solver::getModelEvaluator(): The model index " << index
+				<< " is out of range [0," << models.size() << ")!");
+    return models[index];
+  }
+
+  Teuchos::ArrayView<const Teuchos::RCP<const pike::BlackBoxModelEvaluator> > Solver::getModelEvaluatorsView() const
+  {
+    // Only refresh the cache when the registered models changed so
+    // that views handed out earlier stay valid until registration.
+    const std::vector<Teuchos::RCP<const pike::BlackBoxModelEvaluator> > models = this->getModelEvaluators();
+    if (models != modelsViewCache_)
+      modelsViewCache_ = models;
+    return Teuchos::arrayViewFromVector(modelsViewCache_);
+  }
+
+  int Solver::getDataTransferIndex(const std::string& dtName) const
+  {
+    const std::vector<Teuchos::RCP<const pike::DataTransfer> > transfers = this->getDataTransfers();
+    for (std::size_t i = 0; i < transfers.size(); ++i)
+      if (transfers[i]->name() == dtName)
+	return static_cast<int>(i);
+
+    TEUCHOS_TEST_FOR_EXCEPTION(true,std::logic_error,"pike::Solver::getDataTransferIndex(): Failed to find the DataTransfer named \"" << dtName << "\" in the solver.");
+    return -1;
+  }
+
+  Teuchos::RCP<const pike::DataTransfer> Solver::getDataTransfer(const int index) const
+  {
+    const std::vector<Teuchos::RCP<const pike::DataTransfer> > transfers = this->getDataTransfers();
+    TEUCHOS_TEST_FOR_EXCEPTION( (index < 0) || (index >= static_cast<int>(transfers.size())), std::logic_error,
+				"pike::Solver::getDataTransfer(): The transfer index " << index
+				<< " is out of range [0," << transfers.size() << ")!");
+    return transfers[index];
+  }
+
+  Teuchos::ArrayView<const Teuchos::RCP<const pike::DataTransfer> > Solver::getDataTransfersView() const
+  {
+    const std::vector<Teuchos::RCP<const pike::DataTransfer> > transfers = this->getDataTransfers();
+    if (transfers != transfersViewCache_)
+      transfersViewCache_ = transfers;
+    return Teuchos::arrayViewFromVector(transfersViewCache_);
+  }
+
+}
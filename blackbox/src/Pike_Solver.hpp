@@ -5,6 +5,7 @@
 #include "Teuchos_VerboseObject.hpp"
 #include "Teuchos_Describable.hpp"
 #include "Pike_StatusTest.hpp"
+#include "Teuchos_ArrayView.hpp"
 #include <vector>
 
 namespace Teuchos {template<typename> class Comm;}
@@ -52,15 +53,48 @@ namespace pike {
     //! Returns the requested model evaluator.
     virtual Teuchos::RCP<const pike::BlackBoxModelEvaluator> getModelEvaluator(const std::string& name) const = 0;
 
+    /** \brief Returns the index of the requested model evaluator.
+
+	The index is the position of the model in the registration
+	order and is the same as its position in
+	getModelEvaluators().  It never changes once registered, so
+	status tests and data transfers can look up the index once and
+	then use getModelEvaluator(const int) instead of a name lookup.
+	The default implementation searches getModelEvaluators().
+    */
+    virtual int getModelEvaluatorIndex(const std::string& name) const;
+
+    //! Returns the model evaluator for the index returned by getModelEvaluatorIndex().
+    virtual Teuchos::RCP<const pike::BlackBoxModelEvaluator> getModelEvaluator(const int index) const;
+
     //! Returns all registered model evaluators.
     virtual const std::vector<Teuchos::RCP<const pike::BlackBoxModelEvaluator> > getModelEvaluators() const = 0;
 
+    /** \brief Returns a view of all registered model evaluators.
+
+	Unlike getModelEvaluators(), this does not allocate or copy
+	the RCPs.  The view is invalidated by a call to
+	registerModelEvaluator().  The default implementation, for
+	solvers that only provide getModelEvaluators(), copies the
+	models into a cache that is refreshed only when they change.
+    */
+    virtual Teuchos::ArrayView<const Teuchos::RCP<const pike::BlackBoxModelEvaluator> > getModelEvaluatorsView() const;
+
     //! Return the requested data transfer.
     virtual Teuchos::RCP<const pike::DataTransfer> getDataTransfer(const std::string& name) const = 0;
 
+    //! Returns the (stable) registration index of the requested data transfer.  The default implementation searches getDataTransfers().
+    virtual int getDataTransferIndex(const std::string& name) const;
+
+    //! Returns the data transfer for the index returned by getDataTransferIndex().
+    virtual Teuchos::RCP<const pike::DataTransfer> getDataTransfer(const int index) const;
+
     //! Return all registered data transfers.
     virtual const std::vector<Teuchos::RCP<const pike::DataTransfer> > getDataTransfers() const = 0;
 
+    //! Returns a view of all registered data transfers.  Invalidated by a call to registerDataTransfer().  The default implementation caches getDataTransfers().
+    virtual Teuchos::ArrayView<const Teuchos::RCP<const pike::DataTransfer> > getDataTransfersView() const;
+
     /** \brief Take one step of the solve iteration sequence.
     
          @return Current SolveStatus.  
@@ -113,6 +147,13 @@ namespace pike {
         solves.
     */
     virtual std::string name() const = 0;
+
+  private:
+
+    //! Storage for the default getModelEvaluatorsView().
+    mutable std::vector<Teuchos::RCP<const pike::BlackBoxModelEvaluator> > modelsViewCache_;
+    //! Storage for the default getDataTransfersView().
+    mutable std::vector<Teuchos::RCP<const pike::DataTransfer> > transfersViewCache_;
   };
 
 }
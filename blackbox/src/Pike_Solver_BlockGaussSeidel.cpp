@@ -2,16 +2,21 @@
 #include "Teuchos_ParameterList.hpp"
 #include "Teuchos_VerboseObjectParameterListHelpers.hpp"
 #include "Teuchos_Comm.hpp"
+#include "Teuchos_CommHelpers.hpp"
 #include "Pike_BlackBoxModelEvaluator.hpp"
 #include "Pike_DataTransfer.hpp"
 
 namespace pike {
 
-  BlockGaussSeidel::BlockGaussSeidel()
+  BlockGaussSeidel::BlockGaussSeidel() :
+    skipUnchangedSolves_(false),
+    numberOfSkippedSolves_(0)
   {
     this->getNonconstValidParameters()->set("Type","Block Gauss-Seidel");
     this->getNonconstValidParameters()->set("MPI Barrier Transfers",false,"If set to true, an MPI barrier will be called after all transfers are finished.");
     this->getNonconstValidParameters()->set("MPI Barrier Solves",false,"If set to true, an MPI barrier will be called after all model solves.");
+    this->getNonconstValidParameters()->set("Targeted MPI Barriers",false,"If set to true, the barriers requested by \"MPI Barrier Transfers\" and \"MPI Barrier Solves\" only synchronize the processes of each data transfer comm registered with registerTransferComm(), using nonblocking barriers, instead of all processes of the comm registered with registerComm().");
+    this->getNonconstValidParameters()->set("Skip Solves With Unchanged Inputs",false,"If set to true, a model is not solved if it was already solved since the last reset, is locally converged, and none of the data transfers targeting it report changed target data since its last solve.  The decision is reduced over the comm registered with registerComm(), which is required.");
   }
 
   void BlockGaussSeidel::completeRegistration()
@@ -23,44 +28,111 @@ namespace pike {
 
     barrierSolves_ = this->getParameterList()->get<bool>("MPI Barrier Solves");
 
-    if (barrierTransfers_ || barrierSolves_)
+    skipUnchangedSolves_ = this->getParameterList()->get<bool>("Skip Solves With Unchanged Inputs");
+
+    targetedBarriers_ = this->getParameterList()->get<bool>("Targeted MPI Barriers");
+
+    if ( (barrierTransfers_ || barrierSolves_) && !targetedBarriers_)
       TEUCHOS_TEST_FOR_EXCEPTION(is_null(comm_), std::logic_error,
 				 "ERROR: An MPI Barrier of either the transfers or solves of a BlockJacobi solver was requested, but the teuchos comm was not ergistered with this object prior to completeRegistration being called.  Please register the comm or disable the mpi barriers.");
 
+    TEUCHOS_TEST_FOR_EXCEPTION(skipUnchangedSolves_ && is_null(comm_), std::logic_error,
+			       "ERROR: \"Skip Solves With Unchanged Inputs\" was requested for a BlockGaussSeidel solver, but the teuchos comm was not registered with this object prior to completeRegistration being called.  The decision to skip a solve is reduced over this comm so that all processes of a model agree.");
+
     modelAndTransfers_.resize(models_.size());
     for (std::size_t  i = 0; i < modelAndTransfers_.size(); ++i) {
       modelAndTransfers_[i].first = models_[i];
       modelNameToIndex_[models_[i]->name()] = i;
     }
 
+    targetTransferIndices_.resize(models_.size());
+    sourceTransferIndices_.resize(models_.size());
     for (TransferIterator t = transfers_.begin(); t != transfers_.end(); ++t) {
+      const int transferIndex = static_cast<int>(t - transfers_.begin());
       const std::vector<std::string> targetModels = (*t)->getTargetModelNames();
       for (std::vector<std::string>::const_iterator n = targetModels.begin(); 
 	   n != targetModels.end(); ++n) {
 	modelAndTransfers_[modelNameToIndex_[*n]].second.push_back(*t);
+	targetTransferIndices_[modelNameToIndex_[*n]].push_back(transferIndex);
+      }
+      const std::vector<std::string>& sourceModels = (*t)->getSourceModelNames();
+      for (std::vector<std::string>::const_iterator n = sourceModels.begin(); 
+	   n != sourceModels.end(); ++n) {
+	std::map<std::string,std::size_t>::const_iterator i = modelNameToIndex_.find(*n);
+	if (i != modelNameToIndex_.end())
+	  sourceTransferIndices_[i->second].push_back(transferIndex);
       }
     }
+
+    solvedSinceReset_.assign(models_.size(),false);
+    transferIsCurrent_.assign(transfers_.size(),false);
   }
 
   void BlockGaussSeidel::stepImplementation()
   {
     typedef std::vector<std::pair<Teuchos::RCP<pike::BlackBoxModelEvaluator>,std::vector<Teuchos::RCP<pike::DataTransfer> > > >::iterator GSIterator;
 
+    transferIsCurrent_.assign(transfers_.size(),false);
+
     for (GSIterator m = modelAndTransfers_.begin(); m != modelAndTransfers_.end(); ++m) {
  
-      // for the model about to be solved, transfer all data to the model
-      for (std::vector<Teuchos::RCP<pike::DataTransfer> >::iterator t = m->second.begin();
-	   t != m->second.end(); ++t) {
-	(*t)->doTransfer(*this);
+      const std::size_t modelIndex = m - modelAndTransfers_.begin();
+      const std::string modelName = m->first->name();
+      int solveNeeded = 1;
+      if (skipUnchangedSolves_)
+	solveNeeded = (!solvedSinceReset_[modelIndex] || !m->first->isLocallyConverged()) ? 1 : 0;
+
+      // for the model about to be solved, transfer all data to the
+      // model.  A transfer that already ran for an earlier target and
+      // whose sources were not solved since has nothing new to send.
+      for (std::size_t i = 0; i < m->second.size(); ++i) {
+	const Teuchos::RCP<pike::DataTransfer>& transfer = m->second[i];
+	const int transferIndex = targetTransferIndices_[modelIndex][i];
+	if (!transferIsCurrent_[transferIndex]) {
+	  transfer->doTransfer(*this);
+	  transferIsCurrent_[transferIndex] = true;
+
+	  if (barrierTransfers_ && !targetedBarriers_)
+	    comm_->barrier();
+	}
 	
-	if (barrierTransfers_)
-	  comm_->barrier();
+	if (skipUnchangedSolves_ && transfer->changedTarget(modelName))
+	  solveNeeded = 1;
       }
 
-      m->first->solve();
+      // Targeted barriers wait on all transfers into this model at
+      // once
+      if (barrierTransfers_ && targetedBarriers_)
+	this->transferCommBarrier(targetTransferIndices_[modelIndex]);
+
+      // All processes must agree, otherwise a collective solve hangs
+      if (skipUnchangedSolves_) {
+	int globalSolveNeeded = 1;
+	Teuchos::reduceAll(*comm_,Teuchos::REDUCE_MAX,solveNeeded,Teuchos::outArg(globalSolveNeeded));
+	solveNeeded = globalSolveNeeded;
+      }
+
+      if (solveNeeded == 0)
+	++numberOfSkippedSolves_;
+      else {
+	m->first->solve();
+	solvedSinceReset_[modelIndex] = true;
+	for (std::vector<int>::const_iterator t = sourceTransferIndices_[modelIndex].begin();
+	     t != sourceTransferIndices_[modelIndex].end(); ++t)
+	  transferIsCurrent_[*t] = false;
+	if (skipUnchangedSolves_)
+	  for (std::vector<Teuchos::RCP<pike::DataTransfer> >::iterator t = m->second.begin(); t != m->second.end(); ++t)
+	    (*t)->targetSolved(modelName);
+      }
       
-      if (barrierSolves_)
-	comm_->barrier();
+      // Only the processes that transfer data out of this model need
+      // to wait for its solve
+      if (barrierSolves_) {
+	if (targetedBarriers_)
+	  this->transferCommBarrier(sourceTransferIndices_[modelIndex]);
+	else
+	  comm_->barrier();
+      }
 
     }
   }
@@ -70,4 +142,16 @@ namespace pike {
     comm_ = comm;
   }
 
+  void BlockGaussSeidel::reset()
+  {
+    this->pike::SolverDefaultBase::reset();
+    solvedSinceReset_.assign(models_.size(),false);
+    numberOfSkippedSolves_ = 0;
+  }
+
+  int BlockGaussSeidel::getNumberOfSkippedSolves() const
+  {
+    return numberOfSkippedSolves_;
+  }
+
 }
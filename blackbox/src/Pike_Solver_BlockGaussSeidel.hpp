@@ -8,6 +8,16 @@
 
 namespace pike {
 
+  /** \brief Block Gauss-Seidel coupling: each model is solved in
+      turn, right after the transfers that target it.
+
+      A transfer with several targets runs before the first of its
+      targets in each iteration.  It only runs again before a later
+      target if one of its source models was solved in between, so
+      the change norms it reports (see
+      DataTransfer::getChangeNormSquared()) are not overwritten by a
+      repeated transfer of unchanged data.
+  */
   class BlockGaussSeidel : public pike::SolverDefaultBase {
     
   public:
@@ -20,6 +30,11 @@ namespace pike {
 
     void registerComm(const Teuchos::RCP<const Teuchos::Comm<int> >& comm);
 
+    void reset();
+
+    //! Returns the number of model solves skipped because none of the model's inputs changed since reset() was last called.
+    int getNumberOfSkippedSolves() const;
+
   private:
 
     //! Maps the name of a model to the corresponding index in the models vector.
@@ -30,7 +45,21 @@ namespace pike {
     
     bool barrierTransfers_;
     bool barrierSolves_;
+    //! If true, barriers only synchronize the transfer comms.
+    bool targetedBarriers_;
     Teuchos::RCP<const Teuchos::Comm<int> > comm_;
+    //! For each model, the indices of the transfers that target the model, in the same order as modelAndTransfers_.
+    std::vector<std::vector<int> > targetTransferIndices_;
+    //! For each model, the indices of the transfers that use the model as a source.
+    std::vector<std::vector<int> > sourceTransferIndices_;
+    //! Flags transfers whose targets hold the current data of their sources in this step, so a transfer with several targets is not repeated.
+    std::vector<bool> transferIsCurrent_;
+
+    //! If true, models whose incoming transfers did not change their inputs are not solved again.
+    bool skipUnchangedSolves_;
+    //! Flags models that have been solved at least once since the last call to reset().
+    std::vector<bool> solvedSinceReset_;
+    int numberOfSkippedSolves_;
   };
 
 }
@@ -2,14 +2,19 @@
 #include "Pike_BlackBoxModelEvaluator.hpp"
 #include "Pike_DataTransfer.hpp"
 #include "Teuchos_Comm.hpp"
+#include "Teuchos_CommHelpers.hpp"
 
 namespace pike {
 
-  BlockJacobi::BlockJacobi()
+  BlockJacobi::BlockJacobi() :
+    skipUnchangedSolves_(false),
+    numberOfSkippedSolves_(0)
   {
     this->getNonconstValidParameters()->set("Type","Block Jacobi");
     this->getNonconstValidParameters()->set("MPI Barrier Transfers",false,"If set to true, an MPI barrier will be called after all transfers are finished.");
     this->getNonconstValidParameters()->set("MPI Barrier Solves",false,"If set to true, an MPI barrier will be called after all model solves.");
+    this->getNonconstValidParameters()->set("Targeted MPI Barriers",false,"If set to true, the barriers requested by \"MPI Barrier Transfers\" and \"MPI Barrier Solves\" only synchronize the processes of each data transfer comm registered with registerTransferComm(), using nonblocking barriers, instead of all processes of the comm registered with registerComm().");
+    this->getNonconstValidParameters()->set("Skip Solves With Unchanged Inputs",false,"If set to true, a model is not solved if it was already solved since the last reset, is locally converged, and none of the data transfers targeting it report changed target data since its last solve.  The decision is reduced over the comm registered with registerComm(), which is required.");
   }
 
   void BlockJacobi::completeRegistration()
@@ -21,9 +26,34 @@ namespace pike {
 
     barrierSolves_ = this->getParameterList()->get<bool>("MPI Barrier Solves");
 
-    if (barrierTransfers_ || barrierSolves_)
+    skipUnchangedSolves_ = this->getParameterList()->get<bool>("Skip Solves With Unchanged Inputs");
+
+    targetedBarriers_ = this->getParameterList()->get<bool>("Targeted MPI Barriers");
+
+    if ( (barrierTransfers_ || barrierSolves_) && !targetedBarriers_)
       TEUCHOS_TEST_FOR_EXCEPTION(is_null(comm_), std::logic_error,
 				 "ERROR: An MPI Barrier of either the transfers or solves of a BlockJacobi solver was requested, but the teuchos comm was not ergistered with this object prior to completeRegistration being called.  Please register the comm or disable the mpi barriers.");
+
+    TEUCHOS_TEST_FOR_EXCEPTION(skipUnchangedSolves_ && is_null(comm_), std::logic_error,
+			       "ERROR: \"Skip Solves With Unchanged Inputs\" was requested for a BlockJacobi solver, but the teuchos comm was not registered with this object prior to completeRegistration being called.  The decision to skip a solve is reduced over this comm so that all processes of a model agree.");
+
+    modelTransfers_.clear();
+    modelTransfers_.resize(models_.size());
+    for (TransferIterator t = transfers_.begin(); t != transfers_.end(); ++t) {
+      const std::vector<std::string>& targetModels = (*t)->getTargetModelNames();
+      for (std::vector<std::string>::const_iterator n = targetModels.begin(); 
+	   n != targetModels.end(); ++n) {
+	std::unordered_map<std::string,int>::const_iterator i = modelIndexByName_.find(*n);
+	if (i != modelIndexByName_.end())
+	  modelTransfers_[i->second].push_back(*t);
+      }
+    }
+
+    solvedSinceReset_.assign(models_.size(),false);
+
+    allTransferIndices_.resize(transfers_.size());
+    for (std::size_t t = 0; t < transfers_.size(); ++t)
+      allTransferIndices_[t] = static_cast<int>(t);
   }
 
   void BlockJacobi::stepImplementation()
@@ -31,14 +61,47 @@ namespace pike {
     for (TransferIterator t = transfers_.begin(); t != transfers_.end(); ++t)
       (*t)->doTransfer(*this);
 
-    if (barrierTransfers_)
-      comm_->barrier();
+    if (barrierTransfers_) {
+      if (targetedBarriers_)
+	this->transferCommBarrier(allTransferIndices_);
+      else
+	comm_->barrier();
+    }
     
-    for (ModelIterator m = models_.begin(); m != models_.end(); ++m)
-      (*m)->solve();
+    // All inputs are known once the transfers are done, so the skip
+    // decisions of all models are reduced at once.  All processes
+    // must agree, otherwise a collective solve hangs.
+    std::vector<int> solveNeeded(models_.size(),1);
+    if (skipUnchangedSolves_ && (models_.size() > 0)) {
+      std::vector<int> localSolveNeeded(models_.size(),0);
+      for (std::size_t m = 0; m < models_.size(); ++m) {
+	localSolveNeeded[m] = (!solvedSinceReset_[m] || !models_[m]->isLocallyConverged()) ? 1 : 0;
+	for (TransferConstIterator t = modelTransfers_[m].begin(); t != modelTransfers_[m].end(); ++t)
+	  if ((*t)->changedTarget(models_[m]->name()))
+	    localSolveNeeded[m] = 1;
+      }
+      Teuchos::reduceAll(*comm_,Teuchos::REDUCE_MAX,static_cast<int>(models_.size()),
+			 &localSolveNeeded[0],&solveNeeded[0]);
+    }
+
+    for (std::size_t m = 0; m < models_.size(); ++m) {
+      if (solveNeeded[m] == 0)
+	++numberOfSkippedSolves_;
+      else {
+	models_[m]->solve();
+	solvedSinceReset_[m] = true;
+	if (skipUnchangedSolves_)
+	  for (TransferConstIterator t = modelTransfers_[m].begin(); t != modelTransfers_[m].end(); ++t)
+	    (*t)->targetSolved(models_[m]->name());
+      }
+    }
 
-    if (barrierSolves_)
-      comm_->barrier();
+    if (barrierSolves_) {
+      if (targetedBarriers_)
+	this->transferCommBarrier(allTransferIndices_);
+      else
+	comm_->barrier();
+    }
   }
 
   void BlockJacobi::registerComm(const Teuchos::RCP<const Teuchos::Comm<int> >& comm)
@@ -46,4 +109,16 @@ namespace pike {
     comm_ = comm;
   }
 
+  void BlockJacobi::reset()
+  {
+    this->pike::SolverDefaultBase::reset();
+    solvedSinceReset_.assign(models_.size(),false);
+    numberOfSkippedSolves_ = 0;
+  }
+
+  int BlockJacobi::getNumberOfSkippedSolves() const
+  {
+    return numberOfSkippedSolves_;
+  }
+
 }
@@ -3,6 +3,7 @@
 
 #include "Pike_Solver_DefaultBase.hpp"
 #include "Teuchos_RCP.hpp"
+#include <vector>
 
 namespace Teuchos { template<typename> class Comm; }
 
@@ -18,11 +19,28 @@ namespace pike {
 
     void registerComm(const Teuchos::RCP<const Teuchos::Comm<int> >& comm);
 
+    void reset();
+
+    //! Returns the number of model solves skipped because none of the model's inputs changed since reset() was last called.
+    int getNumberOfSkippedSolves() const;
+
   private:
     
     bool barrierTransfers_;
     bool barrierSolves_;
+    //! If true, barriers only synchronize the transfer comms.
+    bool targetedBarriers_;
     Teuchos::RCP<const Teuchos::Comm<int> > comm_;
+    //! Indices of all transfers, for targeted barriers.
+    std::vector<int> allTransferIndices_;
+
+    //! If true, models whose incoming transfers did not change their inputs are not solved again.
+    bool skipUnchangedSolves_;
+    //! For each model, the transfers that target the model.
+    std::vector<std::vector<Teuchos::RCP<pike::DataTransfer> > > modelTransfers_;
+    //! Flags models that have been solved at least once since the last call to reset().
+    std::vector<bool> solvedSinceReset_;
+    int numberOfSkippedSolves_;
 
   };
 
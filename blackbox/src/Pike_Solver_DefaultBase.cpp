@@ -5,6 +5,8 @@
 #include "Pike_DataTransfer.hpp"
 #include "Pike_SolverObserver.hpp"
 #include "Teuchos_Assert.hpp"
+#include "Teuchos_DefaultMpiComm.hpp"
+#include "mpi.h"
 #include <sstream>
 
 namespace pike {
@@ -14,13 +16,15 @@ namespace pike {
     status_(pike::UNCHECKED),
     registrationComplete_(false),
     isInitialized_(false),
-    isFinalized_(false)
+    isFinalized_(false),
+    completeStatusCheckInterval_(1)
   {
     validParameters_ = Teuchos::parameterList();
     validParameters_->set("Print Begin Solve Status",true, "If set to true the status tests will print current status at the beginning of the solve.");
     validParameters_->set("Print Step Status",true, "If set to true the status tests will print current status at the end of each step.");
     validParameters_->set("Print End Solve Status",true,"If set to true the status tests will print current status at the end of the solve.");
     validParameters_->set("Name","","A unique identifier chosen by the user for this solver. Used mainly for distinguishing nodes in a hierarchic problem.");
+    validParameters_->set("Complete Status Check Interval",1,"The status tests are checked with pike::COMPLETE every this many iterations and with pike::MINIMAL in between, so that costly tests only run periodically.  Critical tests such as the maximum number of iterations and local model failures are checked every iteration.  A pike::MINIMAL check that fails is repeated with pike::COMPLETE, so the final iterate always gets a complete check.");
     Teuchos::setupVerboseObjectSublist(validParameters_.get());
   }
 
@@ -41,7 +45,9 @@ namespace pike {
     TEUCHOS_TEST_FOR_EXCEPTION(registrationComplete_,
 			       std::logic_error,
 			       "Can NOT register model evaluators after registrationComplete() has been called!");
+    modelIndexByName_.insert(std::make_pair(me->name(),static_cast<int>(models_.size())));
     models_.push_back(me);
+    constModels_.push_back(me);
   }
   
   void SolverDefaultBase::registerDataTransfer(const Teuchos::RCP<pike::DataTransfer>& dt)
@@ -49,9 +55,24 @@ namespace pike {
     TEUCHOS_TEST_FOR_EXCEPTION(registrationComplete_,
 			       std::logic_error,
 			       "Can NOT register data transfers after registrationComplete() has been called!");
+    transferIndexByName_.insert(std::make_pair(dt->name(),static_cast<int>(transfers_.size())));
     transfers_.push_back(dt);
+    constTransfers_.push_back(dt);
   }
   
+  void SolverDefaultBase::registerTransferComm(const std::string& transferName,
+					       const Teuchos::RCP<const Teuchos::Comm<int> >& comm)
+  {
+    TEUCHOS_TEST_FOR_EXCEPTION(registrationComplete_,
+			       std::logic_error,
+			       "Can NOT register transfer comms after registrationComplete() has been called!");
+    TEUCHOS_TEST_FOR_EXCEPTION(nonnull(comm) && (dynamic_cast<const Teuchos::MpiComm<int>*>(comm.get()) == 0),
+			       std::logic_error,
+			       "Error: pike::SolverDefaultBase::registerTransferComm() - the comm for transfer \""
+			       << transferName << "\" must be a Teuchos::MpiComm!");
+    transferCommsByName_[transferName] = comm;
+  }
+
   void SolverDefaultBase::completeRegistration()
   {
     // Set the defaults so the user doesn't have to set the parameter list
@@ -60,44 +81,106 @@ namespace pike {
       this->setParameterList(defaultParameters);
     }
 
+    transferComms_.assign(transfers_.size(),Teuchos::null);
+    for (std::unordered_map<std::string,Teuchos::RCP<const Teuchos::Comm<int> > >::const_iterator c = transferCommsByName_.begin();
+	 c != transferCommsByName_.end(); ++c) {
+      bool found = false;
+      for (std::size_t t = 0; t < transfers_.size(); ++t) {
+	if (transfers_[t]->name() == c->first) {
+	  transferComms_[t] = c->second;
+	  found = true;
+	}
+      }
+      TEUCHOS_TEST_FOR_EXCEPTION(!found, std::logic_error,
+				 "Error: pike::SolverDefaultBase::completeRegistration() - a comm was registered for the transfer \""
+				 << c->first << "\", but no transfer with that name is registered with the solver!");
+    }
+
     registrationComplete_ = true;
   }
 
   Teuchos::RCP<const pike::BlackBoxModelEvaluator> SolverDefaultBase::getModelEvaluator(const std::string& meName) const
   {
-    for (ModelConstIterator m = models_.begin(); m != models_.end(); ++m)
-      if ((*m)->name() == meName)
-	return *m;
+    return models_[this->getModelEvaluatorIndex(meName)];
+  }
+
+  int SolverDefaultBase::getModelEvaluatorIndex(const std::string& meName) const
+  {
+    std::unordered_map<std::string,int>::const_iterator i = modelIndexByName_.find(meName);
+    if (i != modelIndexByName_.end())
+      return i->second;
 
     std::ostringstream os;
     for (ModelConstIterator m = models_.begin(); m != models_.end(); ++m)
        os << "  " << (*m)->name() << std::endl;
 
     TEUCHOS_TEST_FOR_EXCEPTION(true,std::logic_error,"pike::SolverDefaultBase::getModelEvaluator(): Failed to find the ModelEvaluator named \"" << meName << "\" in the solver.  Valid models are:\n" << os.str() << std::endl);
-    return Teuchos::null;
+    return -1;
+  }
+
+  Teuchos::RCP<const pike::BlackBoxModelEvaluator> SolverDefaultBase::getModelEvaluator(const int index) const
+  {
+    TEUCHOS_TEST_FOR_EXCEPTION( (index < 0) || (index >= static_cast<int>(models_.size())), std::logic_error,
+				"pike::SolverDefaultBase::getModelEvaluator(): The model index " << index
+				<< " is out of range [0," << models_.size() << ")!");
+    return models_[index];
   }
 
   const std::vector<Teuchos::RCP<const pike::BlackBoxModelEvaluator> > SolverDefaultBase::getModelEvaluators() const
   {
-    std::vector<Teuchos::RCP<const pike::BlackBoxModelEvaluator> > constModels(models_.size());
-    constModels.assign(models_.begin(),models_.end());
-    return constModels;
+    return constModels_;
+  }
+
+  Teuchos::ArrayView<const Teuchos::RCP<const pike::BlackBoxModelEvaluator> > 
+  SolverDefaultBase::getModelEvaluatorsView() const
+  {
+    return Teuchos::arrayViewFromVector(constModels_);
   }
 
   Teuchos::RCP<const pike::DataTransfer> SolverDefaultBase::getDataTransfer(const std::string& dtName) const
   {
-    for (TransferConstIterator t = transfers_.begin(); t != transfers_.end(); ++t)
-      if ((*t)->name() == dtName)
-	return *t;
+    return transfers_[this->getDataTransferIndex(dtName)];
+  }
+
+  int SolverDefaultBase::getDataTransferIndex(const std::string& dtName) const
+  {
+    std::unordered_map<std::string,int>::const_iterator i = transferIndexByName_.find(dtName);
+    TEUCHOS_TEST_FOR_EXCEPTION(i == transferIndexByName_.end(),std::logic_error,"Failed to find the DataTransfer named \"" << dtName << "\" in the solver.");
+    return i->second;
+  }
 
-    TEUCHOS_TEST_FOR_EXCEPTION(true,std::logic_error,"Failed to find the DataTransfer named \"" << dtName << "\" in the solver.");
-    return Teuchos::null;
+  Teuchos::RCP<const pike::DataTransfer> SolverDefaultBase::getDataTransfer(const int index) const
+  {
+    TEUCHOS_TEST_FOR_EXCEPTION( (index < 0) || (index >= static_cast<int>(transfers_.size())), std::logic_error,
+				"pike::SolverDefaultBase::getDataTransfer(): The transfer index " << index
+				<< " is out of range [0," << transfers_.size() << ")!");
+    return transfers_[index];
   }
 
   const std::vector<Teuchos::RCP<const pike::DataTransfer> > SolverDefaultBase::getDataTransfers() const
-  { std::vector<Teuchos::RCP<const pike::DataTransfer> > constTransfers;
-    constTransfers.assign(transfers_.begin(),transfers_.end());
-    return constTransfers;
+  {
+    return constTransfers_;
+  }
+
+  Teuchos::ArrayView<const Teuchos::RCP<const pike::DataTransfer> > 
+  SolverDefaultBase::getDataTransfersView() const
+  {
+    return Teuchos::arrayViewFromVector(constTransfers_);
+  }
+
+  void SolverDefaultBase::transferCommBarrier(const std::vector<int>& transferIndices) const
+  {
+    std::vector<MPI_Request> requests;
+    requests.reserve(transferIndices.size());
+    for (std::vector<int>::const_iterator t = transferIndices.begin(); t != transferIndices.end(); ++t) {
+      if (nonnull(transferComms_[*t])) {
+	const Teuchos::MpiComm<int>* mpiComm = static_cast<const Teuchos::MpiComm<int>*>(transferComms_[*t].get());
+	requests.push_back(MPI_REQUEST_NULL);
+	MPI_Ibarrier((*mpiComm->getRawMpiComm())(),&requests.back());
+      }
+    }
+    if (requests.size() > 0)
+      MPI_Waitall(static_cast<int>(requests.size()),&requests[0],MPI_STATUSES_IGNORE);
   }
 
   pike::SolveStatus SolverDefaultBase::step()
@@ -108,7 +191,15 @@ namespace pike {
     this->stepImplementation();
     ++numberOfIterations_;
 
-    status_ = statusTests_->checkStatus(*this);
+    const pike::CheckType checkType =
+      ((numberOfIterations_ % completeStatusCheckInterval_) == 0) ? pike::COMPLETE : pike::MINIMAL;
+    status_ = statusTests_->checkStatus(*this,checkType);
+
+    // A failure such as the maximum number of iterations ends the
+    // solve.  Give the tests skipped by the minimal check a chance to
+    // see the final iterate before failing.
+    if ( (checkType == pike::MINIMAL) && (status_ == pike::FAILED) )
+      status_ = statusTests_->checkStatus(*this,pike::COMPLETE);
     
     if (printStepStatus_) {
       Teuchos::RCP<Teuchos::FancyOStream> os = this->getOStream();
@@ -215,6 +306,9 @@ namespace pike {
     printStepStatus_ = paramList->get<bool>("Print Step Status");
     printEndSolveStatus_ = paramList->get<bool>("Print End Solve Status");
     name_ = paramList->get<std::string>("Name");
+    completeStatusCheckInterval_ = paramList->get<int>("Complete Status Check Interval");
+    TEUCHOS_TEST_FOR_EXCEPTION(completeStatusCheckInterval_ < 1, std::logic_error,
+			       "Error: pike::SolverDefaultBase::setParameterList() - The \"Complete Status Check Interval\" must be positive!");
     this->setMyParamList(paramList);
   }
   
@@ -4,6 +4,7 @@
 #include "Pike_Solver.hpp"
 #include "Teuchos_RCP.hpp"
 #include "Teuchos_ParameterListAcceptorDefaultBase.hpp"
+#include <unordered_map>
 
 namespace Teuchos {
   class ParameterList;
@@ -26,18 +27,43 @@ namespace pike {
 
     virtual void registerDataTransfer(const Teuchos::RCP<pike::DataTransfer>& dt);
 
+    /** \brief Registers the subcommunicator of a data transfer, e.g. from pike::MultiphysicsDistributor::getTransferComm().
+
+	Used by solvers that support "Targeted MPI Barriers" to only
+	synchronize the processes involved in a transfer.  A null comm
+	means that the transfer is not active on this process.  Must
+	be called before completeRegistration(), and the transfer
+	must be registered by then.
+    */
+    virtual void registerTransferComm(const std::string& transferName,
+				      const Teuchos::RCP<const Teuchos::Comm<int> >& comm);
+
     virtual void completeRegistration();
 
     virtual Teuchos::RCP<const pike::BlackBoxModelEvaluator> 
     getModelEvaluator(const std::string& name) const;
 
+    virtual int getModelEvaluatorIndex(const std::string& name) const;
+
+    virtual Teuchos::RCP<const pike::BlackBoxModelEvaluator> 
+    getModelEvaluator(const int index) const;
+
     virtual const std::vector<Teuchos::RCP<const pike::BlackBoxModelEvaluator> > getModelEvaluators() const;
 
+    virtual Teuchos::ArrayView<const Teuchos::RCP<const pike::BlackBoxModelEvaluator> > getModelEvaluatorsView() const;
+
     virtual Teuchos::RCP<const pike::DataTransfer> 
     getDataTransfer(const std::string& name) const;
 
+    virtual int getDataTransferIndex(const std::string& name) const;
+
+    virtual Teuchos::RCP<const pike::DataTransfer> 
+    getDataTransfer(const int index) const;
+
     virtual const std::vector<Teuchos::RCP<const pike::DataTransfer> > getDataTransfers() const;
 
+    virtual Teuchos::ArrayView<const Teuchos::RCP<const pike::DataTransfer> > getDataTransfersView() const;
+
     virtual void stepImplementation() = 0;
 
     virtual pike::SolveStatus step();
@@ -82,6 +108,15 @@ namespace pike {
     typedef std::vector<Teuchos::RCP<pike::DataTransfer> >::iterator TransferIterator;
     typedef std::vector<Teuchos::RCP<pike::DataTransfer> >::const_iterator TransferConstIterator;
 
+    /** \brief Synchronizes the processes of the comms registered for the given transfers.
+
+	Posts a nonblocking barrier (MPI_Ibarrier) on each comm that
+	is active on this process and waits for all of them, so
+	processes that do not share a transfer never wait on each
+	other.
+    */
+    void transferCommBarrier(const std::vector<int>& transferIndices) const;
+
     int numberOfIterations_;
     Teuchos::RCP<Teuchos::ParameterList> validParameters_;
     Teuchos::RCP<pike::StatusTest> statusTests_;
@@ -89,6 +124,18 @@ namespace pike {
     pike::SolveStatus status_;
     std::vector<Teuchos::RCP<pike::BlackBoxModelEvaluator> > models_;
     std::vector<Teuchos::RCP<pike::DataTransfer> > transfers_;
+    //! Const copies of models_ so that views can be returned without allocating.
+    std::vector<Teuchos::RCP<const pike::BlackBoxModelEvaluator> > constModels_;
+    //! Const copies of transfers_ so that views can be returned without allocating.
+    std::vector<Teuchos::RCP<const pike::DataTransfer> > constTransfers_;
+    //! Model name to index in models_.  If names are duplicated, the first registered model is found.
+    std::unordered_map<std::string,int> modelIndexByName_;
+    //! Transfer name to index in transfers_.  If names are duplicated, the first registered transfer is found.
+    std::unordered_map<std::string,int> transferIndexByName_;
+    //! Transfer comms registered with registerTransferComm() by transfer name.
+    std::unordered_map<std::string,Teuchos::RCP<const Teuchos::Comm<int> > > transferCommsByName_;
+    //! The transfer comm of each entry in transfers_, set in completeRegistration().  Null if none was registered or the transfer is not active on this process.
+    std::vector<Teuchos::RCP<const Teuchos::Comm<int> > > transferComms_;
     bool registrationComplete_;
     std::string name_;
 
@@ -99,6 +146,9 @@ namespace pike {
     bool printBeginSolveStatus_;
     bool printStepStatus_;
     bool printEndSolveStatus_;
+
+    //! Iterations between pike::COMPLETE status checks.  Checks in between are pike::MINIMAL.
+    int completeStatusCheckInterval_;
   };
 
 }
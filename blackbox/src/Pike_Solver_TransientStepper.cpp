@@ -2,7 +2,9 @@
 #include "Teuchos_ParameterList.hpp"
 #include "Teuchos_VerboseObjectParameterListHelpers.hpp"
 #include "Teuchos_Comm.hpp"
+#include "Teuchos_DefaultMpiComm.hpp"
 #include "Pike_BlackBoxModelEvaluator.hpp"
+#include <limits>
 
 namespace pike {
 
@@ -26,7 +28,10 @@ namespace pike {
     totalNumFailedSteps_(0),
     numConsecutiveFailedTimeSteps_(0),
     numConsecutiveConvergedTimeSteps_(0),
-    registrationComplete_(false)
+    registrationComplete_(false),
+    distributedStepSizeNegotiation_(false),
+    stepNegotiationRequest_(MPI_REQUEST_NULL),
+    haveReducedStepSizeConstraints_(false)
   {
     validParameters_ = Teuchos::parameterList("pike::TransientStepper::validParameters");
 
@@ -44,12 +49,11 @@ namespace pike {
     this->getNonconstValidParameters()->set("Print Time Step Summary",true,"Prints time step summary information to ostream.");
     this->getNonconstValidParameters()->set("Print Time Step Details",true,"Prints details of time step to ostream.");
     this->getNonconstValidParameters()->set("Number Converged Time Steps for Growth",3,"Delays growing a time step size towards the maximum until a specified number of consecutive time steps have converged.  This helps prevent oscillation between cutting and increasing on alternate steps.");
+    this->getNonconstValidParameters()->set("Distributed Step Size Negotiation",false,"Reduces the step size constraints of the transient models and the convergence of the inner solve over the comm registered with the solver so that all processes take, accept and cut the same steps.  Required if the transient models do not exist on all processes.  One nonblocking reduction follows each inner solve.");
 
     Teuchos::setupVerboseObjectSublist(validParameters_.get());
   }
   
-  TransientStepper::~TransientStepper() {}
-
   void TransientStepper::setSolver(const Teuchos::RCP<pike::Solver>& solver)
   {
     solver_ = solver;
@@ -59,6 +63,7 @@ namespace pike {
   {
     TEUCHOS_ASSERT(!registrationComplete_);
     TEUCHOS_ASSERT(nonnull(solver_));
+    comm_ = comm;
     solver_->registerComm(comm);
   }
 
@@ -91,6 +96,12 @@ namespace pike {
       this->setParameterList(defaultParameters);
     }
 
+    distributedStepSizeNegotiation_ = this->getMyParamList()->get<bool>("Distributed Step Size Negotiation");
+    TEUCHOS_TEST_FOR_EXCEPTION(distributedStepSizeNegotiation_ && 
+			       (dynamic_cast<const Teuchos::MpiComm<int>*>(comm_.get()) == 0),
+			       std::logic_error,
+			       "Error in pike::TransientStepper::completeRegistration(): \"Distributed Step Size Negotiation\" requires a Teuchos::MpiComm to be registered with registerComm()!");
+
     solver_->completeRegistration();
 
     registrationComplete_ = true;
@@ -100,17 +111,38 @@ namespace pike {
   TransientStepper::getModelEvaluator(const std::string& in_name) const
   { return solver_->getModelEvaluator(in_name); }
 
+  int TransientStepper::getModelEvaluatorIndex(const std::string& in_name) const
+  { return solver_->getModelEvaluatorIndex(in_name); }
+
+  Teuchos::RCP<const pike::BlackBoxModelEvaluator> 
+  TransientStepper::getModelEvaluator(const int index) const
+  { return solver_->getModelEvaluator(index); }
+
   const std::vector<Teuchos::RCP<const pike::BlackBoxModelEvaluator> > 
   TransientStepper::getModelEvaluators() const
   { return solver_->getModelEvaluators(); }
 
+  Teuchos::ArrayView<const Teuchos::RCP<const pike::BlackBoxModelEvaluator> > 
+  TransientStepper::getModelEvaluatorsView() const
+  { return solver_->getModelEvaluatorsView(); }
+
   Teuchos::RCP<const pike::DataTransfer> TransientStepper::getDataTransfer(const std::string& in_name) const
   { return solver_->getDataTransfer(in_name); }
 
+  int TransientStepper::getDataTransferIndex(const std::string& in_name) const
+  { return solver_->getDataTransferIndex(in_name); }
+
+  Teuchos::RCP<const pike::DataTransfer> TransientStepper::getDataTransfer(const int index) const
+  { return solver_->getDataTransfer(index); }
+
   const std::vector<Teuchos::RCP<const pike::DataTransfer> > 
   TransientStepper::getDataTransfers() const
   {return solver_->getDataTransfers(); }
 
+  Teuchos::ArrayView<const Teuchos::RCP<const pike::DataTransfer> > 
+  TransientStepper::getDataTransfersView() const
+  { return solver_->getDataTransfersView(); }
+
   void TransientStepper::initialize()
   {
     solver_->initialize();
@@ -172,23 +204,44 @@ namespace pike {
       // Limit time step based on application numerical method
       // requirements
       double modelRequestedStepSize = maxStepSize_;
-      for (std::vector<Teuchos::RCP<pike::BlackBoxModelEvaluator> >::const_iterator m = transientModels_.begin();
-	   m != transientModels_.end(); ++m) {
-	double modelMaxStepSize = (*m)->getMaxTimeStepSize();
-	double modelDesiredStepSize = (*m)->getDesiredTimeStepSize();
+      if (distributedStepSizeNegotiation_) {
+	// The constraints are reduced along with the status of the
+	// previous solve.  Only the first step reduces them on its own.
+	if (!haveReducedStepSizeConstraints_) {
+	  this->startStepNegotiation(pike::CONVERGED);
+	  this->finishStepNegotiation();
+	}
+	modelRequestedStepSize = globalStepNegotiation_[0];
+	const double modelMaxStepSize = globalStepNegotiation_[1];
 
-	// Do not allow simulations that violate application max step
-	// size, but allow for violations of desired step size.
+	// All processes see the same reduced values, so they all throw
+	// together.
 	TEUCHOS_TEST_FOR_EXCEPTION(modelMaxStepSize < minStepSize_, std::runtime_error,
-				   "Error the application \"" << (*m)->name() 
-				   << "\" requested a max step size of " 
+				   "Error an application requested a max step size of " 
 				   << modelMaxStepSize 
 				   << " but this is less than the minimum step size of " 
 				   << minStepSize_ 
 				   << " requested by the user.  Terminating run!");
-
-	modelRequestedStepSize = std::min(modelRequestedStepSize, modelMaxStepSize);
-	modelRequestedStepSize = std::min(modelRequestedStepSize, modelDesiredStepSize);
+      }
+      else {
+	for (std::vector<Teuchos::RCP<pike::BlackBoxModelEvaluator> >::const_iterator m = transientModels_.begin();
+	     m != transientModels_.end(); ++m) {
+	  double modelMaxStepSize = (*m)->getMaxTimeStepSize();
+	  double modelDesiredStepSize = (*m)->getDesiredTimeStepSize();
+
+	  // Do not allow simulations that violate application max step
+	  // size, but allow for violations of desired step size.
+	  TEUCHOS_TEST_FOR_EXCEPTION(modelMaxStepSize < minStepSize_, std::runtime_error,
+				     "Error the application \"" << (*m)->name() 
+				     << "\" requested a max step size of " 
+				     << modelMaxStepSize 
+				     << " but this is less than the minimum step size of " 
+				     << minStepSize_ 
+				     << " requested by the user.  Terminating run!");
+
+	  modelRequestedStepSize = std::min(modelRequestedStepSize, modelMaxStepSize);
+	  modelRequestedStepSize = std::min(modelRequestedStepSize, modelDesiredStepSize);
+	}
       }
       currentStepSize_ = std::min(currentStepSize_, modelRequestedStepSize);
 
@@ -272,7 +325,14 @@ namespace pike {
       }
       os.pushTab(defaultIndentation);
       pike::SolveStatus innerSolverStatus = solver_->solve();
+
+      // All processes must agree on the outcome of the step, so the
+      // local status is reduced with the next step's constraints.
+      if (distributedStepSizeNegotiation_)
+	this->startStepNegotiation(innerSolverStatus);
       os.popTab();
+      if (distributedStepSizeNegotiation_)
+	innerSolverStatus = this->finishStepNegotiation();
 
       // Check for time step status change
       if (innerSolverStatus == CONVERGED) {
@@ -375,7 +435,9 @@ namespace pike {
   }
 
   void TransientStepper::finalize()
-  { solver_->finalize(); }
+  {
+    solver_->finalize();
+  }
   
   void TransientStepper::reset()
   {
@@ -458,4 +520,35 @@ namespace pike {
   { return validParameters_; }
 
 
+  void TransientStepper::startStepNegotiation(const pike::SolveStatus innerSolverStatus)
+  {
+    localStepNegotiation_[0] = maxStepSize_;
+    localStepNegotiation_[1] = std::numeric_limits<double>::max();
+    for (std::vector<Teuchos::RCP<pike::BlackBoxModelEvaluator> >::const_iterator m = transientModels_.begin();
+	 m != transientModels_.end(); ++m) {
+      const double modelMaxStepSize = (*m)->getMaxTimeStepSize();
+      const double modelDesiredStepSize = (*m)->getDesiredTimeStepSize();
+      localStepNegotiation_[0] = std::min(localStepNegotiation_[0], modelMaxStepSize);
+      localStepNegotiation_[0] = std::min(localStepNegotiation_[0], modelDesiredStepSize);
+      localStepNegotiation_[1] = std::min(localStepNegotiation_[1], modelMaxStepSize);
+    }
+    localStepNegotiation_[2] = (innerSolverStatus == pike::CONVERGED) ? 1.0 : 0.0;
+
+    const Teuchos::MpiComm<int>* mpiComm = dynamic_cast<const Teuchos::MpiComm<int>*>(comm_.get());
+    MPI_Iallreduce(localStepNegotiation_,
+		   globalStepNegotiation_,
+		   3,
+		   MPI_DOUBLE,
+		   MPI_MIN,
+		   (*mpiComm->getRawMpiComm())(),
+		   &stepNegotiationRequest_);
+  }
+
+  pike::SolveStatus TransientStepper::finishStepNegotiation()
+  {
+    MPI_Wait(&stepNegotiationRequest_,MPI_STATUS_IGNORE);
+    haveReducedStepSizeConstraints_ = true;
+    return (globalStepNegotiation_[2] == 1.0) ? pike::CONVERGED : pike::FAILED;
+  }
+
 }
@@ -5,17 +5,36 @@
 #include "Teuchos_Array.hpp"
 #include "Teuchos_RCP.hpp"
 #include "Teuchos_ParameterListAcceptorDefaultBase.hpp"
+#include "mpi.h"
 #include <list>
 
 namespace pike {
 
+  /** \brief Time stepper that wraps an inner solver for each time step.
+
+      The step size is limited by the max and desired step sizes of
+      the transient model evaluators.  By default only the models
+      registered on this process are queried.  If the "Distributed
+      Step Size Negotiation" parameter is set, the constraints are
+      reduced over the comm passed to registerComm() so that all
+      processes take the same step even if each process only holds a
+      subset of the transient models.  The same reduction carries the
+      convergence of the inner solve, so that all processes accept or
+      cut a step together even if the inner solver does not reduce
+      its status.  Each solve is followed by a single nonblocking
+      allreduce of the convergence flag and the constraints of the
+      next step.  It is started as soon as the inner solve returns
+      and must complete before the step is accepted, so it can not
+      overlap acceptTimeStep().  The constraints are therefore those
+      reported after the solve and before the step is accepted.  Only
+      the first step needs a reduction of its own.
+   */
   class TransientStepper : public pike::Solver,
                            public Teuchos::ParameterListAcceptorDefaultBase {
 
   public:
 
     TransientStepper();
-    ~TransientStepper();
 
     //! Must be called before any other calls to this object.
     void setSolver(const Teuchos::RCP<pike::Solver>& solver);
@@ -26,9 +45,15 @@ namespace pike {
     void registerDataTransfer(const Teuchos::RCP<pike::DataTransfer>& dt);
     void completeRegistration();
     Teuchos::RCP<const pike::BlackBoxModelEvaluator> getModelEvaluator(const std::string& name) const;
+    int getModelEvaluatorIndex(const std::string& name) const;
+    Teuchos::RCP<const pike::BlackBoxModelEvaluator> getModelEvaluator(const int index) const;
     const std::vector<Teuchos::RCP<const pike::BlackBoxModelEvaluator> > getModelEvaluators() const;
+    Teuchos::ArrayView<const Teuchos::RCP<const pike::BlackBoxModelEvaluator> > getModelEvaluatorsView() const;
     Teuchos::RCP<const pike::DataTransfer> getDataTransfer(const std::string& name) const;
+    int getDataTransferIndex(const std::string& name) const;
+    Teuchos::RCP<const pike::DataTransfer> getDataTransfer(const int index) const;
     const std::vector<Teuchos::RCP<const pike::DataTransfer> > getDataTransfers() const;
+    Teuchos::ArrayView<const Teuchos::RCP<const pike::DataTransfer> > getDataTransfersView() const;
     pike::SolveStatus step();
     void initialize();
     pike::SolveStatus solve();
@@ -49,6 +74,12 @@ namespace pike {
 
   private:
 
+    //! Starts the nonblocking reduction over comm_ of the local status of the inner solve and the step size constraints.
+    void startStepNegotiation(const pike::SolveStatus innerSolverStatus);
+
+    //! Completes the reduction and returns pike::CONVERGED if the inner solve converged on all processes, pike::FAILED otherwise.
+    pike::SolveStatus finishStepNegotiation();
+
     int currentTimeStep_;
     int maxTimeSteps_;
     double beginTime_;
@@ -77,6 +108,15 @@ namespace pike {
     Teuchos::RCP<pike::Solver> solver_;
     Teuchos::RCP<Teuchos::ParameterList> validParameters_;
     bool registrationComplete_;
+
+    Teuchos::RCP<const Teuchos::Comm<int> > comm_;
+    bool distributedStepSizeNegotiation_;
+    //! Packed [requested step size, max step size, 1 if the inner solve converged else 0], reduced with MPI_MIN.
+    double localStepNegotiation_[3];
+    double globalStepNegotiation_[3];
+    MPI_Request stepNegotiationRequest_;
+    //! True once globalStepNegotiation_ holds reduced constraints.
+    bool haveReducedStepSizeConstraints_;
   };
 
 }
@@ -0,0 +1,310 @@
+#include "Pike_StaticPartitioner.hpp"
+#include "Teuchos_Assert.hpp"
+#include <algorithm>
+#include <cmath>
+#include <ostream>
+
+namespace pike {
+
+  StaticPartitioner::StaticPartitioner(const Teuchos::RCP<const pike::MultiphysicsDistributor>& distributor) :
+    distributor_(distributor),
+    latency_(0.0),
+    inverseBandwidth_(0.0),
+    interNodeFactor_(1.0),
+    partitioned_(false),
+    solverType_(BLOCK_JACOBI),
+    totalProcesses_(0),
+    predictedIterationTime_(0.0)
+  {
+    TEUCHOS_ASSERT(nonnull(distributor_));
+  }
+
+  void StaticPartitioner::setStrongScalingCurve(const pike::MultiphysicsDistributor::ApplicationIndex index,
+						const std::vector<int>& numProcesses,
+						const std::vector<double>& times)
+  {
+    TEUCHOS_ASSERT(index < distributor_->getNumberOfApplications());
+    TEUCHOS_TEST_FOR_EXCEPTION( (numProcesses.size() != times.size()) || (numProcesses.size() == 0),
+				std::logic_error,
+				"Error: pike::StaticPartitioner::setStrongScalingCurve() - the curve for application \""
+				<< distributor_->getApplicationName(index) << "\" needs the same, nonzero number of process counts and times!");
+    for (std::size_t i = 0; i < numProcesses.size(); ++i) {
+      TEUCHOS_TEST_FOR_EXCEPTION( (numProcesses[i] < 1) || (times[i] <= 0.0) ||
+				  ((i > 0) && (numProcesses[i] <= numProcesses[i-1])),
+				  std::logic_error,
+				  "Error: pike::StaticPartitioner::setStrongScalingCurve() - the curve for application \""
+				  << distributor_->getApplicationName(index)
+				  << "\" must have strictly increasing, positive process counts and positive times!");
+    }
+
+    if (curves_.size() < distributor_->getNumberOfApplications())
+      curves_.resize(distributor_->getNumberOfApplications());
+    curves_[index].numProcesses = numProcesses;
+    curves_[index].times = times;
+  }
+
+  void StaticPartitioner::setTransferCostModel(const double latency, const double inverseBandwidth, const double interNodeFactor)
+  {
+    TEUCHOS_TEST_FOR_EXCEPTION( (latency < 0.0) || (inverseBandwidth < 0.0) || (interNodeFactor <= 0.0),
+				std::logic_error,
+				"Error: pike::StaticPartitioner::setTransferCostModel() - the latency and inverse bandwidth must be non-negative and the inter-node factor positive!");
+    latency_ = latency;
+    inverseBandwidth_ = inverseBandwidth;
+    interNodeFactor_ = interNodeFactor;
+  }
+
+  double StaticPartitioner::getPredictedSolveTime(const pike::MultiphysicsDistributor::ApplicationIndex index,
+						  const int numProcesses) const
+  {
+    TEUCHOS_TEST_FOR_EXCEPTION( (index >= curves_.size()) || (curves_[index].numProcesses.size() == 0),
+				std::logic_error,
+				"Error: pike::StaticPartitioner - the application \""
+				<< distributor_->getApplicationName(index) << "\" has no strong scaling curve!");
+    TEUCHOS_ASSERT(numProcesses > 0);
+
+    const std::vector<int>& p = curves_[index].numProcesses;
+    const std::vector<double>& t = curves_[index].times;
+
+    // Perfect scaling below the curve, no speedup beyond it
+    if (numProcesses <= p.front())
+      return t.front() * static_cast<double>(p.front()) / static_cast<double>(numProcesses);
+    if (numProcesses >= p.back())
+      return t.back();
+
+    // Log-log interpolation
+    const std::size_t i = std::upper_bound(p.begin(),p.end(),numProcesses) - p.begin();
+    const double x0 = std::log(static_cast<double>(p[i-1]));
+    const double x1 = std::log(static_cast<double>(p[i]));
+    const double y0 = std::log(t[i-1]);
+    const double y1 = std::log(t[i]);
+    const double x = std::log(static_cast<double>(numProcesses));
+    return std::exp(y0 + (y1 - y0) * (x - x0) / (x1 - x0));
+  }
+
+  double StaticPartitioner::interNodeFraction(const int beginA, const int countA, const int beginB, const int countB) const
+  {
+    const int ppn = distributor_->getProcessesPerNode();
+    if (ppn < 1)
+      return 0.0;
+
+    // Only nodes that hold ranks of both ranges have pairs that stay
+    // on the node
+    double sameNodePairs = 0.0;
+    const int firstNode = std::max(beginA,beginB) / ppn;
+    const int lastNode = (std::min(beginA+countA,beginB+countB) - 1) / ppn;
+    for (int n = firstNode; n <= lastNode; ++n) {
+      const int a = std::min(beginA+countA,(n+1)*ppn) - std::max(beginA,n*ppn);
+      const int b = std::min(beginB+countB,(n+1)*ppn) - std::max(beginB,n*ppn);
+      if ( (a > 0) && (b > 0) )
+	sameNodePairs += static_cast<double>(a) * static_cast<double>(b);
+    }
+    return 1.0 - sameNodePairs / (static_cast<double>(countA) * static_cast<double>(countB));
+  }
+
+  double StaticPartitioner::getPredictedTransferTime(const pike::MultiphysicsDistributor::TransferIndex index,
+						     const std::vector<int>& counts,
+						     const std::vector<int>& beginRanks) const
+  {
+    const double volumeTime = distributor_->getTransferVolume(index) * inverseBandwidth_;
+    const std::vector<pike::MultiphysicsDistributor::ApplicationIndex>& apps = distributor_->getTransferApplications(index);
+
+    // Transfers registered by ranks do not depend on the partition
+    if (apps.size() == 0)
+      return latency_ + volumeTime;
+
+    TEUCHOS_ASSERT( (counts.size() == distributor_->getNumberOfApplications()) && (beginRanks.size() == counts.size()) );
+
+    int minCount = counts[apps[0]];
+    double fraction = 0.0;
+    int numPairs = 0;
+    for (std::size_t i = 0; i < apps.size(); ++i) {
+      minCount = std::min(minCount,counts[apps[i]]);
+      for (std::size_t j = i+1; j < apps.size(); ++j) {
+	fraction += this->interNodeFraction(beginRanks[apps[i]],counts[apps[i]],beginRanks[apps[j]],counts[apps[j]]);
+	++numPairs;
+      }
+    }
+    if (numPairs > 0)
+      fraction /= static_cast<double>(numPairs);
+
+    return latency_ + volumeTime / static_cast<double>(minCount) * (1.0 + (interNodeFactor_ - 1.0) * fraction);
+  }
+
+  double StaticPartitioner::getPredictedTransferTime(const pike::MultiphysicsDistributor::TransferIndex index) const
+  {
+    TEUCHOS_TEST_FOR_EXCEPTION(!partitioned_, std::logic_error,
+			       "Error: pike::StaticPartitioner::getPredictedTransferTime() - partition() must be called first!");
+    return this->getPredictedTransferTime(index,counts_,beginRanks_);
+  }
+
+  double StaticPartitioner::totalTransferTime(const std::vector<int>& counts, const std::vector<int>& beginRanks) const
+  {
+    double time = 0.0;
+    for (std::size_t t = 0; t < distributor_->getNumberOfTransfers(); ++t)
+      time += this->getPredictedTransferTime(t,counts,beginRanks);
+    return time;
+  }
+
+  double StaticPartitioner::predictIterationTime(const std::vector<int>& counts, const SolverType type,
+						 std::vector<int>& beginRanks, double& totalSolveTime) const
+  {
+    double solveTime = 0.0;
+    totalSolveTime = 0.0;
+    int beginRank = 0;
+    for (std::size_t a = 0; a < counts.size(); ++a) {
+      const double time = this->getPredictedSolveTime(a,counts[a]);
+      totalSolveTime += time;
+      if (type == BLOCK_JACOBI) {
+	solveTime = std::max(solveTime,time);
+	beginRanks[a] = beginRank;
+	beginRank += counts[a];
+      }
+      else
+	beginRanks[a] = 0;
+    }
+    if (type == BLOCK_GAUSS_SEIDEL)
+      solveTime = totalSolveTime;
+
+    return solveTime + this->totalTransferTime(counts,beginRanks);
+  }
+
+  void StaticPartitioner::partition(const int totalProcesses, const SolverType type)
+  {
+    const std::size_t numApps = distributor_->getNumberOfApplications();
+    TEUCHOS_TEST_FOR_EXCEPTION(numApps == 0, std::logic_error,
+			       "Error: pike::StaticPartitioner::partition() - no applications are registered with the distributor!");
+    TEUCHOS_TEST_FOR_EXCEPTION( (type == BLOCK_JACOBI) && (totalProcesses < static_cast<int>(numApps)),
+				std::logic_error,
+				"Error: pike::StaticPartitioner::partition() - " << numApps << " applications can not run concurrently on "
+				<< totalProcesses << " processes!");
+    TEUCHOS_TEST_FOR_EXCEPTION(totalProcesses < 1, std::logic_error,
+			       "Error: pike::StaticPartitioner::partition() - the number of processes must be positive!");
+
+    counts_.assign(numApps,1);
+    beginRanks_.assign(numApps,0);
+    double totalSolveTime = 0.0;
+
+    if (type == BLOCK_JACOBI) {
+      predictedIterationTime_ = this->predictIterationTime(counts_,type,beginRanks_,totalSolveTime);
+      std::vector<int> beginRanks(numApps);
+      int used = static_cast<int>(numApps);
+      while (used < totalProcesses) {
+	std::size_t slowest = 0;
+	for (std::size_t a = 1; a < numApps; ++a)
+	  if (this->getPredictedSolveTime(a,counts_[a]) > this->getPredictedSolveTime(slowest,counts_[slowest]))
+	    slowest = a;
+
+	// The application that lowers the iteration time the most,
+	// otherwise the bottleneck if its solve speeds up
+	int best = -1;
+	double bestTime = predictedIterationTime_;
+	double bestSolveTime = totalSolveTime;
+	for (std::size_t a = 0; a < numApps; ++a) {
+	  double solveTime = 0.0;
+	  ++counts_[a];
+	  const double time = this->predictIterationTime(counts_,type,beginRanks,solveTime);
+	  --counts_[a];
+	  const bool lowersTime = (time < bestTime);
+	  const bool speedsUpBottleneck = (best < 0) && (a == slowest) && (time <= predictedIterationTime_) && 
+	    (this->getPredictedSolveTime(a,counts_[a]+1) < this->getPredictedSolveTime(a,counts_[a]));
+	  if (lowersTime || speedsUpBottleneck) {
+	    best = static_cast<int>(a);
+	    bestTime = time;
+	    bestSolveTime = solveTime;
+	  }
+	}
+	if (best < 0)
+	  break;
+	++counts_[best];
+	predictedIterationTime_ = bestTime;
+	totalSolveTime = bestSolveTime;
+	++used;
+      }
+      predictedIterationTime_ = this->predictIterationTime(counts_,type,beginRanks_,totalSolveTime);
+    }
+    else {
+      // Start from the fastest count of each application
+      for (std::size_t a = 0; a < numApps; ++a) {
+	double best = this->getPredictedSolveTime(a,1);
+	for (int p = 2; p <= totalProcesses; ++p) {
+	  const double time = this->getPredictedSolveTime(a,p);
+	  if (time < best) {
+	    best = time;
+	    counts_[a] = p;
+	  }
+	}
+      }
+
+      // Trade solve time against transfer time one application at a
+      // time.  Every change lowers the iteration time, so this ends.
+      predictedIterationTime_ = this->predictIterationTime(counts_,type,beginRanks_,totalSolveTime);
+      bool changed = true;
+      while (changed) {
+	changed = false;
+	for (std::size_t a = 0; a < numApps; ++a) {
+	  const int current = counts_[a];
+	  int best = current;
+	  for (int p = 1; p <= totalProcesses; ++p) {
+	    counts_[a] = p;
+	    const double time = this->predictIterationTime(counts_,type,beginRanks_,totalSolveTime);
+	    if (time < predictedIterationTime_) {
+	      predictedIterationTime_ = time;
+	      best = p;
+	    }
+	  }
+	  counts_[a] = best;
+	  if (best != current)
+	    changed = true;
+	}
+      }
+      predictedIterationTime_ = this->predictIterationTime(counts_,type,beginRanks_,totalSolveTime);
+    }
+
+    solverType_ = type;
+    totalProcesses_ = totalProcesses;
+    partitioned_ = true;
+  }
+
+  const std::vector<int>& StaticPartitioner::getProcessCounts() const
+  { return counts_; }
+
+  int StaticPartitioner::getBeginRank(const pike::MultiphysicsDistributor::ApplicationIndex index) const
+  {
+    TEUCHOS_ASSERT(partitioned_);
+    TEUCHOS_ASSERT(index < beginRanks_.size());
+    return beginRanks_[index];
+  }
+
+  int StaticPartitioner::getEndRank(const pike::MultiphysicsDistributor::ApplicationIndex index) const
+  {
+    TEUCHOS_ASSERT(partitioned_);
+    TEUCHOS_ASSERT(index < beginRanks_.size());
+    return beginRanks_[index] + counts_[index] - 1;
+  }
+
+  double StaticPartitioner::getPredictedIterationTime() const
+  { return predictedIterationTime_; }
+
+  void StaticPartitioner::print(std::ostream& os) const
+  {
+    TEUCHOS_TEST_FOR_EXCEPTION(!partitioned_, std::logic_error,
+			       "Error: pike::StaticPartitioner::print() - partition() must be called first!");
+    os << "Static Partition (" << ((solverType_ == BLOCK_JACOBI) ? "Block Jacobi" : "Block Gauss-Seidel")
+       << ", " << totalProcesses_ << " processes):" << std::endl;
+    for (std::size_t a = 0; a < counts_.size(); ++a) {
+      os << "  " << distributor_->getApplicationName(a) << ": ranks [" << this->getBeginRank(a) << ","
+	 << this->getEndRank(a) << "], predicted solve time = " << this->getPredictedSolveTime(a,counts_[a])
+	 << std::endl;
+    }
+    os << "  Predicted transfer time = " << this->totalTransferTime(counts_,beginRanks_) << std::endl;
+    os << "  Predicted iteration time = " << predictedIterationTime_ << std::endl;
+  }
+
+  // Non-member ctor
+  Teuchos::RCP<pike::StaticPartitioner>
+  staticPartitioner(const Teuchos::RCP<const pike::MultiphysicsDistributor>& distributor)
+  {
+    return Teuchos::rcp(new pike::StaticPartitioner(distributor));
+  }
+
+}
@@ -0,0 +1,167 @@
+#ifndef PIKE_STATIC_PARTITIONER_HPP
+#define PIKE_STATIC_PARTITIONER_HPP
+
+#include "Pike_BlackBox_config.hpp"
+#include "Pike_MultiphysicsDistributor.hpp"
+#include "Teuchos_RCP.hpp"
+#include <vector>
+#include <iosfwd>
+
+namespace pike {
+
+  /** \brief Offline tool that picks application rank ranges from a cost model.
+
+      Uses the applications and transfers registered with a
+      pike::MultiphysicsDistributor (setup() does not have to be
+      called, so this can run before launching).  The cost model has
+      a strong scaling curve for each application and a cost for
+      each transfer that depends on the partition:
+
+      latency + volume * inverseBandwidth / p * (1 + (interNodeFactor - 1) * f)
+
+      where the volume is the one given to
+      MultiphysicsDistributor::addTransfer(), p is the smallest
+      process count of the coupled applications (the data of the
+      transfer is spread over their processes) and f is the fraction
+      of the exchange between the rank ranges of the applications
+      that crosses node boundaries.  Nodes are consecutive blocks of
+      MultiphysicsDistributor::setProcessesPerNode() ranks.  If that
+      was not set, all ranks are treated as one node.  Transfers
+      registered by ranks cost latency + volume * inverseBandwidth.
+
+      partition() minimizes the predicted time per coupled iteration
+      for a total number of processes:
+
+      - BLOCK_JACOBI: applications solve concurrently on disjoint,
+        consecutive rank ranges, so the iteration time is the time of
+        the slowest application plus the transfers.  Processes are
+        handed out one at a time to the application that lowers the
+        iteration time the most, which is either the bottleneck or an
+        application that slows down a transfer.  If nothing lowers the
+        iteration time, the bottleneck still gets a process as long as
+        its own solve speeds up, because it may be tied with another
+        application.  Handing out stops when no process helps.
+
+      - BLOCK_GAUSS_SEIDEL: applications solve one after another, so
+        they all share the ranks starting at rank 0.  The iteration
+        time is the sum of the application times plus the transfers.
+        Each application starts on its fastest process count, and
+        then the count of one application at a time is set to the
+        one that minimizes the iteration time until no count changes.
+   */
+  class StaticPartitioner {
+
+  public:
+
+    enum SolverType {
+      BLOCK_JACOBI,
+      BLOCK_GAUSS_SEIDEL
+    };
+
+    StaticPartitioner(const Teuchos::RCP<const pike::MultiphysicsDistributor>& distributor);
+
+    /** \brief Sets the measured or estimated solve time of an application as a function of its number of processes.
+
+	Times between the points are interpolated linearly in log-log
+	space.  Below the first point perfect scaling is assumed.
+	Beyond the last point the time stays at the last value, so the
+	partitioner never assumes speedup that was not measured.
+
+	\param[in] index Application index in the distributor.
+	\param[in] numProcesses Process counts of the curve, strictly increasing.
+	\param[in] times Solve time for each process count.
+    */
+    void setStrongScalingCurve(const pike::MultiphysicsDistributor::ApplicationIndex index,
+			       const std::vector<int>& numProcesses,
+			       const std::vector<double>& times);
+
+    /** \brief Sets the transfer cost model (see the class description).
+
+	The latency and inverse bandwidth default to zero.  The
+	interNodeFactor scales the bandwidth cost of data that crosses
+	node boundaries and defaults to one.
+    */
+    void setTransferCostModel(const double latency, const double inverseBandwidth, const double interNodeFactor = 1.0);
+
+    //! Returns the predicted solve time of the application on numProcesses processes.
+    double getPredictedSolveTime(const pike::MultiphysicsDistributor::ApplicationIndex index, const int numProcesses) const;
+
+    /** \brief Returns the predicted time of the transfer for a partition.
+
+	\param[in] index Transfer index in the distributor.
+	\param[in] counts Number of processes of each application.
+	\param[in] beginRanks First rank of each application.
+    */
+    double getPredictedTransferTime(const pike::MultiphysicsDistributor::TransferIndex index,
+				    const std::vector<int>& counts,
+				    const std::vector<int>& beginRanks) const;
+
+    //! Returns the predicted time of the transfer for the last partition().
+    double getPredictedTransferTime(const pike::MultiphysicsDistributor::TransferIndex index) const;
+
+    /** \brief Computes the rank ranges.
+
+	Throws if an application has no strong scaling curve or, for
+	BLOCK_JACOBI, if there are fewer processes than applications.
+    */
+    void partition(const int totalProcesses, const SolverType type);
+
+    //! Returns the number of processes of each application from the last partition().
+    const std::vector<int>& getProcessCounts() const;
+
+    //! Returns the first rank of the application from the last partition().
+    int getBeginRank(const pike::MultiphysicsDistributor::ApplicationIndex index) const;
+
+    //! Returns the last rank of the application from the last partition().
+    int getEndRank(const pike::MultiphysicsDistributor::ApplicationIndex index) const;
+
+    //! Returns the predicted time per coupled iteration of the last partition().
+    double getPredictedIterationTime() const;
+
+    //! Prints the rank ranges and the predicted times of the last partition().
+    void print(std::ostream& os) const;
+
+  private:
+
+    struct ScalingCurve {
+      std::vector<int> numProcesses;
+      std::vector<double> times;
+    };
+
+    //! Returns the fraction of an even exchange between two rank ranges that crosses node boundaries.
+    double interNodeFraction(const int beginA, const int countA, const int beginB, const int countB) const;
+
+    double totalTransferTime(const std::vector<int>& counts, const std::vector<int>& beginRanks) const;
+
+    /** \brief Returns the predicted iteration time of a partition.
+
+	For BLOCK_JACOBI the rank ranges are laid out consecutively and
+	written to beginRanks.  The sum of the solve times is returned
+	in totalSolveTime.
+    */
+    double predictIterationTime(const std::vector<int>& counts, const SolverType type,
+				std::vector<int>& beginRanks, double& totalSolveTime) const;
+
+    Teuchos::RCP<const pike::MultiphysicsDistributor> distributor_;
+    std::vector<ScalingCurve> curves_;
+    double latency_;
+    double inverseBandwidth_;
+    double interNodeFactor_;
+
+    bool partitioned_;
+    SolverType solverType_;
+    int totalProcesses_;
+    std::vector<int> counts_;
+    std::vector<int> beginRanks_;
+    double predictedIterationTime_;
+  };
+
+  /** \brief Non-member ctor.
+      \relates StaticPartitioner
+  */
+  Teuchos::RCP<pike::StaticPartitioner>
+  staticPartitioner(const Teuchos::RCP<const pike::MultiphysicsDistributor>& distributor);
+
+}
+
+#endif
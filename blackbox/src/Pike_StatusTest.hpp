@@ -45,6 +45,10 @@ namespace pike {
 	The test can (and should, if possible) be skipped if 
 	checkType is "None".  If the test is skipped, then
 	the status should be set to NOX::StatusTest::Unevaluated.
+
+	A solver may check the same iteration more than once, e.g. a
+	complete check after a failed minimal check.  Tests that
+	keep a history must not update it on the repeated call.
     */
     virtual pike::SolveStatus checkStatus(const pike::Solver& solver, const CheckType checkType = pike::COMPLETE) = 0;
     
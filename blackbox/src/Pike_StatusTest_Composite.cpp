@@ -5,14 +5,40 @@
 #include "Teuchos_ParameterEntry.hpp"
 #include "Teuchos_StandardParameterEntryValidators.hpp"
 #include "Teuchos_ParameterList.hpp"
+#include "Teuchos_CommHelpers.hpp"
 
 #include <cmath>
 
 namespace pike {
 
+  namespace {
+    // Leaf statuses are reduced with MAX, so a higher value wins on
+    // any process.
+    int statusToReductionValue(const pike::SolveStatus s)
+    {
+      switch (s) {
+      case pike::FAILED: return 3;
+      case pike::UNCONVERGED: return 2;
+      case pike::CONVERGED: return 1;
+      default: return 0;
+      }
+    }
+
+    pike::SolveStatus reductionValueToStatus(const int v)
+    {
+      switch (v) {
+      case 3: return pike::FAILED;
+      case 2: return pike::UNCONVERGED;
+      case 1: return pike::CONVERGED;
+      default: return pike::UNCHECKED;
+      }
+    }
+  }
+
   Composite::Composite(const pike::Composite::CompositeType type) :
     type_(type),
-    status_(pike::UNCHECKED)
+    status_(pike::UNCHECKED),
+    numberOfReductions_(0)
   {
     validParameters_ = Teuchos::parameterList("Valid Parameters: Composite");
     Teuchos::setStringToIntegralParameter<int>(
@@ -31,27 +57,96 @@ namespace pike {
     tests_.push_back(t);
   }
     
+  void Composite::setReductionComm(const Teuchos::RCP<const Teuchos::Comm<int> >& comm)
+  {
+    reductionComm_ = comm;
+  }
+
+  int Composite::getNumberOfReductions() const
+  { return numberOfReductions_; }
+    
   pike::SolveStatus Composite::checkStatus(const pike::Solver& solver, const CheckType checkType)
+  {
+    std::size_t offset = 0;
+
+    if (is_null(reductionComm_)) {
+      this->combine(solver,checkType,0,offset);
+      return status_;
+    }
+
+    std::vector<int> localStatuses;
+    this->checkLeafTests(solver,checkType,localStatuses);
+    std::vector<int> globalStatuses(localStatuses.size(),0);
+    if (localStatuses.size() > 0) {
+      Teuchos::reduceAll(*reductionComm_,
+			 Teuchos::REDUCE_MAX,
+			 static_cast<int>(localStatuses.size()),
+			 &localStatuses[0],
+			 &globalStatuses[0]);
+      ++numberOfReductions_;
+    }
+
+    this->combine(solver,checkType,&globalStatuses,offset);
+    TEUCHOS_ASSERT(offset == globalStatuses.size());
+    return status_;
+  }
+
+  void Composite::combine(const pike::Solver& solver, const CheckType checkType,
+			  const std::vector<int>* reducedStatuses, std::size_t& offset)
   {
     if (type_ == pike::Composite::AND)
-      this->checkAnd(solver,checkType);
+      this->checkAnd(solver,checkType,reducedStatuses,offset);
     else
-      this->checkOr(solver,checkType);
-    
-    return status_;
+      this->checkOr(solver,checkType,reducedStatuses,offset);
+  }
+
+  void Composite::checkLeafTests(const pike::Solver& solver, const CheckType checkType,
+				 std::vector<int>& localStatuses)
+  {
+    for (TestIterator test = tests_.begin(); test != tests_.end(); ++test) {
+      pike::Composite* subComposite = dynamic_cast<pike::Composite*>(test->get());
+      if (subComposite != 0)
+	subComposite->checkLeafTests(solver,checkType,localStatuses);
+      else
+	localStatuses.push_back(statusToReductionValue((*test)->checkStatus(solver,checkType)));
+    }
+  }
+
+  pike::SolveStatus Composite::checkSubtest(const Teuchos::RCP<pike::StatusTest>& test,
+					    const pike::Solver& solver,
+					    const CheckType checkType,
+					    const std::vector<int>* reducedStatuses,
+					    std::size_t& offset)
+  {
+    if (reducedStatuses == 0)
+      return test->checkStatus(solver,checkType);
+
+    pike::Composite* subComposite = dynamic_cast<pike::Composite*>(test.get());
+    if (subComposite != 0) {
+      subComposite->combine(solver,checkType,reducedStatuses,offset);
+      return subComposite->getStatus();
+    }
+
+    TEUCHOS_ASSERT(offset < reducedStatuses->size());
+    return reductionValueToStatus((*reducedStatuses)[offset++]);
   }
   
-  void Composite::checkAnd(const pike::Solver& solver, const CheckType checkType)
+  void Composite::checkAnd(const pike::Solver& solver, const CheckType checkType,
+			   const std::vector<int>* reducedStatuses, std::size_t& offset)
   {
     if (checkType == pike::NONE)
       status_ = pike::UNCHECKED;
 
     bool isUnconverged = false;
+    bool isUnchecked = false;
     pike::CheckType subCheckType = checkType;
     
     for (TestIterator test = tests_.begin(); test != tests_.end(); ++test) {
-      pike::SolveStatus testStatus = (*test)->checkStatus(solver,subCheckType);
+      pike::SolveStatus testStatus = this->checkSubtest(*test,solver,subCheckType,reducedStatuses,offset);
       
+      if (testStatus == pike::UNCHECKED)
+	isUnchecked = true;
+
       if (testStatus == pike::UNCONVERGED) {
 	isUnconverged = true;
 	status_ = pike::UNCONVERGED;
@@ -70,9 +165,14 @@ namespace pike {
       }
     }
 
+    // A test that was skipped (e.g. a costly test during a MINIMAL
+    // check) can not be assumed to be converged.
+    if ( isUnchecked && (status_ == pike::CONVERGED) )
+      status_ = pike::UNCONVERGED;
   }
   
-  void Composite::checkOr(const pike::Solver& solver, const CheckType checkType)
+  void Composite::checkOr(const pike::Solver& solver, const CheckType checkType,
+			  const std::vector<int>* reducedStatuses, std::size_t& offset)
   {
     if (checkType == pike::NONE)
       status_ = pike::UNCHECKED;
@@ -82,9 +182,11 @@ namespace pike {
     pike::CheckType subCheckType = checkType;
 
     for (TestIterator test = tests_.begin(); test != tests_.end(); ++test) {
-      pike::SolveStatus testStatus = (*test)->checkStatus(solver,subCheckType);
+      pike::SolveStatus testStatus = this->checkSubtest(*test,solver,subCheckType,reducedStatuses,offset);
 
-      if ( (status_ == pike::UNCONVERGED) && (testStatus != pike::UNCONVERGED) ) {
+      // Skipped tests must not hide the result of later tests
+      if ( (status_ == pike::UNCONVERGED) &&
+	   ( (testStatus == pike::CONVERGED) || (testStatus == pike::FAILED) ) ) {
 	status_ = testStatus;
 
 	if (checkType == pike::MINIMAL)
@@ -3,6 +3,8 @@
 #define PIKE_STATUS_TESTS_COMPOSITE_HPP
 
 #include "Pike_StatusTest.hpp"
+#include "Teuchos_RCP.hpp"
+#include "Teuchos_Comm.hpp"
 #include <vector>
 
 namespace Teuchos { class ParameterList; }
@@ -25,6 +27,28 @@ namespace pike {
     Composite(const pike::Composite::CompositeType type = OR);
     
     void addTest(const Teuchos::RCP<pike::StatusTest>& t);
+
+    /** \brief Makes the status consistent across the processes of comm with a single reduction per check.
+
+	All leaf tests (every subtest that is not a Composite,
+	including the leaves of nested Composites) are first checked
+	locally.  Their statuses are packed into one buffer and
+	reduced with one allreduce.  A leaf is FAILED if it failed on
+	any process, otherwise UNCONVERGED if it is unconverged on any
+	process, otherwise CONVERGED if it converged on any process.
+	The AND/OR logic of this and the nested Composites is then
+	applied to the reduced statuses, so every process returns the
+	same status.  Without a comm, each leaf test has to make its
+	own answer consistent.
+
+	Only set this on the top level Composite.  checkStatus() is
+	then collective over comm.  getStatus() of the leaf tests
+	still returns the local status.
+    */
+    void setReductionComm(const Teuchos::RCP<const Teuchos::Comm<int> >& comm);
+
+    //! Returns the number of reductions performed by checkStatus().
+    int getNumberOfReductions() const;
     
     pike::SolveStatus checkStatus(const pike::Solver& solver, const CheckType checkType = pike::COMPLETE);
     
@@ -40,8 +64,25 @@ namespace pike {
     Teuchos::RCP<const Teuchos::ParameterList> getValidParameters() const;
 
   private:
-    void checkAnd(const pike::Solver& solver, const CheckType checkType);
-    void checkOr(const pike::Solver& solver, const CheckType checkType);
+    void checkAnd(const pike::Solver& solver, const CheckType checkType,
+		  const std::vector<int>* reducedStatuses, std::size_t& offset);
+    void checkOr(const pike::Solver& solver, const CheckType checkType,
+		 const std::vector<int>* reducedStatuses, std::size_t& offset);
+
+    //! Checks the subtest, or takes its status from the reduced leaf statuses if they are given.
+    pike::SolveStatus checkSubtest(const Teuchos::RCP<pike::StatusTest>& test,
+				   const pike::Solver& solver,
+				   const CheckType checkType,
+				   const std::vector<int>* reducedStatuses,
+				   std::size_t& offset);
+
+    //! Applies the AND/OR logic to the reduced leaf statuses.
+    void combine(const pike::Solver& solver, const CheckType checkType,
+		 const std::vector<int>* reducedStatuses, std::size_t& offset);
+
+    //! Checks the leaf tests locally and appends their statuses.
+    void checkLeafTests(const pike::Solver& solver, const CheckType checkType,
+			std::vector<int>& localStatuses);
 
   private:
     CompositeType type_;
@@ -49,6 +90,8 @@ namespace pike {
     Teuchos::RCP<Teuchos::ParameterList> validParameters_;
     Teuchos::RCP<Teuchos::ParameterList> myParameters_;
     pike::SolveStatus status_;
+    Teuchos::RCP<const Teuchos::Comm<int> > reductionComm_;
+    int numberOfReductions_;
     
     
     typedef std::vector<Teuchos::RCP<pike::StatusTest> >::iterator TestIterator;
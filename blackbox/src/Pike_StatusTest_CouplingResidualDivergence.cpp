@@ -0,0 +1,56 @@
+#include "Pike_StatusTest_CouplingResidualDivergence.hpp"
+#include "Teuchos_VerboseObjectParameterListHelpers.hpp"
+#include "Teuchos_Assert.hpp"
+
+namespace pike {
+
+  CouplingResidualDivergence::CouplingResidualDivergence() :
+    pike::CouplingResidualHistoryTest(4),
+    numIterations_(3),
+    maximumRate_(1.0)
+  {
+    validParameters_ = Teuchos::parameterList("Valid Parameters: CouplingResidualDivergence");
+    validParameters_->set("Type","Coupling Residual Divergence","Type of object to build.");
+    validParameters_->set("Number of Iterations",3,"Number of iterations used to estimate the contraction rate");
+    validParameters_->set("Maximum Contraction Rate",1.0,"The solve fails if the estimated contraction rate exceeds this value");
+    Teuchos::setupVerboseObjectSublist(validParameters_.get());
+  }
+
+  pike::SolveStatus CouplingResidualDivergence::evaluateHistory(const double , const double )
+  {
+    if (history_.size() <= static_cast<std::size_t>(numIterations_))
+      return pike::UNCONVERGED;
+
+    rate_ = history_.contractionRate(numIterations_);
+    return (rate_ > maximumRate_) ? pike::FAILED : pike::UNCONVERGED;
+  }
+
+  void CouplingResidualDivergence::describe(Teuchos::FancyOStream &out, const Teuchos::EVerbosityLevel verbLevel) const
+  {
+    out << pike::statusToString(this->getStatus())
+	<< "Coupling residual contraction rate over " << numIterations_ << " iterations: ";
+    if (rate_ < 0.0)
+      out << "not enough iterations";
+    else
+      out << rate_ << " must be <= " << maximumRate_;
+    out << std::endl;
+  }
+
+  void CouplingResidualDivergence::setParameterList(const Teuchos::RCP<Teuchos::ParameterList>& paramList)
+  {
+    paramList->validateParametersAndSetDefaults(*(this->getValidParameters()));
+    this->setMyParamList(paramList);
+    numIterations_ = paramList->get<int>("Number of Iterations");
+    maximumRate_ = paramList->get<double>("Maximum Contraction Rate");
+
+    TEUCHOS_TEST_FOR_EXCEPTION(numIterations_ < 1, std::logic_error,
+			       "Error: pike::CouplingResidualDivergence - the \"Number of Iterations\" must be at least 1!");
+    history_.setCapacity(numIterations_ + 1);
+  }
+
+  Teuchos::RCP<const Teuchos::ParameterList> CouplingResidualDivergence::getValidParameters() const
+  {
+    return validParameters_;
+  }
+
+}
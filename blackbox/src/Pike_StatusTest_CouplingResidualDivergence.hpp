@@ -0,0 +1,43 @@
+#ifndef PIKE_STATUS_TESTS_COUPLING_RESIDUAL_DIVERGENCE_HPP
+#define PIKE_STATUS_TESTS_COUPLING_RESIDUAL_DIVERGENCE_HPP
+
+#include "Pike_StatusTest_CouplingResidualHistory.hpp"
+#include <iostream>
+
+namespace pike {
+
+  /** \brief Failure test that detects a diverging coupled iteration.
+
+      Keeps the global coupling residuals (see
+      pike::computeCouplingResidual()) of the last "Number of
+      Iterations" + 1 iterations and estimates the contraction rate
+      as the geometric mean of the ratios of consecutive residuals.
+      Returns pike::FAILED when the rate exceeds the "Maximum
+      Contraction Rate", otherwise pike::UNCONVERGED.  Averaging over
+      a few iterations keeps a single bad iteration from failing the
+      solve.
+   */
+  class CouplingResidualDivergence : public pike::CouplingResidualHistoryTest {
+
+  public:
+
+    CouplingResidualDivergence();
+
+    void describe(Teuchos::FancyOStream &out, const Teuchos::EVerbosityLevel verbLevel=verbLevel_default) const;
+
+    void setParameterList(const Teuchos::RCP<Teuchos::ParameterList>& paramList);
+
+    Teuchos::RCP<const Teuchos::ParameterList> getValidParameters() const;
+
+  protected:
+    pike::SolveStatus evaluateHistory(const double residual, const double targetNorm);
+
+  private:
+    int numIterations_;
+    double maximumRate_;
+    Teuchos::RCP<Teuchos::ParameterList> validParameters_;
+  };
+
+}
+
+#endif
@@ -0,0 +1,66 @@
+#include "Pike_StatusTest_CouplingResidualHistory.hpp"
+#include "Pike_StatusTest_GlobalCouplingResidual.hpp"
+#include "Pike_Solver.hpp"
+
+namespace pike {
+
+  CouplingResidualHistoryTest::CouplingResidualHistoryTest(const std::size_t historyCapacity) :
+    history_(historyCapacity),
+    rate_(-1.0),
+    measureTargetNorm_(false),
+    checkedIteration_(-1),
+    status_(pike::UNCHECKED)
+  { }
+
+  pike::SolveStatus CouplingResidualHistoryTest::checkStatus(const pike::Solver& solver, const CheckType checkType)
+  {
+    // No transfers have run before the first iteration
+    if (solver.getNumberOfIterations() == 0) {
+      this->clearHistory();
+      checkedIteration_ = 0;
+      status_ = pike::UNCONVERGED;
+      return status_;
+    }
+
+    if (solver.getNumberOfIterations() == checkedIteration_)
+      return status_; // has already been checked this iteration
+
+    double targetNorm = 0.0;
+    const double residual = pike::computeCouplingResidual(solver,measureTargetNorm_ ? &targetNorm : 0,comm_);
+    history_.push(residual);
+    checkedIteration_ = solver.getNumberOfIterations();
+
+    status_ = this->evaluateHistory(residual,targetNorm);
+    return status_;
+  }
+
+  pike::SolveStatus CouplingResidualHistoryTest::getStatus() const
+  { return status_; }
+
+  void CouplingResidualHistoryTest::reset()
+  {
+    this->clearHistory();
+    checkedIteration_ = -1;
+    status_ = pike::UNCHECKED;
+  }
+
+  double CouplingResidualHistoryTest::getContractionRate() const
+  { return rate_; }
+
+  void CouplingResidualHistoryTest::setComm(const Teuchos::RCP<const Teuchos::Comm<int> >& comm)
+  { comm_ = comm; }
+
+  void CouplingResidualHistoryTest::clearHistoryState()
+  { }
+
+  void CouplingResidualHistoryTest::measureTargetNorm(const bool measure)
+  { measureTargetNorm_ = measure; }
+
+  void CouplingResidualHistoryTest::clearHistory()
+  {
+    history_.clear();
+    rate_ = -1.0;
+    this->clearHistoryState();
+  }
+
+}
@@ -0,0 +1,75 @@
+#ifndef PIKE_STATUS_TESTS_COUPLING_RESIDUAL_HISTORY_HPP
+#define PIKE_STATUS_TESTS_COUPLING_RESIDUAL_HISTORY_HPP
+
+#include "Pike_StatusTest.hpp"
+#include "Pike_ResidualHistory.hpp"
+#include "Teuchos_ParameterListAcceptorDefaultBase.hpp"
+#include "Teuchos_Comm.hpp"
+
+namespace pike {
+
+  /** \brief Base class for status tests on the history of the global coupling residual.
+
+      Records the global coupling residual (see
+      pike::computeCouplingResidual()) of every iteration in a
+      ResidualHistory.  The residual is cheap, so it is recorded on
+      every check type and the history has no gaps.  Repeated checks
+      of the same iteration return the status of the first one.
+      Derived classes only decide the status from the history in
+      evaluateHistory().
+
+      All registered data transfers must measure the change of their
+      target data.
+   */
+  class CouplingResidualHistoryTest :
+    public pike::StatusTest,
+    public Teuchos::ParameterListAcceptorDefaultBase {
+
+  public:
+
+    CouplingResidualHistoryTest(const std::size_t historyCapacity);
+
+    pike::SolveStatus checkStatus(const pike::Solver& solver, const CheckType checkType = pike::COMPLETE);
+
+    pike::SolveStatus getStatus() const;
+
+    void reset();
+
+    //! Returns the estimated contraction rate, or a negative value if not enough iterations were run.
+    double getContractionRate() const;
+
+    //! Sets the comm to reduce the coupling residual over (see pike::computeCouplingResidual()).  checkStatus() is then collective over it.
+    void setComm(const Teuchos::RCP<const Teuchos::Comm<int> >& comm);
+
+  protected:
+
+    /** \brief Returns the status of the iteration whose residual was just added to history_.
+
+	\param[in] residual The global coupling residual of the iteration.
+	\param[in] targetNorm The L2 norm of all transferred data.  Only measured if requested with measureTargetNorm().
+    */
+    virtual pike::SolveStatus evaluateHistory(const double residual, const double targetNorm) = 0;
+
+    //! Clears the state of derived classes.  Called before the first iteration and by reset().  The default does nothing.
+    virtual void clearHistoryState();
+
+    //! If true, checkStatus() also computes the norm of the transferred data for evaluateHistory().
+    void measureTargetNorm(const bool measure);
+
+    ResidualHistory history_;
+
+    //! Contraction rate reported by getContractionRate().  Reset to a negative value with the history.
+    double rate_;
+
+  private:
+    void clearHistory();
+
+    bool measureTargetNorm_;
+    int checkedIteration_;
+    pike::SolveStatus status_;
+    Teuchos::RCP<const Teuchos::Comm<int> > comm_;
+  };
+
+}
+
+#endif
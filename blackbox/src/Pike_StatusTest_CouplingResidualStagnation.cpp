@@ -0,0 +1,61 @@
+#include "Pike_StatusTest_CouplingResidualStagnation.hpp"
+#include "Teuchos_VerboseObjectParameterListHelpers.hpp"
+#include "Teuchos_Assert.hpp"
+
+namespace pike {
+
+  CouplingResidualStagnation::CouplingResidualStagnation() :
+    pike::CouplingResidualHistoryTest(6),
+    numIterations_(5),
+    stagnationRate_(0.95),
+    numStagnantIterations_(0)
+  {
+    validParameters_ = Teuchos::parameterList("Valid Parameters: CouplingResidualStagnation");
+    validParameters_->set("Type","Coupling Residual Stagnation","Type of object to build.");
+    validParameters_->set("Number of Iterations",5,"Number of consecutive stagnant iterations that fail the solve");
+    validParameters_->set("Stagnation Rate",0.95,"An iteration is stagnant if the ratio of its coupling residual to the previous one is at or above this value");
+    Teuchos::setupVerboseObjectSublist(validParameters_.get());
+  }
+
+  pike::SolveStatus CouplingResidualStagnation::evaluateHistory(const double , const double )
+  {
+    if (history_.size() > 1) {
+      if (history_.contractionRate(1) >= stagnationRate_)
+	++numStagnantIterations_;
+      else
+	numStagnantIterations_ = 0;
+      rate_ = history_.contractionRate(history_.size() - 1);
+    }
+
+    return (numStagnantIterations_ >= numIterations_) ? pike::FAILED : pike::UNCONVERGED;
+  }
+
+  void CouplingResidualStagnation::clearHistoryState()
+  { numStagnantIterations_ = 0; }
+
+  void CouplingResidualStagnation::describe(Teuchos::FancyOStream &out, const Teuchos::EVerbosityLevel verbLevel) const
+  {
+    out << pike::statusToString(this->getStatus())
+	<< "Coupling residual stagnation: " << numStagnantIterations_ << " of " << numIterations_
+	<< " allowed iterations with a rate >= " << stagnationRate_ << " (contraction rate = " << rate_ << ")"
+	<< std::endl;
+  }
+
+  void CouplingResidualStagnation::setParameterList(const Teuchos::RCP<Teuchos::ParameterList>& paramList)
+  {
+    paramList->validateParametersAndSetDefaults(*(this->getValidParameters()));
+    this->setMyParamList(paramList);
+    numIterations_ = paramList->get<int>("Number of Iterations");
+    stagnationRate_ = paramList->get<double>("Stagnation Rate");
+
+    TEUCHOS_TEST_FOR_EXCEPTION(numIterations_ < 1, std::logic_error,
+			       "Error: pike::CouplingResidualStagnation - the \"Number of Iterations\" must be at least 1!");
+    history_.setCapacity(numIterations_ + 1);
+  }
+
+  Teuchos::RCP<const Teuchos::ParameterList> CouplingResidualStagnation::getValidParameters() const
+  {
+    return validParameters_;
+  }
+
+}
@@ -0,0 +1,48 @@
+#ifndef PIKE_STATUS_TESTS_COUPLING_RESIDUAL_STAGNATION_HPP
+#define PIKE_STATUS_TESTS_COUPLING_RESIDUAL_STAGNATION_HPP
+
+#include "Pike_StatusTest_CouplingResidualHistory.hpp"
+#include <iostream>
+
+namespace pike {
+
+  /** \brief Failure test that detects a stalled coupled iteration.
+
+      Keeps the global coupling residuals (see
+      pike::computeCouplingResidual()) of the last "Number of
+      Iterations" + 1 iterations.  Returns pike::FAILED when the
+      residual shrank by less than the "Stagnation Rate" in each of
+      the last "Number of Iterations" iterations, i.e. r_k / r_{k-1}
+      >= "Stagnation Rate", otherwise pike::UNCONVERGED.  Growing
+      residuals count as stagnant too, so combine this with
+      pike::CouplingResidualDivergence to fail diverging iterations
+      earlier.  getContractionRate() returns the rate over all stored
+      iterations (see ResidualHistory::contractionRate()).
+   */
+  class CouplingResidualStagnation : public pike::CouplingResidualHistoryTest {
+
+  public:
+
+    CouplingResidualStagnation();
+
+    void describe(Teuchos::FancyOStream &out, const Teuchos::EVerbosityLevel verbLevel=verbLevel_default) const;
+
+    void setParameterList(const Teuchos::RCP<Teuchos::ParameterList>& paramList);
+
+    Teuchos::RCP<const Teuchos::ParameterList> getValidParameters() const;
+
+  protected:
+    pike::SolveStatus evaluateHistory(const double residual, const double targetNorm);
+
+    void clearHistoryState();
+
+  private:
+    int numIterations_;
+    double stagnationRate_;
+    int numStagnantIterations_;
+    Teuchos::RCP<Teuchos::ParameterList> validParameters_;
+  };
+
+}
+
+#endif
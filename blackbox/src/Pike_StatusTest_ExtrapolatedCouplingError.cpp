@@ -0,0 +1,85 @@
+#include "Pike_StatusTest_ExtrapolatedCouplingError.hpp"
+#include "Teuchos_VerboseObjectParameterListHelpers.hpp"
+#include "Teuchos_Assert.hpp"
+
+namespace pike {
+
+  ExtrapolatedCouplingError::ExtrapolatedCouplingError() :
+    pike::CouplingResidualHistoryTest(3),
+    toleranceType_(ABSOLUTE),
+    tolerance_(1.0e-6),
+    numIterations_(2),
+    errorEstimate_(-1.0),
+    threshold_(0.0)
+  {
+    validParameters_ = Teuchos::parameterList("Valid Parameters: ExtrapolatedCouplingError");
+    validParameters_->set("Type","Extrapolated Coupling Error","Type of object to build.");
+    validParameters_->set("Tolerance Type","Absolute","Type of test on the estimated error: \"Absolute\" or \"Relative\"");
+    validParameters_->set("Tolerance",1.0e-6,"Tolerance on the estimated error");
+    validParameters_->set("Number of Iterations",2,"Number of iterations used to estimate the contraction rate");
+    Teuchos::setupVerboseObjectSublist(validParameters_.get());
+  }
+
+  pike::SolveStatus ExtrapolatedCouplingError::evaluateHistory(const double residual, const double targetNorm)
+  {
+    threshold_ = (toleranceType_ == ABSOLUTE) ? tolerance_ : tolerance_ * targetNorm;
+
+    rate_ = -1.0;
+    errorEstimate_ = -1.0;
+    if (history_.size() > static_cast<std::size_t>(numIterations_)) {
+      rate_ = history_.contractionRate(numIterations_);
+      if (rate_ < 1.0)
+	errorEstimate_ = rate_ / (1.0 - rate_) * residual;
+    }
+
+    return ( (errorEstimate_ >= 0.0) && (errorEstimate_ < threshold_) ) ? pike::CONVERGED : pike::UNCONVERGED;
+  }
+
+  void ExtrapolatedCouplingError::clearHistoryState()
+  { errorEstimate_ = -1.0; }
+
+  double ExtrapolatedCouplingError::getErrorEstimate() const
+  { return errorEstimate_; }
+
+  void ExtrapolatedCouplingError::describe(Teuchos::FancyOStream &out, const Teuchos::EVerbosityLevel verbLevel) const
+  {
+    out << pike::statusToString(this->getStatus())
+	<< ((toleranceType_ == ABSOLUTE) ? "Absolute" : "Relative")
+	<< " extrapolated coupling error: ";
+    if (errorEstimate_ < 0.0)
+      out << "no estimate (contraction rate = " << rate_ << ")";
+    else
+      out << errorEstimate_ << " must be < " << threshold_ << " (contraction rate = " << rate_ << ")";
+    out << std::endl;
+  }
+
+  void ExtrapolatedCouplingError::setParameterList(const Teuchos::RCP<Teuchos::ParameterList>& paramList)
+  {
+    paramList->validateParametersAndSetDefaults(*(this->getValidParameters()));
+    this->setMyParamList(paramList);
+    tolerance_ = paramList->get<double>("Tolerance");
+    numIterations_ = paramList->get<int>("Number of Iterations");
+
+    const std::string toleranceType = paramList->get<std::string>("Tolerance Type");
+    if (toleranceType == "Absolute")
+      toleranceType_ = ABSOLUTE;
+    else if (toleranceType == "Relative")
+      toleranceType_ = RELATIVE;
+    else {
+      TEUCHOS_TEST_FOR_EXCEPTION(true, std::logic_error,
+				 "Error: pike::ExtrapolatedCouplingError - the \"Tolerance Type\" \"" << toleranceType
+				 << "\" is not valid!  Choose \"Absolute\" or \"Relative\".");
+    }
+    this->measureTargetNorm(toleranceType_ == RELATIVE);
+
+    TEUCHOS_TEST_FOR_EXCEPTION(numIterations_ < 1, std::logic_error,
+			       "Error: pike::ExtrapolatedCouplingError - the \"Number of Iterations\" must be at least 1!");
+    history_.setCapacity(numIterations_ + 1);
+  }
+
+  Teuchos::RCP<const Teuchos::ParameterList> ExtrapolatedCouplingError::getValidParameters() const
+  {
+    return validParameters_;
+  }
+
+}
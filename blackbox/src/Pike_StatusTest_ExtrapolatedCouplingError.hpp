@@ -0,0 +1,73 @@
+#ifndef PIKE_STATUS_TESTS_EXTRAPOLATED_COUPLING_ERROR_HPP
+#define PIKE_STATUS_TESTS_EXTRAPOLATED_COUPLING_ERROR_HPP
+
+#include "Pike_StatusTest_CouplingResidualHistory.hpp"
+#include <iostream>
+
+namespace pike {
+
+  /** \brief Convergence test on the estimated distance of the coupled iteration to its fixed point.
+
+      For a linearly converging fixed-point iteration with
+      contraction rate c, the remaining error after an iteration
+      with global coupling residual r_k (see
+      pike::computeCouplingResidual()) is about the sum of all
+      future changes (Aitken extrapolation):
+
+      e_k = c / (1 - c) * r_k
+
+      The rate is estimated from the residuals of the last "Number of
+      Iterations" + 1 iterations (see
+      ResidualHistory::contractionRate()).  The test converges when:
+
+      - "Absolute": e_k < "Tolerance"
+      - "Relative": e_k < "Tolerance" * ||transferred data||
+
+      For slowly contracting iterations (c close to one) the error is
+      much larger than the residual, so a test on the raw residual
+      would converge too early.  For fast iterations it is smaller
+      and this test converges earlier.  No estimate exists until
+      enough iterations were run or while the rate is not below one,
+      and the test then returns pike::UNCONVERGED.
+
+      With a comm set (see CouplingResidualHistoryTest::setComm()),
+      the residual and, for "Relative", the norm of the transferred
+      data are both reduced over it.
+   */
+  class ExtrapolatedCouplingError : public pike::CouplingResidualHistoryTest {
+
+  public:
+
+    enum ToleranceType {
+      ABSOLUTE,
+      RELATIVE
+    };
+
+    ExtrapolatedCouplingError();
+
+    void describe(Teuchos::FancyOStream &out, const Teuchos::EVerbosityLevel verbLevel=verbLevel_default) const;
+
+    void setParameterList(const Teuchos::RCP<Teuchos::ParameterList>& paramList);
+
+    Teuchos::RCP<const Teuchos::ParameterList> getValidParameters() const;
+
+    //! Returns the estimated error from the last check, or a negative value if there is no estimate.
+    double getErrorEstimate() const;
+
+  protected:
+    pike::SolveStatus evaluateHistory(const double residual, const double targetNorm);
+
+    void clearHistoryState();
+
+  private:
+    ToleranceType toleranceType_;
+    double tolerance_;
+    int numIterations_;
+    double errorEstimate_;
+    double threshold_;
+    Teuchos::RCP<Teuchos::ParameterList> validParameters_;
+  };
+
+}
+
+#endif
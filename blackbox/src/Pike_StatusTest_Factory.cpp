@@ -8,6 +8,11 @@
 #include "Pike_StatusTest_LocalModelConvergence.hpp"
 #include "Pike_StatusTest_LocalModelFailure.hpp"
 #include "Pike_StatusTest_ScalarResponseRelativeTolerance.hpp"
+#include "Pike_StatusTest_VectorResponseTolerance.hpp"
+#include "Pike_StatusTest_GlobalCouplingResidual.hpp"
+#include "Pike_StatusTest_CouplingResidualDivergence.hpp"
+#include "Pike_StatusTest_CouplingResidualStagnation.hpp"
+#include "Pike_StatusTest_ExtrapolatedCouplingError.hpp"
 
 namespace pike {
 
@@ -20,6 +25,11 @@ namespace pike {
     myTypes_.push_back("Local Model Convergence");
     myTypes_.push_back("Local Model Failure");
     myTypes_.push_back("Scalar Response Relative Tolerance");
+    myTypes_.push_back("Vector Response Tolerance");
+    myTypes_.push_back("Global Coupling Residual");
+    myTypes_.push_back("Coupling Residual Divergence");
+    myTypes_.push_back("Coupling Residual Stagnation");
+    myTypes_.push_back("Extrapolated Coupling Error");
   }
 
   bool StatusTestFactory::supportsType(const std::string& type) const
@@ -69,6 +79,36 @@ namespace pike {
       rt->setParameterList(p);
       test = rt;
     }
+    else if (testType == "Vector Response Tolerance") {
+      Teuchos::RCP<pike::VectorResponseTolerance> vt = 
+	Teuchos::rcp(new pike::VectorResponseTolerance());
+      vt->setParameterList(p);
+      test = vt;
+    }
+    else if (testType == "Global Coupling Residual") {
+      Teuchos::RCP<pike::GlobalCouplingResidual> gcr = 
+	Teuchos::rcp(new pike::GlobalCouplingResidual());
+      gcr->setParameterList(p);
+      test = gcr;
+    }
+    else if (testType == "Coupling Residual Divergence") {
+      Teuchos::RCP<pike::CouplingResidualDivergence> crd = 
+	Teuchos::rcp(new pike::CouplingResidualDivergence());
+      crd->setParameterList(p);
+      test = crd;
+    }
+    else if (testType == "Coupling Residual Stagnation") {
+      Teuchos::RCP<pike::CouplingResidualStagnation> crs = 
+	Teuchos::rcp(new pike::CouplingResidualStagnation());
+      crs->setParameterList(p);
+      test = crs;
+    }
+    else if (testType == "Extrapolated Coupling Error") {
+      Teuchos::RCP<pike::ExtrapolatedCouplingError> ece = 
+	Teuchos::rcp(new pike::ExtrapolatedCouplingError());
+      ece->setParameterList(p);
+      test = ece;
+    }
     else {
       typedef std::vector<Teuchos::RCP<pike::StatusTestAbstractFactory> >::const_iterator it;
       for (it f=userFactories_.begin(); f != userFactories_.end(); ++f) {
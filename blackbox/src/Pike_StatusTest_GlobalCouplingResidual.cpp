@@ -0,0 +1,118 @@
+#include "Pike_StatusTest_GlobalCouplingResidual.hpp"
+#include "Pike_Solver.hpp"
+#include "Pike_DataTransfer.hpp"
+#include "Teuchos_VerboseObjectParameterListHelpers.hpp"
+#include "Teuchos_Assert.hpp"
+#include "Teuchos_CommHelpers.hpp"
+#include <cmath>
+
+namespace pike {
+
+  GlobalCouplingResidual::GlobalCouplingResidual() :
+    toleranceType_(ABSOLUTE),
+    tolerance_(1.0e-6),
+    residual_(0.0),
+    threshold_(0.0),
+    status_(pike::UNCHECKED)
+  {
+    validParameters_ = Teuchos::parameterList("Valid Parameters: GlobalCouplingResidual");
+    validParameters_->set("Type","Global Coupling Residual","Type of object to build.");
+    validParameters_->set("Tolerance Type","Absolute","Type of test on the coupling residual: \"Absolute\" or \"Relative\"");
+    validParameters_->set("Tolerance",1.0e-6,"Tolerance on the coupling residual");
+    Teuchos::setupVerboseObjectSublist(validParameters_.get());
+  }
+
+  pike::SolveStatus GlobalCouplingResidual::checkStatus(const pike::Solver& solver, const CheckType checkType)
+  {
+    // No transfers have run before the first iteration
+    if (solver.getNumberOfIterations() == 0) {
+      residual_ = 0.0;
+      status_ = pike::UNCONVERGED;
+      return status_;
+    }
+
+    if (toleranceType_ == ABSOLUTE) {
+      residual_ = pike::computeCouplingResidual(solver,0,comm_);
+      threshold_ = tolerance_;
+    }
+    else {
+      double targetNorm = 0.0;
+      residual_ = pike::computeCouplingResidual(solver,&targetNorm,comm_);
+      threshold_ = tolerance_ * targetNorm;
+    }
+    status_ = (residual_ < threshold_) ? pike::CONVERGED : pike::UNCONVERGED;
+    return status_;
+  }
+
+  pike::SolveStatus GlobalCouplingResidual::getStatus() const
+  { return status_; }
+
+  void GlobalCouplingResidual::reset()
+  { status_ = pike::UNCHECKED; }
+
+  double GlobalCouplingResidual::getResidual() const
+  { return residual_; }
+
+  void GlobalCouplingResidual::setComm(const Teuchos::RCP<const Teuchos::Comm<int> >& comm)
+  { comm_ = comm; }
+
+  void GlobalCouplingResidual::describe(Teuchos::FancyOStream &out, const Teuchos::EVerbosityLevel verbLevel) const
+  {
+    out << pike::statusToString(status_)
+	<< ((toleranceType_ == ABSOLUTE) ? "Absolute" : "Relative")
+	<< " global coupling residual: " << residual_ << " must be < " << threshold_
+	<< std::endl;
+  }
+
+  void GlobalCouplingResidual::setParameterList(const Teuchos::RCP<Teuchos::ParameterList>& paramList)
+  {
+    paramList->validateParametersAndSetDefaults(*(this->getValidParameters()));
+    this->setMyParamList(paramList);
+    tolerance_ = paramList->get<double>("Tolerance");
+
+    const std::string toleranceType = paramList->get<std::string>("Tolerance Type");
+    if (toleranceType == "Absolute")
+      toleranceType_ = ABSOLUTE;
+    else if (toleranceType == "Relative")
+      toleranceType_ = RELATIVE;
+    else {
+      TEUCHOS_TEST_FOR_EXCEPTION(true, std::logic_error,
+				 "Error: pike::GlobalCouplingResidual - the \"Tolerance Type\" \"" << toleranceType
+				 << "\" is not valid!  Choose \"Absolute\" or \"Relative\".");
+    }
+  }
+
+  Teuchos::RCP<const Teuchos::ParameterList> GlobalCouplingResidual::getValidParameters() const
+  {
+    return validParameters_;
+  }
+
+  double computeCouplingResidual(const pike::Solver& solver, double* targetNorm,
+				 const Teuchos::RCP<const Teuchos::Comm<int> >& comm)
+  {
+    double normsSquared[2] = {0.0, 0.0};
+    double& changeNormSquared = normsSquared[0];
+    double& targetNormSquared = normsSquared[1];
+    const Teuchos::ArrayView<const Teuchos::RCP<const pike::DataTransfer> > transfers = solver.getDataTransfersView();
+    for (Teuchos::ArrayView<const Teuchos::RCP<const pike::DataTransfer> >::const_iterator t = transfers.begin();
+	 t != transfers.end(); ++t) {
+      const double change = (*t)->getChangeNormSquared();
+      const double target = (targetNorm != 0) ? (*t)->getTargetNormSquared() : 0.0;
+      TEUCHOS_TEST_FOR_EXCEPTION( (change < 0.0) || (target < 0.0), std::logic_error,
+				  "Error: pike::computeCouplingResidual() - the data transfer \"" << (*t)->name()
+				  << "\" does not measure the change of its target data!");
+      changeNormSquared += change;
+      targetNormSquared += target;
+    }
+
+    if (nonnull(comm)) {
+      const double localNormsSquared[2] = {normsSquared[0], normsSquared[1]};
+      Teuchos::reduceAll(*comm,Teuchos::REDUCE_SUM,2,localNormsSquared,normsSquared);
+    }
+
+    if (targetNorm != 0)
+      *targetNorm = std::sqrt(targetNormSquared);
+    return std::sqrt(changeNormSquared);
+  }
+
+}
@@ -0,0 +1,97 @@
+#ifndef PIKE_STATUS_TESTS_GLOBAL_COUPLING_RESIDUAL_HPP
+#define PIKE_STATUS_TESTS_GLOBAL_COUPLING_RESIDUAL_HPP
+
+#include "Pike_StatusTest.hpp"
+#include "Teuchos_ParameterListAcceptorDefaultBase.hpp"
+#include "Teuchos_Comm.hpp"
+#include <iostream>
+
+namespace pike {
+
+  /** \brief Convergence test on the fixed-point residual of the whole coupled system.
+
+      The residual is the L2 norm of the change of all coupling data
+      written by every registered pike::DataTransfer in its last
+      transfer:
+
+      r = sqrt(sum_t DataTransfer::getChangeNormSquared())
+
+      The test converges when:
+
+      - "Absolute": r < "Tolerance"
+      - "Relative": r < "Tolerance" * sqrt(sum_t DataTransfer::getTargetNormSquared())
+
+      The transfers accumulate the norms while they write the
+      targets, so this test never touches the coupling data and is
+      cheap enough to run on every check.  Every registered transfer
+      must measure the norms, otherwise an exception is thrown.
+
+      Each process only measures the target data it writes.  If a
+      comm is set with setComm(), both sums are reduced over it
+      before taking the square roots, so the residual covers the
+      coupling data of all its processes.  Otherwise the residual is
+      local; Composite::setReductionComm() then makes the status
+      consistent across processes.
+
+      The change norms cover the last run of each transfer.  Solvers
+      should therefore run a transfer once per iteration, as
+      pike::BlockGaussSeidel does for transfers with several targets.
+   */
+  class GlobalCouplingResidual :
+    public pike::StatusTest,
+    public Teuchos::ParameterListAcceptorDefaultBase {
+
+  public:
+
+    enum ToleranceType {
+      ABSOLUTE,
+      RELATIVE
+    };
+
+    GlobalCouplingResidual();
+
+    pike::SolveStatus checkStatus(const pike::Solver& solver, const CheckType checkType = pike::COMPLETE);
+
+    pike::SolveStatus getStatus() const;
+
+    void reset();
+
+    void describe(Teuchos::FancyOStream &out, const Teuchos::EVerbosityLevel verbLevel=verbLevel_default) const;
+
+    void setParameterList(const Teuchos::RCP<Teuchos::ParameterList>& paramList);
+
+    Teuchos::RCP<const Teuchos::ParameterList> getValidParameters() const;
+
+    //! Returns the coupling residual from the last check.
+    double getResidual() const;
+
+    //! Sets the comm to reduce the norms over.  checkStatus() is then collective over it.
+    void setComm(const Teuchos::RCP<const Teuchos::Comm<int> >& comm);
+
+  private:
+    ToleranceType toleranceType_;
+    double tolerance_;
+    double residual_;
+    double threshold_;
+    pike::SolveStatus status_;
+    Teuchos::RCP<Teuchos::ParameterList> validParameters_;
+    Teuchos::RCP<const Teuchos::Comm<int> > comm_;
+  };
+
+  /** \brief Returns the global coupling residual of the last transfers of all registered data transfers.
+
+      Throws if a registered transfer does not measure the change of
+      its target data.
+
+      \param[in] solver The solver that owns the data transfers.
+      \param[out] targetNorm If not null, returns the L2 norm of all transferred data.
+      \param[in] comm If not null, the squared norms are summed over this comm.  Then collective over the comm.
+
+      \relates GlobalCouplingResidual
+  */
+  double computeCouplingResidual(const pike::Solver& solver, double* targetNorm = 0,
+				 const Teuchos::RCP<const Teuchos::Comm<int> >& comm = Teuchos::null);
+
+}
+
+#endif
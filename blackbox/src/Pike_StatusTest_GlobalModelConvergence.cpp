@@ -24,7 +24,9 @@ namespace pike {
       TEUCHOS_ASSERT(nonnull(application_));
     }
 
-    if (solver.getNumberOfIterations() == 0) {
+    // The model may need a global reduction to answer, so this is
+    // only checked on complete checks.
+    if ( (solver.getNumberOfIterations() == 0) || (checkType != pike::COMPLETE) ) {
       status_ = pike::UNCHECKED;
       return status_; 
     }
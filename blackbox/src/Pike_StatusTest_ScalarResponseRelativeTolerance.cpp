@@ -45,7 +45,10 @@ namespace pike {
       return status_;
     }
 
-    if (solver.getNumberOfIterations() == previousIteration_)
+    // A solver may check the same iteration again, e.g. with a
+    // complete check after a minimal one.  Comparing the value to
+    // itself would report a false convergence.
+    if (solver.getNumberOfIterations() == currentIteration_)
       return status_; // has already been checked this iteration
 
     // took a step and now need to check
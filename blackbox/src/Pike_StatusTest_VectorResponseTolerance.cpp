@@ -0,0 +1,270 @@
+#include "Pike_StatusTest_VectorResponseTolerance.hpp"
+#include "Pike_Solver.hpp"
+#include "Pike_BlackBoxModelEvaluator.hpp"
+#include "Teuchos_VerboseObjectParameterListHelpers.hpp"
+#include "Teuchos_Assert.hpp"
+#include "Teuchos_CommHelpers.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace pike {
+
+  namespace {
+
+    // The kernels below make a single pass over the response and
+    // copy it into the previous buffer on the way.  Four independent
+    // accumulators break the dependency chain of the sums and maxima,
+    // so the compiler can use packed SIMD instructions without
+    // reassociating floating point operations (no -ffast-math
+    // needed).  The response and the buffer never alias.
+
+    void differenceNorms(const double* __restrict x, double* __restrict previous, const std::size_t n,
+			 double& sumSquaresDiff, double& maxDiff,
+			 double& sumSquaresX, double& maxX)
+    {
+      double sd[4] = {0.0, 0.0, 0.0, 0.0};
+      double md[4] = {0.0, 0.0, 0.0, 0.0};
+      double sx[4] = {0.0, 0.0, 0.0, 0.0};
+      double mx[4] = {0.0, 0.0, 0.0, 0.0};
+
+      std::size_t i = 0;
+      for ( ; i + 4 <= n; i += 4) {
+	for (int j = 0; j < 4; ++j) {
+	  const double xi = x[i+j];
+	  const double d = xi - previous[i+j];
+	  const double ad = std::abs(d);
+	  const double axi = std::abs(xi);
+	  sd[j] += d * d;
+	  md[j] = (ad > md[j]) ? ad : md[j];
+	  sx[j] += xi * xi;
+	  mx[j] = (axi > mx[j]) ? axi : mx[j];
+	  previous[i+j] = xi;
+	}
+      }
+      for ( ; i < n; ++i) {
+	const double xi = x[i];
+	const double d = xi - previous[i];
+	const double ad = std::abs(d);
+	const double axi = std::abs(xi);
+	sd[0] += d * d;
+	md[0] = (ad > md[0]) ? ad : md[0];
+	sx[0] += xi * xi;
+	mx[0] = (axi > mx[0]) ? axi : mx[0];
+	previous[i] = xi;
+      }
+
+      sumSquaresDiff = (sd[0] + sd[1]) + (sd[2] + sd[3]);
+      sumSquaresX = (sx[0] + sx[1]) + (sx[2] + sx[3]);
+      maxDiff = std::max(std::max(md[0],md[1]),std::max(md[2],md[3]));
+      maxX = std::max(std::max(mx[0],mx[1]),std::max(mx[2],mx[3]));
+    }
+
+    void weightedDifferenceNorms(const double* __restrict x, double* __restrict previous, const std::size_t n,
+				 const double relativeTolerance, const double absoluteTolerance,
+				 double& sumSquares, double& maxValue)
+    {
+      double s[4] = {0.0, 0.0, 0.0, 0.0};
+      double m[4] = {0.0, 0.0, 0.0, 0.0};
+
+      std::size_t i = 0;
+      for ( ; i + 4 <= n; i += 4) {
+	for (int j = 0; j < 4; ++j) {
+	  const double xi = x[i+j];
+	  const double w = (xi - previous[i+j]) / (relativeTolerance * std::abs(xi) + absoluteTolerance);
+	  const double aw = std::abs(w);
+	  s[j] += w * w;
+	  m[j] = (aw > m[j]) ? aw : m[j];
+	  previous[i+j] = xi;
+	}
+      }
+      for ( ; i < n; ++i) {
+	const double xi = x[i];
+	const double w = (xi - previous[i]) / (relativeTolerance * std::abs(xi) + absoluteTolerance);
+	const double aw = std::abs(w);
+	s[0] += w * w;
+	m[0] = (aw > m[0]) ? aw : m[0];
+	previous[i] = xi;
+      }
+
+      sumSquares = (s[0] + s[1]) + (s[2] + s[3]);
+      maxValue = std::max(std::max(m[0],m[1]),std::max(m[2],m[3]));
+    }
+
+  }
+
+  VectorResponseTolerance::VectorResponseTolerance() :
+    applicationName_("???"),
+    responseName_("???"),
+    responseIndex_(-1),
+    toleranceType_(RELATIVE),
+    normType_(L2),
+    tolerance_(1.0e-4),
+    relativeTolerance_(1.0e-4),
+    absoluteTolerance_(1.0e-8),
+    checkedIteration_(-1),
+    norm_(0.0),
+    threshold_(0.0),
+    status_(pike::UNCHECKED)
+  {
+    validParameters_ = Teuchos::parameterList("Valid Parameters: VectorResponseTolerance");
+    validParameters_->set("Type","Vector Response Tolerance","Type of object to build.");
+    validParameters_->set("Application Name","???","Name of the BlackBoxModelEvaluator that contains the response");
+    validParameters_->set("Response Name","???","Name of the response to check");
+    validParameters_->set("Tolerance Type","Relative","Type of test on the change between iterations: \"Absolute\", \"Relative\" or \"Weighted RMS\"");
+    validParameters_->set("Norm Type","L2","Norm of the change: \"L2\" or \"Linf\"");
+    validParameters_->set("Tolerance",1.0e-4,"Tolerance for the \"Absolute\" and \"Relative\" tolerance types");
+    validParameters_->set("Relative Tolerance",1.0e-4,"Relative part of the weights for the \"Weighted RMS\" tolerance type");
+    validParameters_->set("Absolute Tolerance",1.0e-8,"Absolute part of the weights for the \"Weighted RMS\" tolerance type");
+    Teuchos::setupVerboseObjectSublist(validParameters_.get());
+  }
+
+  pike::SolveStatus VectorResponseTolerance::checkStatus(const pike::Solver& solver, const CheckType checkType)
+  {
+    if (is_null(application_)) {
+      application_ = solver.getModelEvaluator(applicationName_);
+      TEUCHOS_ASSERT(nonnull(application_));
+      responseIndex_ = application_->getResponseIndex(responseName_);
+    }
+
+    if (solver.getNumberOfIterations() == checkedIteration_)
+      return status_; // has already been checked this iteration
+
+    // Store the initial iterate.  The change requires two iterates,
+    // so the first check is always unconverged.
+    if (solver.getNumberOfIterations() == 0) {
+      const Teuchos::ArrayView<const double> x = application_->getResponse(responseIndex_);
+      previousValues_.assign(x.begin(),x.end());
+      checkedIteration_ = 0;
+      norm_ = 0.0;
+      status_ = pike::UNCONVERGED;
+      return status_;
+    }
+
+    if (checkType != pike::COMPLETE) {
+      status_ = pike::UNCHECKED;
+      return status_;
+    }
+
+    const Teuchos::ArrayView<const double> x = application_->getResponse(responseIndex_);
+    TEUCHOS_TEST_FOR_EXCEPTION(static_cast<std::size_t>(x.size()) != previousValues_.size(),
+			       std::logic_error,
+			       "Error: pike::VectorResponseTolerance - the size of the response \"" << responseName_
+			       << "\" in \"" << applicationName_ << "\" changed from " << previousValues_.size()
+			       << " to " << x.size() << " between iterations!");
+
+    this->computeNorm(x);
+    checkedIteration_ = solver.getNumberOfIterations();
+    status_ = (norm_ < threshold_) ? pike::CONVERGED : pike::UNCONVERGED;
+    return status_;
+  }
+
+  void VectorResponseTolerance::computeNorm(const Teuchos::ArrayView<const double>& x)
+  {
+    // Local partial norms: sums of squares and the length are summed,
+    // maxima are maxed over the comm.
+    const std::size_t n = previousValues_.size();
+    double sums[3] = {0.0, 0.0, static_cast<double>(n)};
+    double maxima[2] = {0.0, 0.0};
+    if (n > 0) {
+      if (toleranceType_ == WEIGHTED_RMS)
+	weightedDifferenceNorms(x.getRawPtr(),&previousValues_[0],n,
+				relativeTolerance_,absoluteTolerance_,
+				sums[0],maxima[0]);
+      else
+	differenceNorms(x.getRawPtr(),&previousValues_[0],n,
+			sums[0],maxima[0],sums[1],maxima[1]);
+    }
+
+    if (nonnull(comm_)) {
+      double localSums[3] = {sums[0], sums[1], sums[2]};
+      double localMaxima[2] = {maxima[0], maxima[1]};
+      Teuchos::reduceAll(*comm_,Teuchos::REDUCE_SUM,3,localSums,sums);
+      Teuchos::reduceAll(*comm_,Teuchos::REDUCE_MAX,2,localMaxima,maxima);
+    }
+
+    if (toleranceType_ == WEIGHTED_RMS) {
+      norm_ = (normType_ == L2) ? 
+	((sums[2] > 0.0) ? std::sqrt(sums[0] / sums[2]) : 0.0) :
+	maxima[0];
+      threshold_ = 1.0;
+    }
+    else {
+      norm_ = (normType_ == L2) ? std::sqrt(sums[0]) : maxima[0];
+      if (toleranceType_ == ABSOLUTE)
+	threshold_ = tolerance_;
+      else
+	threshold_ = tolerance_ * ((normType_ == L2) ? std::sqrt(sums[1]) : maxima[1]);
+    }
+  }
+
+  void VectorResponseTolerance::setComm(const Teuchos::RCP<const Teuchos::Comm<int> >& comm)
+  { comm_ = comm; }
+
+  pike::SolveStatus VectorResponseTolerance::getStatus() const
+  { return status_; }
+
+  void VectorResponseTolerance::reset()
+  {
+    status_ = pike::UNCHECKED;
+    checkedIteration_ = -1;
+  }
+
+  double VectorResponseTolerance::getNorm() const
+  { return norm_; }
+
+  void VectorResponseTolerance::describe(Teuchos::FancyOStream &out, const Teuchos::EVerbosityLevel verbLevel) const
+  {
+    const std::string toleranceName = (toleranceType_ == ABSOLUTE) ? "Absolute" :
+      ((toleranceType_ == RELATIVE) ? "Relative" : "Weighted RMS");
+    out << pike::statusToString(status_)
+	<< toleranceName << " " << ((normType_ == L2) ? "L2" : "Linf")
+	<< " change of \"" << responseName_ << "\" in \"" << applicationName_ << "\": "
+	<< norm_ << " must be < " << threshold_
+	<< std::endl;
+  }
+
+  void VectorResponseTolerance::setParameterList(const Teuchos::RCP<Teuchos::ParameterList>& paramList)
+  {
+    paramList->validateParametersAndSetDefaults(*(this->getValidParameters()));
+    this->setMyParamList(paramList);
+    applicationName_ = paramList->get<std::string>("Application Name");
+    responseName_ = paramList->get<std::string>("Response Name");
+    tolerance_ = paramList->get<double>("Tolerance");
+    relativeTolerance_ = paramList->get<double>("Relative Tolerance");
+    absoluteTolerance_ = paramList->get<double>("Absolute Tolerance");
+
+    const std::string toleranceType = paramList->get<std::string>("Tolerance Type");
+    if (toleranceType == "Absolute")
+      toleranceType_ = ABSOLUTE;
+    else if (toleranceType == "Relative")
+      toleranceType_ = RELATIVE;
+    else if (toleranceType == "Weighted RMS")
+      toleranceType_ = WEIGHTED_RMS;
+    else {
+      TEUCHOS_TEST_FOR_EXCEPTION(true, std::logic_error,
+				 "Error: pike::VectorResponseTolerance - the \"Tolerance Type\" \"" << toleranceType
+				 << "\" is not valid!  Choose \"Absolute\", \"Relative\" or \"Weighted RMS\".");
+    }
+
+    const std::string normType = paramList->get<std::string>("Norm Type");
+    if (normType == "L2")
+      normType_ = L2;
+    else if (normType == "Linf")
+      normType_ = LINF;
+    else {
+      TEUCHOS_TEST_FOR_EXCEPTION(true, std::logic_error,
+				 "Error: pike::VectorResponseTolerance - the \"Norm Type\" \"" << normType
+				 << "\" is not valid!  Choose \"L2\" or \"Linf\".");
+    }
+
+    TEUCHOS_TEST_FOR_EXCEPTION( (toleranceType_ == WEIGHTED_RMS) && (absoluteTolerance_ <= 0.0),
+				std::logic_error,
+				"Error: pike::VectorResponseTolerance - the \"Absolute Tolerance\" must be positive for the \"Weighted RMS\" tolerance type!");
+  }
+
+  Teuchos::RCP<const Teuchos::ParameterList> VectorResponseTolerance::getValidParameters() const
+  {
+    return validParameters_;
+  }
+
+}
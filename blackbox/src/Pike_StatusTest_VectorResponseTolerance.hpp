@@ -0,0 +1,107 @@
+#ifndef PIKE_STATUS_TESTS_VECTOR_RESPONSE_TOLERANCE_HPP
+#define PIKE_STATUS_TESTS_VECTOR_RESPONSE_TOLERANCE_HPP
+
+#include "Pike_StatusTest.hpp"
+#include "Teuchos_ParameterListAcceptorDefaultBase.hpp"
+#include "Teuchos_Comm.hpp"
+#include <iostream>
+#include <vector>
+
+namespace pike {
+
+  class BlackBoxModelEvaluator;
+
+  /** \brief Convergence test on the change of a whole response vector between iterations.
+
+      With d = x_k - x_{k-1} for the current response x_k, the test
+      converges when:
+
+      - "Absolute": ||d|| < "Tolerance"
+      - "Relative": ||d|| < "Tolerance" * ||x_k||
+      - "Weighted RMS": ||d_i / ("Relative Tolerance" * |x_k,i| + "Absolute Tolerance")|| < 1
+
+      where the norm is "L2" or "Linf".  For "Weighted RMS" with the
+      L2 norm, the norm is divided by sqrt(n) (root mean square).
+
+      The previous iterate is copied into a buffer that is allocated
+      once.  The norms are computed in a single pass over the
+      response that also updates the buffer.
+
+      This is a costly test for large responses, so it is skipped on
+      pike::MINIMAL checks.  The next complete check then measures
+      the change since the last checked iterate.  Repeated checks of
+      the same iteration return the status of the first check that
+      measured it.
+
+      The norms are local to each process unless the comm the
+      response is distributed over is set with setComm().  Then the
+      sums of squares (and the length for "Weighted RMS") are summed
+      and the maxima are maxed over the comm, so all of its processes
+      compute the norms of the whole response.
+   */
+  class VectorResponseTolerance :
+    public pike::StatusTest,
+    public Teuchos::ParameterListAcceptorDefaultBase {
+
+  public:
+
+    enum ToleranceType {
+      ABSOLUTE,
+      RELATIVE,
+      WEIGHTED_RMS
+    };
+
+    enum NormType {
+      L2,
+      LINF
+    };
+
+    VectorResponseTolerance();
+
+    pike::SolveStatus checkStatus(const pike::Solver& solver, const CheckType checkType = pike::COMPLETE);
+
+    pike::SolveStatus getStatus() const;
+
+    void reset();
+
+    void describe(Teuchos::FancyOStream &out, const Teuchos::EVerbosityLevel verbLevel=verbLevel_default) const;
+
+    void setParameterList(const Teuchos::RCP<Teuchos::ParameterList>& paramList);
+
+    Teuchos::RCP<const Teuchos::ParameterList> getValidParameters() const;
+
+    /** \brief Sets the comm the response is distributed over.
+
+	The norms are then reduced over the comm and checkStatus() is
+	collective over it on complete checks.  Must include all
+	processes of the application.
+    */
+    void setComm(const Teuchos::RCP<const Teuchos::Comm<int> >& comm);
+
+    //! Returns the norm that was compared against the tolerance in the last check.
+    double getNorm() const;
+
+  private:
+    void computeNorm(const Teuchos::ArrayView<const double>& x);
+
+    std::string applicationName_;
+    std::string responseName_;
+    int responseIndex_;
+    ToleranceType toleranceType_;
+    NormType normType_;
+    double tolerance_;
+    double relativeTolerance_;
+    double absoluteTolerance_;
+    int checkedIteration_;
+    std::vector<double> previousValues_;
+    double norm_;
+    double threshold_;
+    pike::SolveStatus status_;
+    Teuchos::RCP<Teuchos::ParameterList> validParameters_;
+    Teuchos::RCP<const pike::BlackBoxModelEvaluator> application_;
+    Teuchos::RCP<const Teuchos::Comm<int> > comm_;
+  };
+
+}
+
+#endif
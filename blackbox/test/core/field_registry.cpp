@@ -0,0 +1,95 @@
+#include "Teuchos_UnitTestHarness.hpp"
+#include "Pike_BlackBox_config.hpp"
+#include "Pike_FieldRegistry.hpp"
+#include "Pike_DataTransfer_FieldRegistry.hpp"
+#include "Pike_Solver_BlockJacobi.hpp"
+
+namespace pike_test {
+
+  TEUCHOS_UNIT_TEST(field_registry, double_buffering)
+  {
+    Teuchos::RCP<pike::FieldRegistry> registry = pike::fieldRegistry();
+    registry->registerField("power",3,1.0);
+
+    TEST_ASSERT(registry->hasField("power"));
+    TEST_ASSERT(!registry->hasField("temperature"));
+    TEST_EQUALITY(registry->getFieldSize("power"),3);
+    TEST_EQUALITY(registry->getVersion("power"),0);
+    TEST_THROW(registry->registerField("power",3), std::logic_error);
+    TEST_THROW(registry->getTargetView("temperature"), std::logic_error);
+
+    // Source writes the back buffer, targets still see the old values
+    Teuchos::ArrayView<double> source = registry->getNonconstSourceBuffer("power");
+    for (int i = 0; i < source.size(); ++i)
+      source[i] = 10.0 + i;
+    TEST_EQUALITY(registry->getTargetView("power")[0], 1.0);
+
+    // Publishing swaps the buffers without copying
+    const double* sourcePtr = source.getRawPtr();
+    registry->publish("power");
+    Teuchos::ArrayView<const double> target = registry->getTargetView("power");
+    TEST_EQUALITY(target.getRawPtr(), sourcePtr);
+    TEST_EQUALITY(target[0], 10.0);
+    TEST_EQUALITY(target[2], 12.0);
+    TEST_EQUALITY(registry->getVersion("power"),1);
+    TEST_ASSERT(registry->getNonconstSourceBuffer("power").getRawPtr() != sourcePtr);
+
+    // Only fields written since their last publish are swapped
+    registry->registerField("temperature",2);
+    registry->publishAll();
+    TEST_EQUALITY(registry->getVersion("power"),2);
+    TEST_EQUALITY(registry->getVersion("temperature"),0);
+    TEST_EQUALITY(registry->getFieldNames().size(),2);
+
+    // Publishing again without a new write keeps the published values
+    registry->getNonconstSourceBuffer("temperature")[0] = 3.0;
+    TEST_ASSERT(registry->publish("temperature"));
+    TEST_ASSERT(!registry->publish("temperature"));
+    registry->publishAll();
+    TEST_EQUALITY(registry->getVersion("temperature"),1);
+    TEST_EQUALITY(registry->getTargetView("temperature")[0], 3.0);
+  }
+
+  TEUCHOS_UNIT_TEST(field_registry, data_transfer)
+  {
+    Teuchos::RCP<pike::FieldRegistry> registry = pike::fieldRegistry();
+    registry->registerField("power",2);
+    registry->registerField("temperature",2);
+
+    Teuchos::RCP<pike::FieldRegistryDataTransfer> transfer = 
+      pike::fieldRegistryDataTransfer("neutronics->thermal",registry);
+    transfer->addField("power");
+    transfer->addSourceModelName("neutronics");
+    transfer->addTargetModelName("thermal");
+    TEST_THROW(transfer->addField("flux"), std::logic_error);
+
+    TEST_EQUALITY(transfer->name(),"neutronics->thermal");
+    TEST_EQUALITY(transfer->getSourceModelNames()[0],"neutronics");
+    TEST_EQUALITY(transfer->getTargetModelNames()[0],"thermal");
+
+    registry->getNonconstSourceBuffer("power")[1] = 5.0;
+    registry->getNonconstSourceBuffer("temperature")[1] = 7.0;
+
+    pike::BlockJacobi solver;
+    TEST_ASSERT(transfer->doTransfer(solver));
+    TEST_ASSERT(transfer->transferSucceeded());
+
+    // Only the fields added to the transfer are published
+    TEST_EQUALITY(registry->getTargetView("power")[1], 5.0);
+    TEST_EQUALITY(registry->getTargetView("temperature")[1], 0.0);
+
+    // Repeated transfers without a new write by the source (e.g. a
+    // Gauss-Seidel sweep running the transfer once per target) keep
+    // the published values
+    TEST_ASSERT(transfer->doTransfer(solver));
+    TEST_ASSERT(transfer->doTransfer(solver));
+    TEST_EQUALITY(registry->getTargetView("power")[1], 5.0);
+    TEST_EQUALITY(registry->getVersion("power"),1);
+
+    registry->getNonconstSourceBuffer("power")[1] = 6.0;
+    TEST_ASSERT(transfer->doTransfer(solver));
+    TEST_EQUALITY(registry->getTargetView("power")[1], 6.0);
+    TEST_EQUALITY(registry->getVersion("power"),2);
+  }
+
+}
@@ -0,0 +1,110 @@
+#include "Teuchos_UnitTestHarness.hpp"
+#include "Teuchos_DefaultComm.hpp"
+#include "Teuchos_ParameterList.hpp"
+#include "Pike_BlackBox_config.hpp"
+
+#include "Pike_FiniteDifferenceSensitivity.hpp"
+#include "Pike_Solver_BlockGaussSeidel.hpp"
+#include "Pike_BlackBoxModelEvaluator_SolverAdapter.hpp"
+#include "Pike_StatusTest_GlobalModelConvergence.hpp"
+#include "Pike_LinearHeatConduction_ModelEvaluator.hpp"
+#include "Pike_LinearHeatConduction_DataTransfer.hpp"
+#include <cmath>
+
+namespace pike_test {
+
+  // Builds two coupled walls wrapped in a solver adapter:
+  //   left wall:  T_right = T_left - q / k  (parameter "q", response "T_right")
+  //   right wall: q = (T_left - T_right) * k  (parameter "T_right", response "q")
+  // The transfer sets T_left of the right wall to half of T_right of
+  // the left wall (the damping factor of the test transfer).
+  Teuchos::RCP<pike::SolverAdapterModelEvaluator> 
+  buildWalls(const Teuchos::RCP<const Teuchos::Comm<int> >& comm)
+  {
+    Teuchos::RCP<LinearHeatConductionModelEvaluator> leftWall = 
+      linearHeatConductionModelEvaluator(comm,"left wall",LinearHeatConductionModelEvaluator::T_RIGHT_IS_RESPONSE);
+    leftWall->set_T_left(7.0);
+    leftWall->set_k(2.0);
+
+    Teuchos::RCP<LinearHeatConductionModelEvaluator> rightWall = 
+      linearHeatConductionModelEvaluator(comm,"right wall",LinearHeatConductionModelEvaluator::Q_IS_RESPONSE);
+    rightWall->set_T_left(4.0);
+    rightWall->set_k(1.0/3.0);
+
+    Teuchos::RCP<LinearHeatConductionDataTransfer> transfer = 
+      linearHeatConductionDataTransfer(comm,"T: left->right",LinearHeatConductionDataTransfer::TRANSFER_T);
+    transfer->setSource(leftWall);
+    transfer->addTarget(rightWall);
+
+    Teuchos::RCP<pike::GlobalModelConvergence> converged = Teuchos::rcp(new pike::GlobalModelConvergence);
+    {
+      Teuchos::RCP<Teuchos::ParameterList> p = Teuchos::parameterList();
+      p->set("Type","Global Model Convergence");
+      p->set("Model Name","left wall");
+      converged->setParameterList(p);
+    }
+
+    Teuchos::RCP<pike::BlockGaussSeidel> solver = Teuchos::rcp(new pike::BlockGaussSeidel);
+    solver->registerModelEvaluator(leftWall);
+    solver->registerModelEvaluator(rightWall);
+    solver->registerDataTransfer(transfer);
+    solver->completeRegistration();
+    solver->setStatusTests(converged);
+
+    Teuchos::RCP<pike::SolverAdapterModelEvaluator> walls = 
+      Teuchos::rcp(new pike::SolverAdapterModelEvaluator("walls"));
+    walls->setSolver(solver);
+    return walls;
+  }
+
+  TEUCHOS_UNIT_TEST(finite_difference_sensitivity, lanes)
+  {
+    Teuchos::RCP<const Teuchos::Comm<int> > globalComm = Teuchos::DefaultComm<int>::getComm();
+
+    const std::vector<std::string> differenceTypes = {"Forward","Central"};
+    const std::vector<bool> warmStarts = {true,false};
+
+    for (std::vector<std::string>::const_iterator type = differenceTypes.begin(); type != differenceTypes.end(); ++type) {
+      for (std::vector<bool>::const_iterator warmStart = warmStarts.begin(); warmStart != warmStarts.end(); ++warmStart) {
+
+	pike::FiniteDifferenceSensitivity fd(globalComm,globalComm->getSize());
+	Teuchos::RCP<Teuchos::ParameterList> p = Teuchos::parameterList();
+	p->set("Difference Type",*type);
+	p->set("Warm Start From Nominal",*warmStart);
+	fd.setParameterList(p);
+
+	TEST_EQUALITY(fd.getNumberOfLanes(),globalComm->getSize());
+	TEST_EQUALITY(fd.getLaneIndex(),globalComm->getRank());
+	TEST_EQUALITY(fd.getLaneComm()->getSize(),1);
+
+	Teuchos::RCP<pike::SolverAdapterModelEvaluator> walls = buildWalls(fd.getLaneComm());
+	fd.setModel(walls);
+
+	const int q = walls->getParameterIndex("q");
+	const int T_right = walls->getParameterIndex("T_right");
+	std::vector<std::vector<double> > nominal(walls->getNumberOfParameters());
+	nominal[q] = std::vector<double>(1,1.0);
+	nominal[T_right] = std::vector<double>(1,1.0);
+
+	fd.computeSensitivities(nominal);
+
+	TEST_ASSERT(fd.allSolvesConverged());
+	TEST_EQUALITY(fd.getNumberOfRows(),2);
+	TEST_EQUALITY(fd.getNumberOfColumns(),2);
+
+	const int gT = walls->getResponseIndex("T_right");
+	const int gq = walls->getResponseIndex("q");
+	const double tol = 1.0e-6;
+	TEST_FLOATING_EQUALITY(fd.getNominalResponse(gT)[0],6.5,tol);
+	TEST_FLOATING_EQUALITY(fd.getNominalResponse(gq)[0],0.75,tol);
+	TEST_FLOATING_EQUALITY(fd.getSensitivity(gT,0,q,0),-0.5,tol);
+	TEST_FLOATING_EQUALITY(fd.getSensitivity(gq,0,T_right,0),-1.0/3.0,tol);
+	TEST_ASSERT(std::abs(fd.getSensitivity(gT,0,T_right,0)) < tol);
+	// Through the transfer: dq/dq = 0.5 * (-1/2) * (1/3)
+	TEST_FLOATING_EQUALITY(fd.getSensitivity(gq,0,q,0),-1.0/12.0,tol);
+	TEST_EQUALITY(fd.getSensitivityColumn(q).size(),2);
+      }
+    }
+  }
+
+}
@@ -2,6 +2,7 @@
 #include "Teuchos_ParameterList.hpp"
 #include "Teuchos_DefaultComm.hpp"
 #include <iostream>
+#include <algorithm>
 
 // Prerequisites for testing
 #include "Pike_Mock_ModelEvaluator.hpp"
@@ -17,6 +18,8 @@
 #include "Pike_SolverObserver_Logger.hpp"
 #include "Pike_BlackBoxModelEvaluator_Logger.hpp"
 #include "Pike_DataTransfer_Logger.hpp"
+#include "Pike_BlackBoxModelEvaluator_Caching.hpp"
+#include "Pike_LinearHeatConduction_ModelEvaluator.hpp"
 
 namespace pike {
 
@@ -142,4 +145,125 @@ namespace pike {
     TEST_EQUALITY(*(trans1To2Logged->getTargetModelNames().begin()), "app2");
   }
 
+  TEUCHOS_UNIT_TEST(decorators, caching)
+  {
+    Teuchos::RCP<const Teuchos::Comm<int> > comm = Teuchos::DefaultComm<int>::getComm();
+
+    // T_right = T_left - q / k
+    Teuchos::RCP<pike_test::LinearHeatConductionModelEvaluator> wall = 
+      pike_test::linearHeatConductionModelEvaluator(comm,"wall",pike_test::LinearHeatConductionModelEvaluator::T_RIGHT_IS_RESPONSE);
+    wall->set_T_left(7.0);
+    wall->set_k(1.0);
+
+    // Log the solves that reach the wrapped model
+    Teuchos::RCP<pike::ModelEvaluatorLogger> wallLogged = pike::modelEvaluatorLogger(wall);
+    Teuchos::RCP<std::vector<std::string> > log = wallLogged->getNonConstLog();
+
+    Teuchos::RCP<pike::CachingModelEvaluator> cached = pike::cachingModelEvaluator(wallLogged);
+    cached->registerComm(comm);
+    {
+      Teuchos::RCP<Teuchos::ParameterList> p = Teuchos::parameterList("Cache");
+      cached->setParameterList(p);
+    }
+    TEST_EQUALITY(cached->name(), "wall");
+
+    const int q = cached->getParameterIndex("q");
+    const int T_right = cached->getResponseIndex("T_right");
+    Teuchos::Array<double> value(1);
+
+    value[0] = 1.0;
+    cached->setParameter(q,value);
+    cached->solve();
+    TEST_EQUALITY(cached->getResponse(T_right)[0], 6.0);
+
+    value[0] = 2.0;
+    cached->setParameter(q,value);
+    cached->solve();
+    TEST_EQUALITY(cached->getResponse(T_right)[0], 5.0);
+
+    // Revisit the first point: answered from the cache
+    value[0] = 1.0;
+    cached->setParameter(q,value);
+    cached->solve();
+    TEST_EQUALITY(cached->getResponse(T_right)[0], 6.0);
+    TEST_ASSERT(cached->isLocallyConverged());
+
+    TEST_EQUALITY(std::count(log->begin(),log->end(),"wall: solve()"), 2);
+    TEST_EQUALITY(cached->getNumberOfCacheMisses(), 2);
+    TEST_EQUALITY(cached->getNumberOfCacheHits(), 1);
+    TEST_EQUALITY(cached->getNumberOfCachedEntries(), 2);
+    TEST_EQUALITY(cached->getMemoryUsage(), 4*sizeof(double));
+
+    // Shrink the budget to a single entry and spill the least
+    // recently used entry (q=2) to disk
+    {
+      Teuchos::RCP<Teuchos::ParameterList> p = Teuchos::parameterList("Cache");
+      p->set("Memory Budget (MB)", 3.0*sizeof(double)/(1024.0*1024.0));
+      p->set("Disk Cache Directory", ".");
+      cached->setParameterList(p);
+    }
+    TEST_EQUALITY(cached->getNumberOfCachedEntries(), 1);
+
+    value[0] = 2.0;
+    cached->setParameter(q,value);
+    cached->solve();
+    TEST_EQUALITY(cached->getResponse(T_right)[0], 5.0);
+    TEST_EQUALITY(cached->getNumberOfDiskCacheHits(), 1);
+    TEST_EQUALITY(cached->getNumberOfCachedEntries(), 1);
+    TEST_EQUALITY(std::count(log->begin(),log->end(),"wall: solve()"), 2);
+
+    // A new point must solve the wrapped model
+    value[0] = 3.0;
+    cached->setParameter(q,value);
+    cached->solve();
+    TEST_EQUALITY(cached->getResponse(T_right)[0], 4.0);
+    TEST_EQUALITY(cached->getNumberOfCacheMisses(), 3);
+    TEST_EQUALITY(std::count(log->begin(),log->end(),"wall: solve()"), 3);
+
+    // After clearing, every point is a miss again
+    cached->clearCache();
+    TEST_EQUALITY(cached->getNumberOfCachedEntries(), 0);
+    value[0] = 1.0;
+    cached->setParameter(q,value);
+    cached->solve();
+    TEST_EQUALITY(cached->getResponse(T_right)[0], 6.0);
+    TEST_EQUALITY(cached->getNumberOfCacheMisses(), 4);
+    TEST_EQUALITY(std::count(log->begin(),log->end(),"wall: solve()"), 4);
+
+    // A point that misses on one process misses on all of them, and
+    // the stale entry is replaced instead of duplicated
+    if (comm->getRank() == 0)
+      cached->clearCache();
+    cached->solve();
+    TEST_EQUALITY(cached->getResponse(T_right)[0], 6.0);
+    TEST_EQUALITY(cached->getNumberOfCacheMisses(), 5);
+    TEST_EQUALITY(cached->getNumberOfCacheHits(), 2);
+    TEST_EQUALITY(cached->getNumberOfCachedEntries(), 1);
+    TEST_EQUALITY(std::count(log->begin(),log->end(),"wall: solve()"), 5);
+
+    // The responses of a hit are still served after its entry is
+    // evicted or cleared, although the wrapped model last solved
+    // another point
+    value[0] = 5.0;
+    cached->setParameter(q,value);
+    cached->solve();
+    TEST_EQUALITY(cached->getResponse(T_right)[0], 2.0);
+    value[0] = 1.0;
+    cached->setParameter(q,value);
+    cached->solve();
+    TEST_EQUALITY(cached->getNumberOfCacheHits(), 3);
+    TEST_EQUALITY(wall->getResponse(T_right)[0], 2.0);
+    {
+      Teuchos::RCP<Teuchos::ParameterList> p = Teuchos::parameterList("Cache");
+      p->set("Memory Budget (MB)", 0.0);
+      cached->setParameterList(p);
+    }
+    TEST_EQUALITY(cached->getNumberOfCachedEntries(), 0);
+    TEST_EQUALITY(cached->getMemoryUsage(), 0);
+    TEST_EQUALITY(cached->getResponse(T_right)[0], 6.0);
+    TEST_ASSERT(cached->isLocallyConverged());
+    cached->clearCache();
+    TEST_EQUALITY(cached->getResponse(T_right)[0], 6.0);
+  }
+
 }
@@ -2,8 +2,12 @@
 #include "Teuchos_UnitTestHarness.hpp"
 #include "Teuchos_RCP.hpp"
 #include "Teuchos_TimeMonitor.hpp"
+#include <set>
 
 #include "Pike_MultiphysicsDistributor.hpp"
+#include "Pike_SharedMemoryBuffer.hpp"
+#include "Pike_NeighborExchange.hpp"
+#include "Pike_RmaTransferWindow.hpp"
 
 namespace pike {
 
@@ -355,4 +359,440 @@ namespace pike {
 
   }
   
+  TEUCHOS_UNIT_TEST(MultiphysicsDistributor, shared_memory_transfer)
+  {
+    Teuchos::RCP<Teuchos::MpiComm<int> > globalComm = 
+      Teuchos::rcp(new Teuchos::MpiComm<int>(Teuchos::opaqueWrapper(MPI_COMM_WORLD)));
+
+    // Run this on 6 processes only
+    TEST_EQUALITY(globalComm->getSize(), 6);
+
+    typedef pike::MultiphysicsDistributor::ApplicationIndex AppIndex;
+    typedef pike::MultiphysicsDistributor::TransferIndex TransIndex;
+
+    pike::MultiphysicsDistributor dist;
+    AppIndex CTF = dist.addApplication("CTF",0,2);
+    AppIndex Insilico = dist.addApplication("Insilico",3,5);
+    TransIndex CTF_Insilico = dist.addTransfer("C_TO_I: ",CTF,Insilico);
+    std::vector<int> ranks(2);
+    ranks[0] = 0;
+    ranks[1] = 1;
+    TransIndex CTF_Only = dist.addTransferByRanks("C_TO_C: ",ranks);
+    dist.setup(globalComm,false);
+
+    // The node comm is a subset of the transfer comm, built once on
+    // the first request
+    TEST_ASSERT(nonnull(dist.getTransferNodeComm(CTF_Insilico)));
+    TEST_EQUALITY(dist.getTransferNodeComm(CTF_Insilico).get(),
+		  dist.getTransferNodeComm(CTF_Insilico).get());
+    TEST_ASSERT(dist.getTransferNodeComm(CTF_Insilico)->getSize() <= dist.getTransferComm(CTF_Insilico)->getSize());
+    TEST_EQUALITY(dist.transferIsNodeLocal(CTF_Insilico),
+		  (dist.getTransferNodeComm(CTF_Insilico)->getSize() == 6));
+
+    if (dist.transferExistsOnProcess(CTF_Only)) {
+      TEST_ASSERT(nonnull(dist.getTransferNodeComm(CTF_Only)));
+    }
+    else {
+      TEST_ASSERT(is_null(dist.getTransferNodeComm(CTF_Only)));
+      TEST_EQUALITY(dist.transferIsNodeLocal(CTF_Only),false);
+      TEST_THROW(dist.createTransferSharedMemoryBuffer(CTF_Only,1), std::logic_error);
+    }
+
+    // Each process owns a segment of size rank+1 and fills it with
+    // its rank.  Every process then reads all segments of the node
+    // directly.
+    Teuchos::RCP<const Teuchos::Comm<int> > nodeComm = dist.getTransferNodeComm(CTF_Insilico);
+    const int myRank = nodeComm->getRank();
+    Teuchos::RCP<pike::SharedMemoryBuffer> buffer = 
+      dist.createTransferSharedMemoryBuffer(CTF_Insilico,myRank+1);
+    TEST_EQUALITY(buffer->getComm()->getSize(), nodeComm->getSize());
+
+    Teuchos::ArrayView<double> local = buffer->getLocalView();
+    TEST_EQUALITY(local.size(), myRank+1);
+    for (Teuchos::ArrayView<double>::iterator v = local.begin(); v != local.end(); ++v)
+      *v = static_cast<double>(myRank);
+
+    buffer->synchronize();
+
+    for (int r = 0; r < nodeComm->getSize(); ++r) {
+      Teuchos::ArrayView<const double> remote = buffer->getView(r);
+      TEST_EQUALITY(buffer->getSize(r), static_cast<std::size_t>(r+1));
+      TEST_EQUALITY(remote.size(), r+1);
+      for (Teuchos::ArrayView<const double>::iterator v = remote.begin(); v != remote.end(); ++v)
+	TEST_EQUALITY(*v, static_cast<double>(r));
+    }
+
+    // Store into the next process's segment and read it back on that
+    // process
+    buffer->synchronize();
+    const int next = (myRank + 1) % nodeComm->getSize();
+    buffer->getNonconstView(next)[0] = 100.0 + myRank;
+    buffer->synchronize();
+    const int previous = (myRank + nodeComm->getSize() - 1) % nodeComm->getSize();
+    TEST_EQUALITY(buffer->getLocalView()[0], 100.0 + previous);
+  }
+
+  TEUCHOS_UNIT_TEST(MultiphysicsDistributor, persistent_neighbor_exchange)
+  {
+    Teuchos::RCP<Teuchos::MpiComm<int> > globalComm = 
+      Teuchos::rcp(new Teuchos::MpiComm<int>(Teuchos::opaqueWrapper(MPI_COMM_WORLD)));
+
+    // Run this on 6 processes only
+    TEST_EQUALITY(globalComm->getSize(), 6);
+
+    typedef pike::MultiphysicsDistributor::ApplicationIndex AppIndex;
+    typedef pike::MultiphysicsDistributor::TransferIndex TransIndex;
+
+    pike::MultiphysicsDistributor dist;
+    AppIndex CTF = dist.addApplication("CTF",0,2);
+    AppIndex Insilico = dist.addApplication("Insilico",3,5);
+    TransIndex CTF_Insilico = dist.addTransfer("C_TO_I: ",CTF,Insilico);
+    std::vector<int> ranks(2);
+    ranks[0] = 0;
+    ranks[1] = 1;
+    TransIndex CTF_Only = dist.addTransferByRanks("C_TO_C: ",ranks);
+    dist.setup(globalComm,false);
+
+    if (!dist.transferExistsOnProcess(CTF_Only)) {
+      std::vector<int> empty;
+      TEST_THROW(dist.createTransferNeighborExchange(CTF_Only,empty,empty,empty,empty), std::logic_error);
+    }
+
+    // CTF transfer rank i sends i+1 values to Insilico transfer rank
+    // i+3 and gets one value back.
+    const int myRank = dist.getTransferComm(CTF_Insilico)->getRank();
+    const bool isCTF = dist.appExistsOnProcess(CTF);
+    const int partner = isCTF ? myRank + 3 : myRank - 3;
+    const int ctfRank = isCTF ? myRank : partner;
+    std::vector<int> neighbors(1,partner);
+    std::vector<int> receiveCounts(1, isCTF ? 1 : ctfRank+1);
+    std::vector<int> sendCounts(1, isCTF ? ctfRank+1 : 1);
+
+    // Mismatched pattern sizes or bad ranks on a single process throw
+    // on all processes
+    TEST_THROW(dist.createTransferNeighborExchange(CTF_Insilico,neighbors,
+						   (myRank == 4) ? std::vector<int>() : receiveCounts,
+						   neighbors,sendCounts), std::logic_error);
+    TEST_THROW(dist.createTransferNeighborExchange(CTF_Insilico,neighbors,receiveCounts,
+						   (myRank == 1) ? std::vector<int>(1,6) : neighbors,
+						   sendCounts), std::logic_error);
+
+    Teuchos::RCP<pike::NeighborExchange> exchange = 
+      dist.createTransferNeighborExchange(CTF_Insilico,neighbors,receiveCounts,neighbors,sendCounts);
+    TEST_EQUALITY(exchange->getNumberOfSources(), 1);
+    TEST_EQUALITY(exchange->getNumberOfDestinations(), 1);
+    TEST_EQUALITY(exchange->getGraphComm()->getRank(), myRank);
+    TEST_EQUALITY(exchange->getNonconstSendView(0).size(), sendCounts[0]);
+    TEST_EQUALITY(exchange->getReceiveView(0).size(), receiveCounts[0]);
+
+    // Repeat the same pattern with new values each iteration
+    for (int iteration = 0; iteration < 3; ++iteration) {
+      Teuchos::ArrayView<double> send = exchange->getNonconstSendView(0);
+      for (int i = 0; i < send.size(); ++i)
+	send[i] = 10.0 * iteration + myRank + i;
+
+      if (iteration == 1) {
+	exchange->start();
+	TEST_THROW(exchange->start(), std::logic_error);
+	exchange->wait();
+      }
+      else
+	exchange->exchange();
+
+      Teuchos::ArrayView<const double> receive = exchange->getReceiveView(0);
+      for (int i = 0; i < receive.size(); ++i)
+	TEST_EQUALITY(receive[i], 10.0 * iteration + partner + i);
+    }
+
+    TEST_EQUALITY(exchange->getNumberOfExchanges(), 3);
+    TEST_THROW(exchange->wait(), std::logic_error);
+  }
+
+  TEUCHOS_UNIT_TEST(MultiphysicsDistributor, rma_transfer)
+  {
+    Teuchos::RCP<Teuchos::MpiComm<int> > globalComm = 
+      Teuchos::rcp(new Teuchos::MpiComm<int>(Teuchos::opaqueWrapper(MPI_COMM_WORLD)));
+
+    // Run this on 6 processes only
+    TEST_EQUALITY(globalComm->getSize(), 6);
+
+    typedef pike::MultiphysicsDistributor::ApplicationIndex AppIndex;
+    typedef pike::MultiphysicsDistributor::TransferIndex TransIndex;
+
+    pike::MultiphysicsDistributor dist;
+    AppIndex CTF = dist.addApplication("CTF",0,2);
+    AppIndex Insilico = dist.addApplication("Insilico",3,5);
+    TransIndex CTF_Insilico = dist.addTransfer("C_TO_I: ",CTF,Insilico);
+    std::vector<int> ranks(2);
+    ranks[0] = 0;
+    ranks[1] = 1;
+    TransIndex CTF_Only = dist.addTransferByRanks("C_TO_C: ",ranks);
+    dist.setup(globalComm,false);
+
+    if (!dist.transferExistsOnProcess(CTF_Only)) {
+      TEST_THROW(dist.createTransferRmaWindow(CTF_Only,1), std::logic_error);
+    }
+
+    // Every CTF process puts two values into a different part of
+    // the segment of each Insilico process.
+    Teuchos::RCP<const Teuchos::Comm<int> > transferComm = dist.getTransferComm(CTF_Insilico);
+    const int myRank = transferComm->getRank();
+    const bool isCTF = dist.appExistsOnProcess(CTF);
+    Teuchos::RCP<pike::RmaTransferWindow> window = 
+      dist.createTransferRmaWindow(CTF_Insilico, isCTF ? 0 : 6);
+    TEST_EQUALITY(window->getVersion(), 0);
+
+    const int numIterations = 3;
+    for (int iteration = 0; iteration < numIterations; ++iteration) {
+      if (isCTF) {
+	std::vector<double> values(2);
+	values[0] = 100.0 * iteration + myRank;
+	values[1] = -values[0];
+	for (int target = 3; target < 6; ++target) {
+	  window->put(target,2*myRank,Teuchos::arrayViewFromVector(values));
+	  window->publish(target);
+	}
+      }
+      else {
+	const long version = window->waitForVersion(3*(iteration+1));
+	TEST_ASSERT(version >= 3*(iteration+1));
+	Teuchos::ArrayView<const double> local = window->getLocalView();
+	TEST_EQUALITY(local.size(), 6);
+	for (int source = 0; source < 3; ++source) {
+	  TEST_EQUALITY(local[2*source], 100.0 * iteration + source);
+	  TEST_EQUALITY(local[2*source+1], -(100.0 * iteration + source));
+	}
+      }
+      // Order the iterations so sources do not overwrite unread data
+      transferComm->barrier();
+    }
+
+    if (isCTF) {
+      TEST_EQUALITY(window->getVersion(), 0);
+      TEST_EQUALITY(window->getLocalView().size(), 0);
+    }
+    else {
+      TEST_EQUALITY(window->getVersion(), 3*numIterations);
+    }
+  }
+
+  TEUCHOS_UNIT_TEST(MultiphysicsDistributor, automatic_placement)
+  {
+    Teuchos::RCP<Teuchos::MpiComm<int> > globalComm = 
+      Teuchos::rcp(new Teuchos::MpiComm<int>(Teuchos::opaqueWrapper(MPI_COMM_WORLD)));
+
+    // Run this on 6 processes only
+    TEST_EQUALITY(globalComm->getSize(), 6);
+
+    typedef pike::MultiphysicsDistributor::ApplicationIndex AppIndex;
+    typedef pike::MultiphysicsDistributor::TransferIndex TransIndex;
+
+    // Explicit and automatic placement can not be mixed
+    {
+      pike::MultiphysicsDistributor dist;
+      dist.addApplication("CTF",0,1);
+      TEST_THROW(dist.addApplicationByCount("Insilico",2), std::logic_error);
+    }
+    {
+      pike::MultiphysicsDistributor dist;
+      dist.addApplicationByCount("CTF",2);
+      TEST_THROW(dist.addApplication("Insilico",2,3), std::logic_error);
+      TEST_THROW(dist.addApplicationByCount("Peregrine",0), std::logic_error);
+    }
+    // Too many processes requested
+    {
+      pike::MultiphysicsDistributor dist;
+      dist.addApplicationByCount("CTF",4);
+      dist.addApplicationByCount("Insilico",3);
+      TEST_THROW(dist.setup(globalComm,false), std::logic_error);
+    }
+
+    // CTF is weakly coupled to Insilico and strongly coupled to
+    // Peregrine, so it should be placed next to Peregrine.
+    pike::MultiphysicsDistributor dist;
+    AppIndex CTF = dist.addApplicationByCount("CTF",2);
+    AppIndex Insilico = dist.addApplicationByCount("Insilico",2);
+    AppIndex Peregrine = dist.addApplicationByCount("Peregrine",2);
+    TransIndex CTF_Insilico = dist.addTransfer("C_TO_I: ",CTF,Insilico,1.0);
+    TransIndex CTF_Peregrine = dist.addTransfer("C_TO_P: ",CTF,Peregrine,100.0);
+    dist.setup(globalComm,true);
+
+    TEST_EQUALITY(dist.getTransferVolume(CTF_Insilico), 1.0);
+    TEST_EQUALITY(dist.getTransferVolume(CTF_Peregrine), 100.0);
+
+    std::vector<int> ctfRanks;
+    ctfRanks.push_back(0);
+    ctfRanks.push_back(1);
+    std::vector<int> peregrineRanks;
+    peregrineRanks.push_back(2);
+    peregrineRanks.push_back(3);
+    std::vector<int> insilicoRanks;
+    insilicoRanks.push_back(4);
+    insilicoRanks.push_back(5);
+    TEST_ASSERT(dist.getApplicationRanks(CTF) == ctfRanks);
+    TEST_ASSERT(dist.getApplicationRanks(Peregrine) == peregrineRanks);
+    TEST_ASSERT(dist.getApplicationRanks(Insilico) == insilicoRanks);
+    TEST_EQUALITY(dist.getPrintRank(Peregrine), 2);
+
+    const int myRank = globalComm->getRank();
+    TEST_EQUALITY(dist.appExistsOnProcess(CTF), (myRank < 2));
+    TEST_EQUALITY(dist.appExistsOnProcess(Peregrine), ((myRank == 2) || (myRank == 3)));
+    TEST_EQUALITY(dist.appExistsOnProcess(Insilico), (myRank > 3));
+    TEST_EQUALITY(dist.transferExistsOnProcess(CTF_Peregrine), (myRank < 4));
+
+    // Node layout depends on the machine
+    TEST_ASSERT(dist.getNumberOfNodes() >= 1);
+    TEST_ASSERT(dist.getNodeIndex(myRank) < dist.getNumberOfNodes());
+    TEST_ASSERT(dist.getEstimatedInterNodeVolume() >= 0.0);
+    TEST_ASSERT(dist.getEstimatedInterNodeVolume() <= 101.0);
+    if (dist.getNumberOfNodes() == 1) {
+      TEST_EQUALITY(dist.getEstimatedInterNodeVolume(), 0.0);
+    }
+  }
+
+  TEUCHOS_UNIT_TEST(MultiphysicsDistributor, automatic_placement_on_simulated_nodes)
+  {
+    Teuchos::RCP<Teuchos::MpiComm<int> > globalComm = 
+      Teuchos::rcp(new Teuchos::MpiComm<int>(Teuchos::opaqueWrapper(MPI_COMM_WORLD)));
+
+    // Run this on 6 processes only
+    TEST_EQUALITY(globalComm->getSize(), 6);
+
+    typedef pike::MultiphysicsDistributor::ApplicationIndex AppIndex;
+
+    {
+      pike::MultiphysicsDistributor dist;
+      TEST_THROW(dist.setProcessesPerNode(0), std::logic_error);
+    }
+
+    // Two nodes of three processes.  Packing CTF, Insilico, Peregrine
+    // in node-major order would split Insilico over both nodes.
+    {
+      pike::MultiphysicsDistributor dist;
+      dist.setProcessesPerNode(3);
+      AppIndex CTF = dist.addApplicationByCount("CTF",2);
+      AppIndex Insilico = dist.addApplicationByCount("Insilico",3);
+      AppIndex Peregrine = dist.addApplicationByCount("Peregrine",1);
+      dist.addTransfer("C_TO_I: ",CTF,Insilico,100.0);
+      dist.addTransfer("C_TO_P: ",CTF,Peregrine,1.0);
+      dist.setup(globalComm,false);
+
+      TEST_EQUALITY(dist.getNumberOfNodes(), 2);
+      for (int r = 0; r < 6; ++r)
+	TEST_EQUALITY(dist.getNodeIndex(r), r / 3);
+
+      // No application is split
+      for (AppIndex app = 0; app < 3; ++app) {
+	const std::vector<int>& ranks = dist.getApplicationRanks(app);
+	for (std::vector<int>::const_iterator r = ranks.begin(); r != ranks.end(); ++r)
+	  TEST_EQUALITY(dist.getNodeIndex(*r), dist.getNodeIndex(ranks[0]));
+      }
+      TEST_EQUALITY(dist.getApplicationRanks(CTF).size(), 2);
+      TEST_EQUALITY(dist.getApplicationRanks(Insilico).size(), 3);
+      TEST_EQUALITY(dist.getApplicationRanks(Peregrine).size(), 1);
+
+      // CTF and Peregrine share a node, Insilico is alone on the
+      // other one, so only the CTF/Insilico transfer crosses nodes.
+      TEST_EQUALITY(dist.getNodeIndex(dist.getApplicationRanks(Peregrine)[0]),
+		    dist.getNodeIndex(dist.getApplicationRanks(CTF)[0]));
+      TEST_FLOATING_EQUALITY(dist.getEstimatedInterNodeVolume(), 100.0, 1.0e-12);
+    }
+
+    // Three nodes of two processes.  An application larger than a
+    // node spans as few nodes as possible.
+    {
+      pike::MultiphysicsDistributor dist;
+      dist.setProcessesPerNode(2);
+      AppIndex CTF = dist.addApplicationByCount("CTF",4);
+      AppIndex Insilico = dist.addApplicationByCount("Insilico",2);
+      dist.addTransfer("C_TO_I: ",CTF,Insilico);
+      dist.setup(globalComm,false);
+
+      TEST_EQUALITY(dist.getNumberOfNodes(), 3);
+      std::set<int> ctfNodes;
+      const std::vector<int>& ctfRanks = dist.getApplicationRanks(CTF);
+      for (std::vector<int>::const_iterator r = ctfRanks.begin(); r != ctfRanks.end(); ++r)
+	ctfNodes.insert(dist.getNodeIndex(*r));
+      TEST_EQUALITY(ctfNodes.size(), 2);
+      const std::vector<int>& insilicoRanks = dist.getApplicationRanks(Insilico);
+      TEST_EQUALITY(dist.getNodeIndex(insilicoRanks[0]), dist.getNodeIndex(insilicoRanks[1]));
+    }
+  }
+
+  TEUCHOS_UNIT_TEST(MultiphysicsDistributor, apportion_processes)
+  {
+    std::vector<double> work(3);
+    work[0] = 8.0;
+    work[1] = 4.0;
+    work[2] = 0.0;
+    std::vector<int> counts = pike::apportionProcesses(work,7);
+    TEST_EQUALITY(counts.size(), 3);
+    // Every application gets at least one process
+    TEST_EQUALITY(counts[0], 4);
+    TEST_EQUALITY(counts[1], 2);
+    TEST_EQUALITY(counts[2], 1);
+
+    // No work: split evenly
+    work.assign(3,0.0);
+    counts = pike::apportionProcesses(work,6);
+    TEST_EQUALITY(counts[0], 2);
+    TEST_EQUALITY(counts[1], 2);
+    TEST_EQUALITY(counts[2], 2);
+
+    TEST_THROW(pike::apportionProcesses(work,2), std::logic_error);
+  }
+
+  TEUCHOS_UNIT_TEST(MultiphysicsDistributor, load_balancing)
+  {
+    Teuchos::RCP<Teuchos::MpiComm<int> > globalComm = 
+      Teuchos::rcp(new Teuchos::MpiComm<int>(Teuchos::opaqueWrapper(MPI_COMM_WORLD)));
+
+    // Run this on 6 processes only
+    TEST_EQUALITY(globalComm->getSize(), 6);
+
+    typedef pike::MultiphysicsDistributor::ApplicationIndex AppIndex;
+
+    pike::MultiphysicsDistributor dist;
+    AppIndex CTF = dist.addApplication("CTF",0,1);
+    AppIndex Insilico = dist.addApplication("Insilico",2,5);
+    AppIndex Peregrine = dist.addApplication("Peregrine",5,5);
+    dist.addTransfer("C_TO_I: ",CTF,Insilico);
+    dist.setup(globalComm,false);
+
+    TEST_THROW(dist.printRecommendedLayout(out), std::logic_error);
+    TEST_THROW(dist.setLoadBalanceWindow(0), std::logic_error);
+    TEST_EQUALITY(dist.getLoadBalanceWindow(), 10);
+    dist.setLoadBalanceWindow(3);
+
+    // CTF does twice the work of Insilico on half the processes.  Old
+    // samples outside of the window are ignored.  Peregrine records
+    // nothing.
+    const int myRank = globalComm->getRank();
+    for (int i = 0; i < 10; ++i) {
+      if (dist.appExistsOnProcess(CTF))
+	dist.recordSolveTime(CTF, (i < 7) ? 100.0 : 4.0 + 0.1 * myRank);
+      if (dist.appExistsOnProcess(Insilico))
+	dist.recordSolveTime(Insilico, 1.0);
+    }
+    if (dist.appExistsOnProcess(CTF)) {
+      TEST_FLOATING_EQUALITY(dist.getAverageSolveTime(CTF), 4.0 + 0.1 * myRank, 1.0e-12);
+    }
+    TEST_EQUALITY(dist.getAverageSolveTime(Peregrine), 0.0);
+
+    // CTF time is the slowest process: 4.1s on 2 processes, Insilico
+    // 1s on 4 processes.  Peregrine shares rank 5 with Insilico, so
+    // the disjoint layout has 6 processes: Peregrine keeps 1 and the
+    // remaining 5 are split 8.2:4 between CTF and Insilico.
+    const std::vector<int> counts = dist.computeRecommendedLayout();
+    TEST_EQUALITY(counts.size(), 3);
+    TEST_EQUALITY(counts[CTF], 3);
+    TEST_EQUALITY(counts[Insilico], 2);
+    TEST_EQUALITY(counts[Peregrine], 1);
+    TEST_EQUALITY(counts[CTF] + counts[Insilico] + counts[Peregrine], 6);
+    TEST_FLOATING_EQUALITY(dist.getMeasuredIterationTime(), 4.1, 1.0e-12);
+    TEST_FLOATING_EQUALITY(dist.getPredictedIterationTime(), 8.2/3.0, 1.0e-12);
+
+    dist.printRecommendedLayout(out);
+  }
+
 }
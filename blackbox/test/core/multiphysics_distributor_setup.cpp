@@ -0,0 +1,85 @@
+#include "Teuchos_ConfigDefs.hpp"
+#include "Teuchos_UnitTestHarness.hpp"
+#include "Teuchos_RCP.hpp"
+#include "Teuchos_TimeMonitor.hpp"
+#include "Teuchos_CommHelpers.hpp"
+
+#include "Pike_MultiphysicsDistributor.hpp"
+#include <algorithm>
+#include <sstream>
+
+namespace pike {
+
+  // Startup benchmark for MultiphysicsDistributor::setup().  Registers
+  // many applications and transfers (200 apps and 600 transfers, the
+  // size of our largest coupled runs) and reports the setup time.
+  // Run at scale to track the cost of building the comms.
+  TEUCHOS_UNIT_TEST(MultiphysicsDistributor, setup_timing)
+  {
+    Teuchos::RCP<Teuchos::MpiComm<int> > globalComm =
+      Teuchos::rcp(new Teuchos::MpiComm<int>(Teuchos::opaqueWrapper(MPI_COMM_WORLD)));
+
+    const int numProcs = globalComm->getSize();
+    const int myRank = globalComm->getRank();
+    const int numApps = 200;
+    const int numTransfers = 600;
+
+    typedef pike::MultiphysicsDistributor::ApplicationIndex AppIndex;
+    typedef pike::MultiphysicsDistributor::TransferIndex TransIndex;
+
+    pike::MultiphysicsDistributor dist;
+
+    // Applications are spread over contiguous, overlapping rank
+    // ranges.
+    const int appProcs = std::max(1, numProcs / 4);
+    std::vector<AppIndex> apps(numApps);
+    for (int a = 0; a < numApps; ++a) {
+      const int begin = (a * appProcs) % numProcs;
+      const int end = std::min(begin + appProcs - 1, numProcs - 1);
+      std::ostringstream name;
+      name << "App_" << a;
+      apps[a] = dist.addApplication(name.str(),begin,end);
+    }
+
+    // Each application is coupled to three others
+    std::vector<TransIndex> transfers(numTransfers);
+    for (int t = 0; t < numTransfers; ++t) {
+      const AppIndex a = t % numApps;
+      const AppIndex b = (a + 1 + t / numApps) % numApps;
+      std::ostringstream name;
+      name << "Transfer_" << t;
+      transfers[t] = dist.addTransfer(name.str(),apps[a],apps[b]);
+    }
+
+    Teuchos::RCP<Teuchos::Time> timer = Teuchos::TimeMonitor::getNewTimer("pike: MultiphysicsDistributor::setup()");
+    globalComm->barrier();
+    {
+      Teuchos::TimeMonitor tm(*timer);
+      dist.setup(globalComm,false);
+      globalComm->barrier();
+    }
+
+    double maxSetupTime = 0.0;
+    Teuchos::reduceAll(*globalComm,Teuchos::REDUCE_MAX,timer->totalElapsedTime(),Teuchos::outArg(maxSetupTime));
+    out << "Setup of " << numApps << " applications and " << numTransfers
+	<< " transfers on " << numProcs << " processes: " << maxSetupTime << " seconds" << std::endl;
+
+    // Sanity check the comms
+    for (int a = 0; a < numApps; ++a) {
+      const int begin = (a * appProcs) % numProcs;
+      const int end = std::min(begin + appProcs - 1, numProcs - 1);
+      const bool member = (myRank >= begin) && (myRank <= end);
+      TEST_EQUALITY(dist.appExistsOnProcess(apps[a]), member);
+      if (member) {
+	TEST_EQUALITY(dist.getAppComm(apps[a])->getSize(), end - begin + 1);
+      }
+    }
+    for (int t = 0; t < numTransfers; ++t) {
+      const AppIndex a = t % numApps;
+      const AppIndex b = (a + 1 + t / numApps) % numApps;
+      TEST_EQUALITY(dist.transferExistsOnProcess(transfers[t]),
+		    dist.appExistsOnProcess(apps[a]) || dist.appExistsOnProcess(apps[b]));
+    }
+  }
+
+}
@@ -18,8 +18,11 @@
 #include "Pike_StatusTest_Composite.hpp"
 #include "Pike_StatusTest_MaxIterations.hpp"
 #include "Pike_StatusTest_ScalarResponseRelativeTolerance.hpp"
+#include "Pike_StatusTest_GlobalCouplingResidual.hpp"
+#include "Pike_StatusTest_Factory.hpp"
 
 #include <iostream>
+#include <cmath>
 
 namespace pike_test {
 
@@ -133,6 +136,157 @@ namespace pike_test {
     TEST_EQUALITY(solver.getStatus(),pike::CONVERGED);
   }
 
+  // The coupled three wall problem of the block_gauss_seidel and
+  // block_jacobi tests.  Every process holds a copy of all walls.
+  struct ThreeWallProblem {
+
+    Teuchos::RCP<LinearHeatConductionModelEvaluator> leftWall;
+    Teuchos::RCP<LinearHeatConductionModelEvaluator> middleWall;
+    Teuchos::RCP<LinearHeatConductionModelEvaluator> rightWall;
+    Teuchos::RCP<LinearHeatConductionDataTransfer> transferQ;
+    Teuchos::RCP<LinearHeatConductionDataTransfer> transferLeftToMiddle;
+    Teuchos::RCP<LinearHeatConductionDataTransfer> transferMiddleToRight;
+
+    ThreeWallProblem(const Teuchos::RCP<const Teuchos::Comm<int> >& comm)
+    {
+      leftWall = linearHeatConductionModelEvaluator(comm,"left wall",pike_test::LinearHeatConductionModelEvaluator::T_RIGHT_IS_RESPONSE);
+      leftWall->set_T_left(7.0);
+      leftWall->set_T_right(5.0);  // final solution is 6.0
+      leftWall->set_k(1.0);
+      leftWall->set_q(1.0);
+
+      middleWall = linearHeatConductionModelEvaluator(comm,"middle wall",pike_test::LinearHeatConductionModelEvaluator::T_RIGHT_IS_RESPONSE);
+      middleWall->set_T_left(6.0);
+      middleWall->set_T_right(3.0);  // final solution is 4.0
+      middleWall->set_k(1.0/2.0);
+      middleWall->set_q(1.0);
+
+      rightWall = linearHeatConductionModelEvaluator(comm,"right wall",pike_test::LinearHeatConductionModelEvaluator::Q_IS_RESPONSE);
+      rightWall->set_T_left(4.0);
+      rightWall->set_T_right(1.0);
+      rightWall->set_k(1.0/3.0);
+      rightWall->set_q(1.5); // final solution is 1.0
+
+      transferQ = linearHeatConductionDataTransfer(comm,"tranfers q: right->{left,middle}",pike_test::LinearHeatConductionDataTransfer::TRANSFER_Q);
+      transferQ->setSource(rightWall);
+      transferQ->addTarget(leftWall);
+      transferQ->addTarget(middleWall);
+
+      transferLeftToMiddle = linearHeatConductionDataTransfer(comm,"tranfer T: left->middle",pike_test::LinearHeatConductionDataTransfer::TRANSFER_T);
+      transferLeftToMiddle->setSource(leftWall);
+      transferLeftToMiddle->addTarget(middleWall);
+
+      transferMiddleToRight = linearHeatConductionDataTransfer(comm,"tranfer T: middle->right",pike_test::LinearHeatConductionDataTransfer::TRANSFER_T);
+      transferMiddleToRight->setSource(middleWall);
+      transferMiddleToRight->addTarget(rightWall);
+    }
+
+    //! Registers the walls and transfers, leaving completeRegistration() to the caller.
+    void registerWith(pike::Solver& solver) const
+    {
+      solver.registerModelEvaluator(leftWall);
+      solver.registerModelEvaluator(middleWall);
+      solver.registerModelEvaluator(rightWall);
+      solver.registerDataTransfer(transferQ);
+      solver.registerDataTransfer(transferLeftToMiddle);
+      solver.registerDataTransfer(transferMiddleToRight);
+    }
+
+    //! AND of relative tolerance tests on the responses of all walls.
+    static Teuchos::RCP<pike::Composite> relativeToleranceTests()
+    {
+      Teuchos::RCP<pike::Composite> convergedTests = pike::composite(pike::Composite::AND);
+      const char* apps[] = {"left wall","middle wall","right wall"};
+      const char* responses[] = {"T_right","T_right","q"};
+      for (int i = 0; i < 3; ++i) {
+	Teuchos::RCP<pike::ScalarResponseRelativeTolerance> t = 
+	  Teuchos::rcp(new pike::ScalarResponseRelativeTolerance);
+	Teuchos::RCP<Teuchos::ParameterList> p = Teuchos::parameterList();
+	p->set("Application Name",apps[i]);
+	p->set("Response Name",responses[i]);
+	p->set("Tolerance",1.0e-5);
+	t->setParameterList(p);
+	convergedTests->addTest(t);
+      }
+      return convergedTests;
+    }
+  };
+
+  TEUCHOS_UNIT_TEST(solvers, global_coupling_residual)
+  {
+    Teuchos::RCP<const Teuchos::Comm<int> > globalComm = Teuchos::DefaultComm<int>::getComm();
+
+    ThreeWallProblem problem(globalComm);
+
+    // Build the residual test through the factory
+    Teuchos::RCP<pike::Composite> status = pike::composite(pike::Composite::OR);
+    Teuchos::RCP<pike::MaxIterations> maxIters =
+      Teuchos::rcp(new pike::MaxIterations(20));
+    Teuchos::RCP<pike::GlobalCouplingResidual> residual;
+    {
+      Teuchos::RCP<Teuchos::ParameterList> p = Teuchos::parameterList();
+      p->set("Type","Global Coupling Residual");
+      p->set("Tolerance Type","Relative");
+      p->set("Tolerance",1.0e-5);
+      pike::StatusTestFactory factory;
+      residual = Teuchos::rcp_dynamic_cast<pike::GlobalCouplingResidual>(factory.buildStatusTests(p),true);
+    }
+    residual->setComm(globalComm);
+    status->addTest(maxIters);
+    status->addTest(residual);
+
+    pike::BlockGaussSeidel solver;
+    problem.registerWith(solver);
+    solver.completeRegistration();
+    solver.setStatusTests(status);
+    solver.solve();
+
+    TEST_EQUALITY(solver.getNumberOfIterations(),9);
+    TEST_EQUALITY(solver.getStatus(),pike::CONVERGED);
+    TEST_EQUALITY(residual->getStatus(),pike::CONVERGED);
+    TEST_ASSERT(residual->getResidual() > 0.0);
+    TEST_ASSERT(residual->getResidual() < 1.0e-4);
+
+    // transferQ targets the left and middle walls but only runs once
+    // per iteration, so its change is not lost to a second transfer
+    // of the same data.  Every process holds a copy of the walls, so
+    // the reduced residual is sqrt(p) times the local one.
+    TEST_ASSERT(problem.transferQ->getChangeNormSquared() > 0.0);
+    const double localChangeNormSquared = problem.transferQ->getChangeNormSquared() +
+      problem.transferLeftToMiddle->getChangeNormSquared() + problem.transferMiddleToRight->getChangeNormSquared();
+    TEST_FLOATING_EQUALITY(residual->getResidual(),
+			   std::sqrt(globalComm->getSize() * localChangeNormSquared), 1.0e-12);
+  }
+
+  TEUCHOS_UNIT_TEST(solvers, complete_check_after_failed_minimal_check)
+  {
+    Teuchos::RCP<const Teuchos::Comm<int> > globalComm = Teuchos::DefaultComm<int>::getComm();
+
+    ThreeWallProblem problem(globalComm);
+
+    // The maximum iterations fail the minimal check of iteration 3
+    // after the relative tolerances were checked, and the repeated
+    // complete check must not compare their values to themselves.
+    Teuchos::RCP<pike::Composite> status = pike::composite(pike::Composite::OR);
+    Teuchos::RCP<pike::Composite> convergedTests = ThreeWallProblem::relativeToleranceTests();
+    status->addTest(convergedTests);
+    status->addTest(Teuchos::rcp(new pike::MaxIterations(3)));
+
+    pike::BlockGaussSeidel solver;
+    Teuchos::RCP<Teuchos::ParameterList> p = Teuchos::parameterList();
+    p->set("Complete Status Check Interval",2);
+    solver.setParameterList(p);
+    problem.registerWith(solver);
+    solver.completeRegistration();
+    solver.setStatusTests(status);
+    solver.solve();
+
+    TEST_EQUALITY(solver.getNumberOfIterations(),3);
+    TEST_EQUALITY(solver.getStatus(),pike::FAILED);
+    TEST_EQUALITY(convergedTests->getStatus(),pike::UNCONVERGED);
+    TEST_ASSERT(std::abs(problem.leftWall->getResponse(0)[0] - 6.0) > 1.0e-5);
+  }
+
   TEUCHOS_UNIT_TEST(solvers, block_jacobi)
   {
     using Teuchos::RCP;
@@ -242,6 +396,293 @@ namespace pike_test {
     TEST_EQUALITY(solver.getStatus(),pike::CONVERGED);
   }
 
+  TEUCHOS_UNIT_TEST(solvers, targeted_barriers)
+  {
+    using Teuchos::RCP;
+    using Teuchos::rcp;
+
+    Teuchos::RCP<const Teuchos::Comm<int> > globalComm = Teuchos::DefaultComm<int>::getComm();
+
+    // The processes are split into two teams that each solve their
+    // own copy of the problem, with barriers on the transfer comms
+    // only.  The global comm is not registered.  Team 1 stops before
+    // team 0 converges, so a barrier that reached across the teams
+    // would hang.  The middle->right transfer comm only holds the
+    // first two processes of a team, so the others must skip its
+    // barriers while its members still match theirs.
+    const int team = globalComm->getRank() % 2;
+    const int teamRank = globalComm->getRank() / 2;
+
+    for (int solverType = 0; solverType < 2; ++solverType) {
+
+      ThreeWallProblem problem(globalComm);
+
+      Teuchos::RCP<pike::Composite> status = pike::composite(pike::Composite::OR);
+      status->addTest(Teuchos::rcp(new pike::MaxIterations((team == 0) ? 20 : 5)));
+      status->addTest(ThreeWallProblem::relativeToleranceTests());
+
+      RCP<pike::SolverDefaultBase> solver;
+      if (solverType == 0)
+	solver = rcp(new pike::BlockGaussSeidel);
+      else
+	solver = rcp(new pike::BlockJacobi);
+      Teuchos::RCP<Teuchos::ParameterList> p = Teuchos::parameterList();
+      p->set("MPI Barrier Transfers",true);
+      p->set("MPI Barrier Solves",true);
+      p->set("Targeted MPI Barriers",true);
+      solver->setParameterList(p);
+      problem.registerWith(*solver);
+      solver->registerTransferComm("tranfers q: right->{left,middle}",globalComm->split(team,teamRank));
+      solver->registerTransferComm("tranfer T: left->middle",globalComm->split(team,teamRank));
+      // Not active on the other processes of the team
+      solver->registerTransferComm("tranfer T: middle->right",globalComm->split((teamRank < 2) ? team : -1,teamRank));
+      solver->completeRegistration();
+      TEST_THROW(solver->registerTransferComm("tranfer T: left->middle",globalComm), std::logic_error);
+      solver->setStatusTests(status);
+      solver->solve();
+
+      if (team == 0) {
+	TEST_EQUALITY(solver->getNumberOfIterations(), (solverType == 0) ? 10 : 18);
+	TEST_EQUALITY(solver->getStatus(),pike::CONVERGED);
+      }
+      else {
+	TEST_EQUALITY(solver->getNumberOfIterations(),5);
+	TEST_EQUALITY(solver->getStatus(),pike::FAILED);
+      }
+    }
+
+    // Comm registered for a transfer that doesn't exist
+    pike::BlockJacobi solver;
+    solver.registerTransferComm("no such transfer",globalComm);
+    TEST_THROW(solver.completeRegistration(), std::logic_error);
+  }
+
+  TEUCHOS_UNIT_TEST(solvers, skip_solves_with_unchanged_inputs)
+  {
+    using Teuchos::RCP;
+    using Teuchos::rcp;
+
+    Teuchos::RCP<const Teuchos::Comm<int> > globalComm = Teuchos::DefaultComm<int>::getComm();
+
+    const std::vector<std::string> solverTypes = {"Block Gauss-Seidel","Block Jacobi"};
+
+    for (std::vector<std::string>::const_iterator type = solverTypes.begin(); type != solverTypes.end(); ++type) {
+
+      ThreeWallProblem problem(globalComm);
+      problem.transferQ->setChangeTolerance(1.0e-8);
+      problem.transferLeftToMiddle->setChangeTolerance(1.0e-8);
+      problem.transferMiddleToRight->setChangeTolerance(1.0e-8);
+
+      // Run a fixed number of iterations well past convergence so
+      // that the coupled inputs stop changing.
+      Teuchos::RCP<pike::MaxIterations> maxIters =
+	Teuchos::rcp(new pike::MaxIterations(50));
+
+      Teuchos::RCP<pike::SolverDefaultBase> solver;
+      if (*type == "Block Gauss-Seidel")
+	solver = rcp(new pike::BlockGaussSeidel);
+      else
+	solver = rcp(new pike::BlockJacobi);
+      Teuchos::RCP<Teuchos::ParameterList> p = Teuchos::parameterList();
+      p->set("Type",*type);
+      p->set("Skip Solves With Unchanged Inputs",true);
+      solver->setParameterList(p);
+      solver->registerComm(globalComm);
+      problem.registerWith(*solver);
+      solver->completeRegistration();
+      solver->setStatusTests(maxIters);
+      solver->solve();
+
+      int numSkippedSolves = 0;
+      if (*type == "Block Gauss-Seidel")
+	numSkippedSolves = Teuchos::rcp_dynamic_cast<pike::BlockGaussSeidel>(solver,true)->getNumberOfSkippedSolves();
+      else
+	numSkippedSolves = Teuchos::rcp_dynamic_cast<pike::BlockJacobi>(solver,true)->getNumberOfSkippedSolves();
+
+      out << *type << ": skipped " << numSkippedSolves << " of " 
+	  << 3 * solver->getNumberOfIterations() << " solves" << std::endl;
+
+      TEST_EQUALITY(solver->getNumberOfIterations(),50);
+      TEST_ASSERT(numSkippedSolves > 0);
+      // Skipping solves must not change the converged coupled solution
+      const double tol = 1.0e-6;
+      TEST_FLOATING_EQUALITY(problem.leftWall->getResponse(0)[0],200.0/29.0,tol);
+      TEST_FLOATING_EQUALITY(problem.middleWall->getResponse(0)[0],94.0/29.0,tol);
+      TEST_FLOATING_EQUALITY(problem.rightWall->getResponse(0)[0],6.0/29.0,tol);
+
+      // A reset must force all models to be solved again
+      solver->reset();
+      if (*type == "Block Gauss-Seidel")
+	numSkippedSolves = Teuchos::rcp_dynamic_cast<pike::BlockGaussSeidel>(solver,true)->getNumberOfSkippedSolves();
+      else
+	numSkippedSolves = Teuchos::rcp_dynamic_cast<pike::BlockJacobi>(solver,true)->getNumberOfSkippedSolves();
+      TEST_EQUALITY(numSkippedSolves,0);
+      solver->step();
+      if (*type == "Block Gauss-Seidel")
+	numSkippedSolves = Teuchos::rcp_dynamic_cast<pike::BlockGaussSeidel>(solver,true)->getNumberOfSkippedSolves();
+      else
+	numSkippedSolves = Teuchos::rcp_dynamic_cast<pike::BlockJacobi>(solver,true)->getNumberOfSkippedSolves();
+      TEST_EQUALITY(numSkippedSolves,0);
+    }
+
+    // Changes below the tolerance are measured against the value at
+    // the target's last solve, so they can not add up unnoticed
+    {
+      RCP<LinearHeatConductionModelEvaluator> source = 
+	linearHeatConductionModelEvaluator(globalComm,"source",pike_test::LinearHeatConductionModelEvaluator::Q_IS_RESPONSE);
+      RCP<LinearHeatConductionModelEvaluator> target = 
+	linearHeatConductionModelEvaluator(globalComm,"target",pike_test::LinearHeatConductionModelEvaluator::T_RIGHT_IS_RESPONSE);
+      RCP<LinearHeatConductionDataTransfer> transfer = 
+	linearHeatConductionDataTransfer(globalComm,"q: source->target",pike_test::LinearHeatConductionDataTransfer::TRANSFER_Q);
+      transfer->setSource(source);
+      transfer->addTarget(target);
+      transfer->setChangeTolerance(1.0e-2);
+
+      pike::BlockGaussSeidel solver;
+      source->set_q(1.0);
+      transfer->doTransfer(solver);
+      TEST_ASSERT(transfer->changedTarget("target"));
+      transfer->targetSolved("target");
+      TEST_ASSERT(!transfer->changedTarget("target"));
+
+      // Two transfers of 0.6 times the tolerance (the damping
+      // factor halves the source value)
+      source->set_q(1.0 + 1.2e-2);
+      transfer->doTransfer(solver);
+      TEST_ASSERT(!transfer->changedTarget("target"));
+      source->set_q(1.0 + 2.4e-2);
+      transfer->doTransfer(solver);
+      TEST_ASSERT(transfer->changedTarget("target"));
+      TEST_ASSERT(!transfer->changedTarget("source"));
+    }
+  }
+
+  // A solver that only implements the original pike::Solver
+  // interface, as out-of-tree solvers do, by forwarding to a wrapped
+  // solver.  It relies on the default indexed lookup and views.
+  class LegacySolver : public pike::Solver {
+    Teuchos::RCP<pike::Solver> s_;
+  public:
+    LegacySolver(const Teuchos::RCP<pike::Solver>& s) : s_(s) {}
+    void registerComm(const Teuchos::RCP<const Teuchos::Comm<int> >& comm) { s_->registerComm(comm); }
+    void registerModelEvaluator(const Teuchos::RCP<pike::BlackBoxModelEvaluator>& me) { s_->registerModelEvaluator(me); }
+    void registerDataTransfer(const Teuchos::RCP<pike::DataTransfer>& dt) { s_->registerDataTransfer(dt); }
+    void completeRegistration() { s_->completeRegistration(); }
+    Teuchos::RCP<const pike::BlackBoxModelEvaluator> getModelEvaluator(const std::string& name) const { return s_->getModelEvaluator(name); }
+    const std::vector<Teuchos::RCP<const pike::BlackBoxModelEvaluator> > getModelEvaluators() const { return s_->getModelEvaluators(); }
+    Teuchos::RCP<const pike::DataTransfer> getDataTransfer(const std::string& name) const { return s_->getDataTransfer(name); }
+    const std::vector<Teuchos::RCP<const pike::DataTransfer> > getDataTransfers() const { return s_->getDataTransfers(); }
+    pike::SolveStatus step() { return s_->step(); }
+    void initialize() { s_->initialize(); }
+    pike::SolveStatus solve() { return s_->solve(); }
+    void finalize() { s_->finalize(); }
+    void reset() { s_->reset(); }
+    pike::SolveStatus getStatus() const { return s_->getStatus(); }
+    int getNumberOfIterations() const { return s_->getNumberOfIterations(); }
+    void addObserver(const Teuchos::RCP<pike::SolverObserver>& observer) { s_->addObserver(observer); }
+    std::vector<Teuchos::RCP<pike::SolverObserver> > getObservers() const { return s_->getObservers(); }
+    void setStatusTests(const Teuchos::RCP<pike::StatusTest>& statusTests) { s_->setStatusTests(statusTests); }
+    Teuchos::RCP<const pike::StatusTest> getStatusTests() const { return s_->getStatusTests(); }
+    std::string name() const { return s_->name(); }
+  };
+
+  TEUCHOS_UNIT_TEST(solvers, indexed_lookup)
+  {
+    using Teuchos::RCP;
+
+    Teuchos::RCP<const Teuchos::Comm<int> > globalComm = Teuchos::DefaultComm<int>::getComm();
+
+    RCP<LinearHeatConductionModelEvaluator> leftWall = 
+      linearHeatConductionModelEvaluator(globalComm,"left wall",pike_test::LinearHeatConductionModelEvaluator::T_RIGHT_IS_RESPONSE);
+    RCP<LinearHeatConductionModelEvaluator> rightWall = 
+      linearHeatConductionModelEvaluator(globalComm,"right wall",pike_test::LinearHeatConductionModelEvaluator::Q_IS_RESPONSE);
+
+    RCP<LinearHeatConductionDataTransfer> transferQ = 
+      linearHeatConductionDataTransfer(globalComm,"transfer q",pike_test::LinearHeatConductionDataTransfer::TRANSFER_Q);
+    transferQ->setSource(rightWall);
+    transferQ->addTarget(leftWall);
+
+    RCP<LinearHeatConductionDataTransfer> transferT = 
+      linearHeatConductionDataTransfer(globalComm,"transfer T",pike_test::LinearHeatConductionDataTransfer::TRANSFER_T);
+    transferT->setSource(leftWall);
+    transferT->addTarget(rightWall);
+
+    // Check the SolverDefaultBase implementation and the pike::Solver defaults
+    LegacySolver legacy(Teuchos::rcp(new pike::BlockJacobi));
+    pike::BlockJacobi jacobi;
+    pike::Solver* solvers[2] = {&jacobi, &legacy};
+
+    for (int s = 0; s < 2; ++s) {
+      pike::Solver& solver = *solvers[s];
+      solver.registerModelEvaluator(leftWall);
+      solver.registerModelEvaluator(rightWall);
+      solver.registerDataTransfer(transferQ);
+      solver.registerDataTransfer(transferT);
+      solver.completeRegistration();
+
+      // Indices follow the registration order
+      TEST_EQUALITY(solver.getModelEvaluatorIndex("left wall"), 0);
+      TEST_EQUALITY(solver.getModelEvaluatorIndex("right wall"), 1);
+      TEST_EQUALITY(solver.getDataTransferIndex("transfer q"), 0);
+      TEST_EQUALITY(solver.getDataTransferIndex("transfer T"), 1);
+
+      const int rightIndex = solver.getModelEvaluatorIndex("right wall");
+      TEST_EQUALITY(solver.getModelEvaluator(rightIndex).get(), rightWall.get());
+      TEST_EQUALITY(solver.getModelEvaluator("right wall").get(), rightWall.get());
+      TEST_EQUALITY(solver.getModelEvaluators()[rightIndex].get(), rightWall.get());
+
+      const int tIndex = solver.getDataTransferIndex("transfer T");
+      TEST_EQUALITY(solver.getDataTransfer(tIndex).get(), transferT.get());
+      TEST_EQUALITY(solver.getDataTransfer("transfer T").get(), transferT.get());
+
+      // Views of the registered objects
+      TEST_EQUALITY(solver.getModelEvaluatorsView().size(), 2);
+      TEST_EQUALITY(solver.getModelEvaluatorsView()[rightIndex].get(), rightWall.get());
+      TEST_EQUALITY(solver.getDataTransfersView().size(), 2);
+      TEST_EQUALITY(solver.getDataTransfersView()[tIndex].get(), transferT.get());
+
+      TEST_THROW(solver.getModelEvaluatorIndex("missing wall"), std::logic_error);
+      TEST_THROW(solver.getModelEvaluator(2), std::logic_error);
+      TEST_THROW(solver.getDataTransferIndex("missing transfer"), std::logic_error);
+      TEST_THROW(solver.getDataTransfer(-1), std::logic_error);
+    }
+  }
+
+  TEUCHOS_UNIT_TEST(solvers, default_views)
+  {
+    using Teuchos::RCP;
+
+    Teuchos::RCP<const Teuchos::Comm<int> > globalComm = Teuchos::DefaultComm<int>::getComm();
+
+    RCP<LinearHeatConductionModelEvaluator> leftWall = 
+      linearHeatConductionModelEvaluator(globalComm,"left wall",pike_test::LinearHeatConductionModelEvaluator::T_RIGHT_IS_RESPONSE);
+    RCP<LinearHeatConductionModelEvaluator> rightWall = 
+      linearHeatConductionModelEvaluator(globalComm,"right wall",pike_test::LinearHeatConductionModelEvaluator::Q_IS_RESPONSE);
+    RCP<LinearHeatConductionDataTransfer> transferQ = 
+      linearHeatConductionDataTransfer(globalComm,"transfer q",pike_test::LinearHeatConductionDataTransfer::TRANSFER_Q);
+
+    LegacySolver solver(Teuchos::rcp(new pike::BlockJacobi));
+    solver.registerModelEvaluator(leftWall);
+    solver.registerDataTransfer(transferQ);
+
+    // Repeated calls must not invalidate a view handed out earlier
+    Teuchos::ArrayView<const RCP<const pike::BlackBoxModelEvaluator> > models = solver.getModelEvaluatorsView();
+    Teuchos::ArrayView<const RCP<const pike::DataTransfer> > transfers = solver.getDataTransfersView();
+    TEST_EQUALITY(solver.getModelEvaluatorsView().getRawPtr(), models.getRawPtr());
+    TEST_EQUALITY(solver.getDataTransfersView().getRawPtr(), transfers.getRawPtr());
+    TEST_EQUALITY(models.size(), 1);
+    TEST_EQUALITY(models[0].get(), leftWall.get());
+    TEST_EQUALITY(transfers[0].get(), transferQ.get());
+
+    // A registration refreshes the view
+    solver.registerModelEvaluator(rightWall);
+    solver.completeRegistration();
+    models = solver.getModelEvaluatorsView();
+    TEST_EQUALITY(models.size(), 2);
+    TEST_EQUALITY(models[0].get(), leftWall.get());
+    TEST_EQUALITY(models[1].get(), rightWall.get());
+  }
+
   TEUCHOS_UNIT_TEST(solvers, factory)
   {
     using Teuchos::RCP;
@@ -0,0 +1,164 @@
+#include "Teuchos_ConfigDefs.hpp"
+#include "Teuchos_UnitTestHarness.hpp"
+#include "Teuchos_RCP.hpp"
+
+#include "Pike_MultiphysicsDistributor.hpp"
+#include "Pike_StaticPartitioner.hpp"
+
+namespace pike {
+
+  TEUCHOS_UNIT_TEST(StaticPartitioner, basic)
+  {
+    typedef pike::MultiphysicsDistributor::ApplicationIndex AppIndex;
+    typedef pike::MultiphysicsDistributor::TransferIndex TransIndex;
+
+    // Registration only, setup() is not needed offline
+    Teuchos::RCP<pike::MultiphysicsDistributor> dist = Teuchos::rcp(new pike::MultiphysicsDistributor);
+    AppIndex CTF = dist->addApplicationByCount("CTF",1);
+    AppIndex Insilico = dist->addApplicationByCount("Insilico",1);
+    TransIndex CTF_Insilico = dist->addTransfer("C_TO_I: ",CTF,Insilico,100.0);
+
+    Teuchos::RCP<pike::StaticPartitioner> partitioner = pike::staticPartitioner(dist);
+    partitioner->setTransferCostModel(0.5,0.01);
+    TEST_THROW(partitioner->setTransferCostModel(0.5,0.01,0.0), std::logic_error);
+
+    // The volume is spread over the smaller application.  All ranks
+    // are on one node, so no data crosses nodes.
+    std::vector<int> counts(2), beginRanks(2);
+    counts[CTF] = 1; counts[Insilico] = 1;
+    beginRanks[CTF] = 0; beginRanks[Insilico] = 1;
+    TEST_FLOATING_EQUALITY(partitioner->getPredictedTransferTime(CTF_Insilico,counts,beginRanks), 1.5, 1.0e-12);
+    counts[CTF] = 6; counts[Insilico] = 2;
+    beginRanks[Insilico] = 6;
+    TEST_FLOATING_EQUALITY(partitioner->getPredictedTransferTime(CTF_Insilico,counts,beginRanks), 1.0, 1.0e-12);
+    TEST_THROW(partitioner->getPredictedTransferTime(CTF_Insilico), std::logic_error);
+
+    // Missing curve
+    TEST_THROW(partitioner->partition(8,pike::StaticPartitioner::BLOCK_JACOBI), std::logic_error);
+
+    std::vector<int> procs;
+    std::vector<double> times;
+    procs.push_back(1); times.push_back(100.0);
+    procs.push_back(2); times.push_back(50.0);
+    procs.push_back(4); times.push_back(25.0);
+    procs.push_back(8); times.push_back(20.0);
+    partitioner->setStrongScalingCurve(CTF,procs,times);
+
+    procs.clear(); times.clear();
+    procs.push_back(2); times.push_back(20.0);
+    procs.push_back(4); times.push_back(12.0);
+    partitioner->setStrongScalingCurve(Insilico,procs,times);
+
+    // Bad curves
+    TEST_THROW(partitioner->setStrongScalingCurve(Insilico,procs,std::vector<double>(1,1.0)), std::logic_error);
+    procs[1] = 2;
+    TEST_THROW(partitioner->setStrongScalingCurve(Insilico,procs,times), std::logic_error);
+
+    // Cost model: perfect scaling below the curve, log-log
+    // interpolation inside and no speedup beyond it
+    TEST_FLOATING_EQUALITY(partitioner->getPredictedSolveTime(Insilico,1), 40.0, 1.0e-12);
+    TEST_FLOATING_EQUALITY(partitioner->getPredictedSolveTime(CTF,3), 100.0/3.0, 1.0e-12);
+    TEST_FLOATING_EQUALITY(partitioner->getPredictedSolveTime(CTF,16), 20.0, 1.0e-12);
+    TEST_ASSERT(partitioner->getPredictedSolveTime(CTF,6) < 25.0);
+    TEST_ASSERT(partitioner->getPredictedSolveTime(CTF,6) > 20.0);
+
+    TEST_THROW(partitioner->print(out), std::logic_error);
+
+    // Block Jacobi: disjoint ranks, minimize the slowest application
+    partitioner->partition(8,pike::StaticPartitioner::BLOCK_JACOBI);
+    TEST_EQUALITY(partitioner->getProcessCounts()[CTF], 6);
+    TEST_EQUALITY(partitioner->getProcessCounts()[Insilico], 2);
+    TEST_EQUALITY(partitioner->getBeginRank(CTF), 0);
+    TEST_EQUALITY(partitioner->getEndRank(CTF), 5);
+    TEST_EQUALITY(partitioner->getBeginRank(Insilico), 6);
+    TEST_EQUALITY(partitioner->getEndRank(Insilico), 7);
+    TEST_FLOATING_EQUALITY(partitioner->getPredictedTransferTime(CTF_Insilico), 1.0, 1.0e-12);
+    TEST_FLOATING_EQUALITY(partitioner->getPredictedIterationTime(),
+			   partitioner->getPredictedSolveTime(CTF,6) + 1.0, 1.0e-12);
+    partitioner->print(out);
+
+    // Once the bottleneck stops speeding up, Insilico gets processes
+    // that only speed up the transfer.  Processes that help neither
+    // are left unused.
+    partitioner->partition(100,pike::StaticPartitioner::BLOCK_JACOBI);
+    TEST_EQUALITY(partitioner->getProcessCounts()[CTF], 8);
+    TEST_EQUALITY(partitioner->getProcessCounts()[Insilico], 8);
+    TEST_FLOATING_EQUALITY(partitioner->getPredictedIterationTime(), 20.0 + 0.5 + 1.0/8.0, 1.0e-12);
+
+    // Without transfer volume, Insilico stays on its two processes
+    partitioner->setTransferCostModel(0.5,0.0);
+    partitioner->partition(100,pike::StaticPartitioner::BLOCK_JACOBI);
+    TEST_EQUALITY(partitioner->getProcessCounts()[CTF], 8);
+    TEST_EQUALITY(partitioner->getProcessCounts()[Insilico], 2);
+    TEST_FLOATING_EQUALITY(partitioner->getPredictedIterationTime(), 20.5, 1.0e-12);
+    partitioner->setTransferCostModel(0.5,0.01);
+
+    TEST_THROW(partitioner->partition(1,pike::StaticPartitioner::BLOCK_JACOBI), std::logic_error);
+
+    // Block Gauss-Seidel: shared ranks.  Insilico is fastest on 4
+    // processes, but 8 speed up the transfer at no cost.
+    partitioner->partition(8,pike::StaticPartitioner::BLOCK_GAUSS_SEIDEL);
+    TEST_EQUALITY(partitioner->getProcessCounts()[CTF], 8);
+    TEST_EQUALITY(partitioner->getProcessCounts()[Insilico], 8);
+    TEST_EQUALITY(partitioner->getBeginRank(CTF), 0);
+    TEST_EQUALITY(partitioner->getBeginRank(Insilico), 0);
+    TEST_EQUALITY(partitioner->getEndRank(Insilico), 7);
+    TEST_FLOATING_EQUALITY(partitioner->getPredictedIterationTime(), 20.0 + 12.0 + 0.5 + 1.0/8.0, 1.0e-12);
+    partitioner->print(out);
+  }
+
+  TEUCHOS_UNIT_TEST(StaticPartitioner, inter_node_transfers)
+  {
+    typedef pike::MultiphysicsDistributor::ApplicationIndex AppIndex;
+    typedef pike::MultiphysicsDistributor::TransferIndex TransIndex;
+
+    // Nodes of 4 ranks, and data that crosses nodes costs 10 times
+    // as much
+    Teuchos::RCP<pike::MultiphysicsDistributor> dist = Teuchos::rcp(new pike::MultiphysicsDistributor);
+    dist->setProcessesPerNode(4);
+    AppIndex A = dist->addApplicationByCount("A",1);
+    AppIndex B = dist->addApplicationByCount("B",1);
+    TransIndex A_B = dist->addTransfer("A_TO_B",A,B,100.0);
+
+    Teuchos::RCP<pike::StaticPartitioner> partitioner = pike::staticPartitioner(dist);
+    partitioner->setTransferCostModel(0.0,0.01,10.0);
+
+    std::vector<int> counts(2), beginRanks(2);
+
+    // A on ranks [0,5], B on [6,7]: 4 of the 12 pairs share node 1
+    counts[A] = 6; counts[B] = 2;
+    beginRanks[A] = 0; beginRanks[B] = 6;
+    TEST_FLOATING_EQUALITY(partitioner->getPredictedTransferTime(A_B,counts,beginRanks),
+			   0.5 * (1.0 + 9.0 * 2.0/3.0), 1.0e-12);
+
+    // Disjoint nodes
+    counts[A] = 4; counts[B] = 4;
+    beginRanks[A] = 0; beginRanks[B] = 4;
+    TEST_FLOATING_EQUALITY(partitioner->getPredictedTransferTime(A_B,counts,beginRanks), 2.5, 1.0e-12);
+
+    // Shared ranks of a Gauss-Seidel partition on one node
+    beginRanks[B] = 0;
+    TEST_FLOATING_EQUALITY(partitioner->getPredictedTransferTime(A_B,counts,beginRanks), 0.25, 1.0e-12);
+
+    // Both scale perfectly up to 4 processes.  Block Jacobi keeps
+    // both applications and their transfer on one node instead of
+    // spreading them over two.
+    std::vector<int> procs(1,4);
+    std::vector<double> times(1,2.0);
+    partitioner->setStrongScalingCurve(A,procs,times);
+    partitioner->setStrongScalingCurve(B,procs,times);
+    partitioner->partition(8,pike::StaticPartitioner::BLOCK_JACOBI);
+    TEST_EQUALITY(partitioner->getProcessCounts()[A], 2);
+    TEST_EQUALITY(partitioner->getProcessCounts()[B], 2);
+    TEST_FLOATING_EQUALITY(partitioner->getPredictedIterationTime(), 4.0 + 0.5, 1.0e-12);
+
+    // Without the inter-node penalty the second node is used
+    partitioner->setTransferCostModel(0.0,0.01);
+    partitioner->partition(8,pike::StaticPartitioner::BLOCK_JACOBI);
+    TEST_EQUALITY(partitioner->getProcessCounts()[A], 4);
+    TEST_EQUALITY(partitioner->getProcessCounts()[B], 4);
+    TEST_FLOATING_EQUALITY(partitioner->getPredictedIterationTime(), 2.0 + 0.25, 1.0e-12);
+    partitioner->print(out);
+  }
+
+}
@@ -2,6 +2,7 @@
 #include "Teuchos_ParameterList.hpp"
 #include "Teuchos_DefaultComm.hpp"
 #include <iostream>
+#include <cmath>
 
 // Prerequisites for testing
 #include "Pike_Mock_ModelEvaluator.hpp"
@@ -13,6 +14,12 @@
 #include "Pike_StatusTest_GlobalModelConvergence.hpp"
 #include "Pike_StatusTest_LocalModelFailure.hpp"
 #include "Pike_StatusTest_ScalarResponseRelativeTolerance.hpp"
+#include "Pike_StatusTest_VectorResponseTolerance.hpp"
+#include "Pike_StatusTest_CouplingResidualDivergence.hpp"
+#include "Pike_StatusTest_CouplingResidualStagnation.hpp"
+#include "Pike_StatusTest_GlobalCouplingResidual.hpp"
+#include "Pike_StatusTest_ExtrapolatedCouplingError.hpp"
+#include "Pike_DataTransfer.hpp"
 #include "Pike_StatusTest_Factory.hpp"
 #include "Pike_Mock_UserStatusTestFactory.hpp"
 
@@ -195,6 +202,68 @@ namespace pike {
     TEST_EQUALITY(tests->getStatus(), pike::UNCHECKED);
   }
 
+  TEUCHOS_UNIT_TEST(status_test, CompleteStatusCheckInterval)
+  {
+    Teuchos::RCP<const Teuchos::Comm<int> > comm = Teuchos::DefaultComm<int>::getComm();
+
+    // Global convergence is only checked every third iteration, the
+    // maximum iterations every iteration.  A failing minimal check is
+    // repeated as a complete check.
+    for (int trigger = 8; trigger < 11; ++trigger) {
+      Teuchos::RCP<Teuchos::ParameterList> statusTestParams = Teuchos::parameterList("My Status Tests");
+      {
+	statusTestParams->set("Type","Composite OR");
+	Teuchos::ParameterList& app2GlobalConv = statusTestParams->sublist("Converged");
+	app2GlobalConv.set("Type","Global Model Convergence");
+	app2GlobalConv.set("Model Name","app2");
+	Teuchos::ParameterList& failure = statusTestParams->sublist("Failure 1");
+	failure.set("Type","Maximum Iterations");
+	failure.set("Maximum Iterations",10);
+	Teuchos::ParameterList& app1LocalConv = statusTestParams->sublist("Failure 2");      
+	app1LocalConv.set("Type","Local Model Failure");
+	app1LocalConv.set("Model Name","app1");
+      }
+
+      pike::StatusTestFactory stFactory;
+      Teuchos::RCP<pike::StatusTest> tests = stFactory.buildStatusTests(statusTestParams);
+
+      Teuchos::RCP<pike_test::MockModelEvaluator> app1 = 
+	pike_test::mockModelEvaluator(comm,"app1",pike_test::MockModelEvaluator::LOCAL_FAILURE,11,-1);
+
+      Teuchos::RCP<pike_test::MockModelEvaluator> app2 = 
+	pike_test::mockModelEvaluator(comm,"app2",pike_test::MockModelEvaluator::GLOBAL_CONVERGENCE,trigger,-1);
+
+      Teuchos::RCP<pike::BlockGaussSeidel> solver = Teuchos::rcp(new pike::BlockGaussSeidel);
+      Teuchos::RCP<Teuchos::ParameterList> solverParams = Teuchos::parameterList();
+      solverParams->set("Complete Status Check Interval",3);
+      solver->setParameterList(solverParams);
+      app1->setSolver(solver);
+      app2->setSolver(solver);
+      solver->registerModelEvaluator(app1);
+      solver->registerModelEvaluator(app2);
+      solver->completeRegistration();
+      solver->setStatusTests(tests);
+      solver->solve();
+
+      if (trigger == 8) {
+	// Convergence at iteration 8 is skipped by the minimal check
+	TEST_EQUALITY(solver->getStatus(),pike::FAILED);
+	TEST_EQUALITY(solver->getNumberOfIterations(),10);
+      }
+      else if (trigger == 9) {
+	TEST_EQUALITY(solver->getStatus(),pike::CONVERGED);
+	TEST_EQUALITY(solver->getNumberOfIterations(),9);
+      }
+      else {
+	// Iteration 10 is a minimal check that hits the maximum
+	// iterations, so it is repeated as a complete check that sees
+	// the convergence
+	TEST_EQUALITY(solver->getStatus(),pike::CONVERGED);
+	TEST_EQUALITY(solver->getNumberOfIterations(),10);
+      }
+    }
+  }
+
   TEUCHOS_UNIT_TEST(status_test, ScalarResponseRelativeError)
   {
 
@@ -236,6 +305,357 @@ namespace pike {
     TEST_EQUALITY(solver->getNumberOfIterations(),0);
   }
 
+  // Model with a vector response x_i = (i+1)*(1 - 0.5^k) after k
+  // solves, so the change in iteration k is (i+1)*0.5^k.
+  class FieldModel : public pike::BlackBoxModelEvaluator {
+  public:
+    FieldModel(const int n) : field_(n,0.0), numSolves_(0) {}
+    std::string name() const { return "field app"; }
+    void solve()
+    {
+      ++numSolves_;
+      const double change = std::pow(0.5,numSolves_);
+      for (std::size_t i = 0; i < field_.size(); ++i)
+	field_[i] += static_cast<double>(i+1) * change;
+    }
+    bool isLocallyConverged() const { return true; }
+    bool supportsResponse(const std::string& rName) const { return rName == "Field"; }
+    int getNumberOfResponses() const { return 1; }
+    std::string getResponseName(const int) const { return "Field"; }
+    int getResponseIndex(const std::string&) const { return 0; }
+    Teuchos::ArrayView<const double> getResponse(const int) const
+    { return Teuchos::ArrayView<const double>(field_); }
+  private:
+    std::vector<double> field_;
+    int numSolves_;
+  };
+
+  TEUCHOS_UNIT_TEST(status_test, VectorResponseTolerance)
+  {
+    // n = 1001 also covers the remainder loop of the kernels
+    const int n = 1001;
+
+    for (int testCase = 0; testCase < 3; ++testCase) {
+      Teuchos::RCP<Teuchos::ParameterList> p = Teuchos::parameterList("ST");
+      p->set("Type","Vector Response Tolerance");
+      p->set("Application Name","field app");
+      p->set("Response Name","Field");
+      int expectedIterations = 0;
+      if (testCase == 0) {
+	// n * 0.5^k < 1e-3
+	p->set("Tolerance Type","Absolute");
+	p->set("Norm Type","Linf");
+	p->set("Tolerance",1.0e-3);
+	expectedIterations = 20;
+      }
+      else if (testCase == 1) {
+	// 0.5^k / (1 - 0.5^k) < 1e-3
+	p->set("Tolerance Type","Relative");
+	p->set("Norm Type","L2");
+	p->set("Tolerance",1.0e-3);
+	expectedIterations = 10;
+      }
+      else {
+	// Same as relative for each entry
+	p->set("Tolerance Type","Weighted RMS");
+	p->set("Norm Type","L2");
+	p->set("Relative Tolerance",1.0e-3);
+	p->set("Absolute Tolerance",1.0e-12);
+	expectedIterations = 10;
+      }
+
+      pike::StatusTestFactory stFactory;
+      Teuchos::RCP<pike::StatusTest> tests = stFactory.buildStatusTests(p);
+
+      Teuchos::RCP<FieldModel> app = Teuchos::rcp(new FieldModel(n));
+      Teuchos::RCP<pike::BlockGaussSeidel> solver = Teuchos::rcp(new pike::BlockGaussSeidel);
+      solver->registerModelEvaluator(app);
+      solver->completeRegistration();
+      solver->setStatusTests(tests);
+      solver->solve();
+
+      TEST_EQUALITY(solver->getStatus(),pike::CONVERGED);
+      TEST_EQUALITY(solver->getNumberOfIterations(),expectedIterations);
+    }
+
+    // Complete checks every 4th iteration: the change is measured
+    // since the last checked iterate, n * 15 * 0.5^k < 1e-3
+    {
+      Teuchos::RCP<Teuchos::ParameterList> p = Teuchos::parameterList("ST");
+      p->set("Application Name","field app");
+      p->set("Response Name","Field");
+      p->set("Tolerance Type","Absolute");
+      p->set("Norm Type","Linf");
+      p->set("Tolerance",1.0e-3);
+      Teuchos::RCP<pike::VectorResponseTolerance> vt = Teuchos::rcp(new pike::VectorResponseTolerance);
+      vt->setParameterList(p);
+
+      Teuchos::RCP<FieldModel> app = Teuchos::rcp(new FieldModel(n));
+      Teuchos::RCP<pike::BlockGaussSeidel> solver = Teuchos::rcp(new pike::BlockGaussSeidel);
+      Teuchos::RCP<Teuchos::ParameterList> solverParams = Teuchos::parameterList();
+      solverParams->set("Complete Status Check Interval",4);
+      solver->setParameterList(solverParams);
+      solver->registerModelEvaluator(app);
+      solver->completeRegistration();
+      solver->setStatusTests(vt);
+      solver->solve();
+
+      TEST_EQUALITY(solver->getStatus(),pike::CONVERGED);
+      TEST_EQUALITY(solver->getNumberOfIterations(),24);
+
+      // A minimal check of an iteration that was already checked
+      // returns the result of the complete check
+      const double norm = vt->getNorm();
+      TEST_EQUALITY(vt->checkStatus(*solver,pike::MINIMAL),pike::CONVERGED);
+      TEST_EQUALITY(vt->getNorm(),norm);
+    }
+
+    // Norms reduced over the comm cover the response on all
+    // processes
+    {
+      Teuchos::RCP<const Teuchos::Comm<int> > comm = Teuchos::DefaultComm<int>::getComm();
+      Teuchos::RCP<Teuchos::ParameterList> p = Teuchos::parameterList("ST");
+      p->set("Application Name","field app");
+      p->set("Response Name","Field");
+      p->set("Tolerance Type","Absolute");
+      p->set("Norm Type","L2");
+      p->set("Tolerance",0.0);
+      Teuchos::RCP<pike::VectorResponseTolerance> local = Teuchos::rcp(new pike::VectorResponseTolerance);
+      local->setParameterList(Teuchos::rcp(new Teuchos::ParameterList(*p)));
+      Teuchos::RCP<pike::VectorResponseTolerance> global = Teuchos::rcp(new pike::VectorResponseTolerance);
+      global->setParameterList(Teuchos::rcp(new Teuchos::ParameterList(*p)));
+      global->setComm(comm);
+      Teuchos::RCP<pike::Composite> tests = pike::composite(pike::Composite::OR);
+      tests->addTest(Teuchos::rcp(new pike::MaxIterations(3)));
+      tests->addTest(local);
+      tests->addTest(global);
+
+      Teuchos::RCP<FieldModel> app = Teuchos::rcp(new FieldModel(n));
+      Teuchos::RCP<pike::BlockGaussSeidel> solver = Teuchos::rcp(new pike::BlockGaussSeidel);
+      solver->registerModelEvaluator(app);
+      solver->completeRegistration();
+      solver->setStatusTests(tests);
+      solver->solve();
+
+      TEST_EQUALITY(solver->getNumberOfIterations(),3);
+      TEST_ASSERT(local->getNorm() > 0.0);
+      TEST_FLOATING_EQUALITY(global->getNorm(), std::sqrt(static_cast<double>(comm->getSize())) * local->getNorm(), 1.0e-12);
+    }
+
+    Teuchos::RCP<Teuchos::ParameterList> p = Teuchos::parameterList("ST");
+    p->set("Norm Type","L1");
+    pike::VectorResponseTolerance vt;
+    TEST_THROW(vt.setParameterList(p),std::logic_error);
+  }
+
+  // Transfer that moves no data but reports a coupling residual of 1
+  // in the first iteration, shrinking by 0.5 for the next
+  // numContracting iterations and by finalRatio after that.
+  class ResidualSequenceTransfer : public pike::DataTransfer {
+  public:
+    ResidualSequenceTransfer(const int numContracting, const double finalRatio) :
+      numContracting_(numContracting), finalRatio_(finalRatio), numTransfers_(0), residual_(1.0), names_(1,"app") {}
+    std::string name() const { return "residual sequence"; }
+    bool doTransfer(const pike::Solver&)
+    {
+      if (numTransfers_ > 0)
+	residual_ *= (numTransfers_ <= numContracting_) ? 0.5 : finalRatio_;
+      ++numTransfers_;
+      return true;
+    }
+    bool transferSucceeded() const { return true; }
+    const std::vector<std::string>& getSourceModelNames() const { return names_; }
+    const std::vector<std::string>& getTargetModelNames() const { return names_; }
+    double getChangeNormSquared() const { return residual_ * residual_; }
+    double getTargetNormSquared() const { return 1.0; }
+  private:
+    int numContracting_;
+    double finalRatio_;
+    int numTransfers_;
+    double residual_;
+    std::vector<std::string> names_;
+  };
+
+  // Solves a mock model coupled only through a ResidualSequenceTransfer
+  // with the given status tests.
+  Teuchos::RCP<pike::BlockGaussSeidel>
+  solveResidualSequence(const Teuchos::RCP<pike::StatusTest>& tests,
+			const int numContracting, const double finalRatio)
+  {
+    Teuchos::RCP<const Teuchos::Comm<int> > comm = Teuchos::DefaultComm<int>::getComm();
+    Teuchos::RCP<pike_test::MockModelEvaluator> app =
+      pike_test::mockModelEvaluator(comm,"app",pike_test::MockModelEvaluator::GLOBAL_CONVERGENCE,200,-1);
+    Teuchos::RCP<pike::BlockGaussSeidel> solver = Teuchos::rcp(new pike::BlockGaussSeidel);
+    app->setSolver(solver);
+    solver->registerModelEvaluator(app);
+    solver->registerDataTransfer(Teuchos::rcp(new ResidualSequenceTransfer(numContracting,finalRatio)));
+    solver->completeRegistration();
+    solver->setStatusTests(tests);
+    solver->solve();
+    return solver;
+  }
+
+  Teuchos::RCP<pike::Composite>
+  buildCouplingResidualFailureTests(Teuchos::RCP<pike::CouplingResidualDivergence>& divergence,
+				    Teuchos::RCP<pike::CouplingResidualStagnation>& stagnation)
+  {
+    pike::StatusTestFactory stFactory;
+    {
+      Teuchos::RCP<Teuchos::ParameterList> p = Teuchos::parameterList("Divergence");
+      p->set("Type","Coupling Residual Divergence");
+      p->set("Number of Iterations",3);
+      divergence = Teuchos::rcp_dynamic_cast<pike::CouplingResidualDivergence>(stFactory.buildStatusTests(p),true);
+    }
+    {
+      Teuchos::RCP<Teuchos::ParameterList> p = Teuchos::parameterList("Stagnation");
+      p->set("Type","Coupling Residual Stagnation");
+      p->set("Number of Iterations",5);
+      p->set("Stagnation Rate",0.95);
+      stagnation = Teuchos::rcp_dynamic_cast<pike::CouplingResidualStagnation>(stFactory.buildStatusTests(p),true);
+    }
+    Teuchos::RCP<pike::Composite> tests = pike::composite(pike::Composite::OR);
+    tests->addTest(Teuchos::rcp(new pike::MaxIterations(50)));
+    tests->addTest(divergence);
+    tests->addTest(stagnation);
+    return tests;
+  }
+
+  TEUCHOS_UNIT_TEST(status_test, CouplingResidualFailure)
+  {
+    // Ring buffer wraps around
+    {
+      pike::ResidualHistory history(3);
+      for (int i = 0; i < 5; ++i)
+	history.push(std::pow(0.5,i));
+      TEST_EQUALITY(history.size(),3);
+      TEST_EQUALITY(history[0],0.0625);
+      TEST_EQUALITY(history[2],0.25);
+      TEST_FLOATING_EQUALITY(history.contractionRate(2),0.5,1.0e-12);
+      TEST_THROW(history.contractionRate(3),std::logic_error);
+    }
+
+    // Diverging: residuals 1, 0.5, 0.25, 0.125, 0.25, 0.5, ...  The
+    // rate over 3 iterations first exceeds 1 in iteration 6.
+    {
+      Teuchos::RCP<pike::CouplingResidualDivergence> divergence;
+      Teuchos::RCP<pike::CouplingResidualStagnation> stagnation;
+      Teuchos::RCP<pike::BlockGaussSeidel> solver =
+	solveResidualSequence(buildCouplingResidualFailureTests(divergence,stagnation),3,2.0);
+
+      TEST_EQUALITY(solver->getStatus(),pike::FAILED);
+      TEST_EQUALITY(solver->getNumberOfIterations(),6);
+      TEST_EQUALITY(divergence->getStatus(),pike::FAILED);
+      TEST_FLOATING_EQUALITY(divergence->getContractionRate(),std::pow(2.0,1.0/3.0),1.0e-12);
+
+      // A repeated check of the same iteration does not add to the
+      // history
+      TEST_EQUALITY(divergence->checkStatus(*solver,pike::MINIMAL),pike::FAILED);
+      TEST_FLOATING_EQUALITY(divergence->getContractionRate(),std::pow(2.0,1.0/3.0),1.0e-12);
+    }
+
+    // Stagnating: the residual shrinks by 0.99 from iteration 4 on,
+    // the fifth stagnant iteration is iteration 8.
+    {
+      Teuchos::RCP<pike::CouplingResidualDivergence> divergence;
+      Teuchos::RCP<pike::CouplingResidualStagnation> stagnation;
+      Teuchos::RCP<pike::BlockGaussSeidel> solver =
+	solveResidualSequence(buildCouplingResidualFailureTests(divergence,stagnation),2,0.99);
+
+      TEST_EQUALITY(solver->getStatus(),pike::FAILED);
+      TEST_EQUALITY(solver->getNumberOfIterations(),8);
+      TEST_EQUALITY(divergence->getStatus(),pike::UNCONVERGED);
+      TEST_EQUALITY(stagnation->getStatus(),pike::FAILED);
+      TEST_FLOATING_EQUALITY(stagnation->getContractionRate(),0.99,1.0e-12);
+
+      // Reset clears the history
+      solver->reset();
+      TEST_EQUALITY(stagnation->getStatus(),pike::UNCHECKED);
+      TEST_ASSERT(stagnation->getContractionRate() < 0.0);
+    }
+  }
+
+  TEUCHOS_UNIT_TEST(status_test, ExtrapolatedCouplingError)
+  {
+    // Slow contraction: residuals 0.9^(k-1), so the distance to the
+    // fixed point after iteration k is 9 * 0.9^(k-1).  A test on the
+    // raw residual stops at iteration 30 with an error of 0.42, the
+    // extrapolated error needs 51 iterations.
+    for (int extrapolate = 0; extrapolate < 2; ++extrapolate) {
+      pike::StatusTestFactory stFactory;
+      Teuchos::RCP<Teuchos::ParameterList> p = Teuchos::parameterList("Converged");
+      p->set("Type",extrapolate ? "Extrapolated Coupling Error" : "Global Coupling Residual");
+      p->set("Tolerance",0.05);
+      Teuchos::RCP<pike::StatusTest> converged = stFactory.buildStatusTests(p);
+
+      Teuchos::RCP<pike::Composite> tests = pike::composite(pike::Composite::OR);
+      tests->addTest(Teuchos::rcp(new pike::MaxIterations(100)));
+      tests->addTest(converged);
+
+      Teuchos::RCP<pike::BlockGaussSeidel> solver = solveResidualSequence(tests,0,0.9);
+
+      TEST_EQUALITY(solver->getStatus(),pike::CONVERGED);
+      if (extrapolate) {
+	TEST_EQUALITY(solver->getNumberOfIterations(),51);
+	Teuchos::RCP<pike::ExtrapolatedCouplingError> error =
+	  Teuchos::rcp_dynamic_cast<pike::ExtrapolatedCouplingError>(converged,true);
+	TEST_FLOATING_EQUALITY(error->getContractionRate(),0.9,1.0e-10);
+	TEST_FLOATING_EQUALITY(error->getErrorEstimate(),9.0*std::pow(0.9,50),1.0e-8);
+      }
+      else {
+	TEST_EQUALITY(solver->getNumberOfIterations(),30);
+      }
+    }
+
+    // Relative to the transferred data, with both norms reduced over
+    // the comm.  Each process reports the same residuals and a target
+    // norm of one, so the tolerance is met at the same iteration and
+    // the estimate is sqrt(p) times the local one.
+    {
+      Teuchos::RCP<const Teuchos::Comm<int> > comm = Teuchos::DefaultComm<int>::getComm();
+      pike::StatusTestFactory stFactory;
+      Teuchos::RCP<Teuchos::ParameterList> p = Teuchos::parameterList("Converged");
+      p->set("Type","Extrapolated Coupling Error");
+      p->set("Tolerance Type","Relative");
+      p->set("Tolerance",0.05);
+      Teuchos::RCP<pike::ExtrapolatedCouplingError> error =
+	Teuchos::rcp_dynamic_cast<pike::ExtrapolatedCouplingError>(stFactory.buildStatusTests(p),true);
+      error->setComm(comm);
+
+      Teuchos::RCP<pike::Composite> tests = pike::composite(pike::Composite::OR);
+      tests->addTest(Teuchos::rcp(new pike::MaxIterations(100)));
+      tests->addTest(error);
+
+      Teuchos::RCP<pike::BlockGaussSeidel> solver = solveResidualSequence(tests,0,0.9);
+
+      TEST_EQUALITY(solver->getStatus(),pike::CONVERGED);
+      TEST_EQUALITY(solver->getNumberOfIterations(),51);
+      TEST_FLOATING_EQUALITY(error->getErrorEstimate(),
+			     std::sqrt(static_cast<double>(comm->getSize()))*9.0*std::pow(0.9,50),1.0e-8);
+    }
+
+    // A rate of one or above has no estimate and never converges
+    {
+      pike::StatusTestFactory stFactory;
+      Teuchos::RCP<Teuchos::ParameterList> p = Teuchos::parameterList("Converged");
+      p->set("Type","Extrapolated Coupling Error");
+      p->set("Tolerance",1.0e10);
+      Teuchos::RCP<pike::ExtrapolatedCouplingError> error =
+	Teuchos::rcp_dynamic_cast<pike::ExtrapolatedCouplingError>(stFactory.buildStatusTests(p),true);
+
+      Teuchos::RCP<pike::Composite> tests = pike::composite(pike::Composite::OR);
+      tests->addTest(Teuchos::rcp(new pike::MaxIterations(10)));
+      tests->addTest(error);
+
+      Teuchos::RCP<pike::BlockGaussSeidel> solver = solveResidualSequence(tests,0,1.0);
+
+      TEST_EQUALITY(solver->getStatus(),pike::FAILED);
+      TEST_EQUALITY(solver->getNumberOfIterations(),10);
+      TEST_EQUALITY(error->getStatus(),pike::UNCONVERGED);
+      TEST_FLOATING_EQUALITY(error->getContractionRate(),1.0,1.0e-12);
+      TEST_ASSERT(error->getErrorEstimate() < 0.0);
+    }
+  }
+
   TEUCHOS_UNIT_TEST(status_test, Composite_AND)
   {
 
@@ -412,6 +832,73 @@ namespace pike {
     TEST_EQUALITY(tests->getStatus(),pike::UNCHECKED);
  }
 
+  TEUCHOS_UNIT_TEST(status_test, Composite_REDUCED)
+  {
+
+    Teuchos::RCP<const Teuchos::Comm<int> > comm = Teuchos::DefaultComm<int>::getComm();
+
+    Teuchos::RCP<pike::ScalarResponseRelativeTolerance> relTol1 = 
+      Teuchos::rcp(new pike::ScalarResponseRelativeTolerance);
+    {
+      Teuchos::RCP<Teuchos::ParameterList> p = Teuchos::parameterList("ST");
+      p->set("Application Name","app1");
+      p->set("Response Name","Mock Response");
+      p->set("Tolerance",1.0e-3);
+      relTol1->setParameterList(p);
+    }
+
+    Teuchos::RCP<pike::ScalarResponseRelativeTolerance> relTol2 = 
+      Teuchos::rcp(new pike::ScalarResponseRelativeTolerance);
+    {
+      Teuchos::RCP<Teuchos::ParameterList> p = Teuchos::parameterList("ST");
+      p->set("Application Name","app2");
+      p->set("Response Name","Mock Response");
+      p->set("Tolerance",1.0e-3);
+      relTol2->setParameterList(p);
+    }
+
+    Teuchos::RCP<pike::Composite> converged = pike::composite(pike::Composite::AND);
+    converged->addTest(relTol1);
+    converged->addTest(relTol2);
+
+    Teuchos::RCP<pike::MaxIterations> maxIters = Teuchos::rcp(new pike::MaxIterations);
+    {
+      Teuchos::RCP<Teuchos::ParameterList> p = Teuchos::parameterList("ST");
+      p->set("Maximum Iterations",10);
+      maxIters->setParameterList(p);
+    }
+
+    // All three leaf tests of the nested composites are reduced
+    // together
+    Teuchos::RCP<pike::Composite> tests = pike::composite(pike::Composite::OR);
+    tests->addTest(converged);
+    tests->addTest(maxIters);
+    tests->setReductionComm(comm);
+
+    Teuchos::RCP<pike_test::MockModelEvaluator> app1 = 
+      pike_test::mockModelEvaluator(comm,"app1",pike_test::MockModelEvaluator::LOCAL_FAILURE,10,5);
+
+    Teuchos::RCP<pike_test::MockModelEvaluator> app2 = 
+      pike_test::mockModelEvaluator(comm,"app2",pike_test::MockModelEvaluator::LOCAL_FAILURE,10,7);
+
+    Teuchos::RCP<pike::BlockGaussSeidel> solver = Teuchos::rcp(new pike::BlockGaussSeidel);
+    app1->setSolver(solver);
+    app2->setSolver(solver);
+    solver->registerModelEvaluator(app1);
+    solver->registerModelEvaluator(app2);
+    solver->completeRegistration();
+    solver->setStatusTests(tests);
+    solver->solve();
+
+    // Same answer as the unreduced composite
+    TEST_EQUALITY(solver->getStatus(),pike::CONVERGED);
+    TEST_EQUALITY(converged->getStatus(),pike::CONVERGED);
+    TEST_EQUALITY(solver->getNumberOfIterations(),7);
+
+    // One reduction for the initial check and one per iteration
+    TEST_EQUALITY(tests->getNumberOfReductions(),8);
+  }
+
   TEUCHOS_UNIT_TEST(status_test, Factory)
   {
 
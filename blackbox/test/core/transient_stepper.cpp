@@ -22,6 +22,36 @@
 
 namespace pike_test {
 
+  // Transient model whose step size limits differ on each process
+  class StepLimitedME : public pike::BlackBoxModelEvaluator {
+  public:
+    StepLimitedME(const double desiredStepSize, const double maxStepSize, const int numFailedSolves = 0) :
+      desiredStepSize_(desiredStepSize), maxStepSize_(maxStepSize),
+      currentTime_(0.0), stepSize_(0.0), numAcceptedSteps_(0),
+      numFailedSolves_(numFailedSolves), numSolves_(0) {}
+    std::string name() const { return "Step Limited"; }
+    void solve() { ++numSolves_; }
+    //! The first numFailedSolves solves fail.
+    bool isLocallyConverged() const { return numSolves_ > numFailedSolves_; }
+    bool isTransient() const { return true; }
+    double getCurrentTime() const { return currentTime_; }
+    double getDesiredTimeStepSize() const { return desiredStepSize_; }
+    double getMaxTimeStepSize() const { return maxStepSize_; }
+    void setNextTimeStepSize(const double& dt) { stepSize_ = dt; }
+    void acceptTimeStep() { currentTime_ += stepSize_; ++numAcceptedSteps_; }
+    int getNumberOfAcceptedSteps() const { return numAcceptedSteps_; }
+    int getNumberOfSolves() const { return numSolves_; }
+    double getStepSize() const { return stepSize_; }
+  private:
+    double desiredStepSize_;
+    double maxStepSize_;
+    double currentTime_;
+    double stepSize_;
+    int numAcceptedSteps_;
+    int numFailedSolves_;
+    int numSolves_;
+  };
+
   TEUCHOS_UNIT_TEST(TransientStepper, VanDerPol)
   {
     using Teuchos::RCP;
@@ -137,10 +167,123 @@ namespace pike_test {
     TEST_EQUALITY(solver->getModelEvaluators().size(),2)
     TEST_ASSERT(nonnull(solver->getDataTransfer("Eq1->Eq2")));
     TEST_EQUALITY(solver->getDataTransfers().size(),2);
+    TEST_EQUALITY(solver->getModelEvaluatorsView().size(),2);
+    TEST_EQUALITY(solver->getDataTransfersView().size(),2);
     TEST_EQUALITY(solver->name(), "My Special Solver");
     RCP<pike::SolverObserver> logger = (solver->getObservers())[0];
     TEST_EQUALITY((Teuchos::rcp_dynamic_cast<pike::LoggerObserver>(logger))->getLog()->size(),82);
     TEST_THROW(solver->reset(), std::logic_error);
   }
 
+  Teuchos::RCP<pike::Solver> buildStepLimitedSolver(const Teuchos::RCP<const Teuchos::Comm<int> >& comm,
+						    const Teuchos::RCP<StepLimitedME>& me,
+						    const double minStepSize)
+  {
+    using Teuchos::RCP;
+    using Teuchos::ParameterList;
+
+    RCP<ParameterList> p = Teuchos::parameterList("Transient Solver");
+    p->set("Solver Sublist Name", "Stepper");
+    ParameterList& pt = p->sublist("Stepper");
+    pt.set("Type","Transient Stepper");
+    pt.set("Maximum Number of Time Steps",100);
+    pt.set("Begin Time", 0.0);
+    pt.set("End Time", 0.9);
+    pt.set("Initial Time Step Size",1.0);
+    pt.set("Minimum Time Step Size",minStepSize);
+    pt.set("Maximum Time Step Size",10.0);
+    pt.set("Number Converged Time Steps for Growth",0);
+    pt.set("Print Time Step Summary",false);
+    pt.set("Print Time Step Details",false);
+    pt.set("Distributed Step Size Negotiation",true);
+    pt.set("Internal Solver Sublist","Inner");
+    ParameterList& pi = p->sublist("Inner");
+    pi.set("Type","Block Gauss Seidel");
+
+    // A solve that does not converge the model fails
+    RCP<ParameterList> stp = Teuchos::parameterList("Status Test Builder");
+    stp->set("Type","Composite OR");
+    ParameterList& converged = stp->sublist("Converged");
+    converged.set("Type","Local Model Convergence");
+    converged.set("Model Name","Step Limited");
+    ParameterList& failed = stp->sublist("Failed");
+    failed.set("Type","Maximum Iterations");
+    failed.set("Maximum Iterations",1);
+    pike::StatusTestFactory stFactory;
+    RCP<pike::StatusTest> tests = stFactory.buildStatusTests(stp);
+
+    pike::SolverFactory factory;
+    RCP<pike::Solver> solver = factory.buildSolver(p);
+    solver->registerComm(comm);
+    solver->registerModelEvaluator(me);
+    solver->completeRegistration();
+    solver->setStatusTests(tests);
+    return solver;
+  }
+
+  TEUCHOS_UNIT_TEST(TransientStepper, DistributedStepSizeNegotiation)
+  {
+    using Teuchos::RCP;
+    using Teuchos::rcp;
+
+    RCP<Teuchos::MpiComm<int> > globalComm = 
+      rcp(new Teuchos::MpiComm<int>(Teuchos::opaqueWrapper(MPI_COMM_WORLD)));
+
+    // Rank 0 wants steps of 0.125, all others of 0.25.  Every process
+    // has to take the smallest step.
+    const double desiredStepSize = (globalComm->getRank() == 0) ? 0.125 : 0.25;
+    RCP<StepLimitedME> me = rcp(new StepLimitedME(desiredStepSize,10.0));
+    RCP<pike::Solver> solver = buildStepLimitedSolver(globalComm,me,1.0e-5);
+    solver->initialize();
+    solver->solve();
+    solver->finalize();
+
+    TEST_EQUALITY(solver->getStatus(),pike::CONVERGED);
+    TEST_EQUALITY(solver->getNumberOfIterations(),8);
+    TEST_EQUALITY(me->getNumberOfAcceptedSteps(),8);
+    TEST_FLOATING_EQUALITY(me->getCurrentTime(),0.9,1.0e-12);
+  }
+
+  TEUCHOS_UNIT_TEST(TransientStepper, DistributedSolveFailure)
+  {
+    using Teuchos::RCP;
+    using Teuchos::rcp;
+
+    RCP<Teuchos::MpiComm<int> > globalComm = 
+      rcp(new Teuchos::MpiComm<int>(Teuchos::opaqueWrapper(MPI_COMM_WORLD)));
+
+    // Only the first solve on rank 0 fails, but every process must cut
+    // the step: 0.25 fails, then 0.125, 0.25, 0.25, 0.25 and 0.025.
+    const int numFailedSolves = (globalComm->getRank() == 0) ? 1 : 0;
+    RCP<StepLimitedME> me = rcp(new StepLimitedME(0.25,10.0,numFailedSolves));
+    RCP<pike::Solver> solver = buildStepLimitedSolver(globalComm,me,1.0e-5);
+    solver->initialize();
+    solver->solve();
+    solver->finalize();
+
+    TEST_EQUALITY(solver->getStatus(),pike::CONVERGED);
+    TEST_EQUALITY(solver->getNumberOfIterations(),5);
+    TEST_EQUALITY(me->getNumberOfSolves(),6);
+    TEST_EQUALITY(me->getNumberOfAcceptedSteps(),5);
+    TEST_FLOATING_EQUALITY(me->getStepSize(),0.025,1.0e-10);
+    TEST_FLOATING_EQUALITY(me->getCurrentTime(),0.9,1.0e-12);
+  }
+
+  TEUCHOS_UNIT_TEST(TransientStepper, DistributedMaxStepSizeViolation)
+  {
+    using Teuchos::RCP;
+    using Teuchos::rcp;
+
+    RCP<Teuchos::MpiComm<int> > globalComm = 
+      rcp(new Teuchos::MpiComm<int>(Teuchos::opaqueWrapper(MPI_COMM_WORLD)));
+
+    // Only the last rank violates the minimum step size, but all
+    // processes must fail
+    const double maxStepSize = (globalComm->getRank() == globalComm->getSize()-1) ? 1.0e-6 : 10.0;
+    RCP<StepLimitedME> me = rcp(new StepLimitedME(1.0,maxStepSize));
+    RCP<pike::Solver> solver = buildStepLimitedSolver(globalComm,me,1.0e-5);
+    solver->initialize();
+    TEST_THROW(solver->solve(),std::runtime_error);
+  }
+
 }
@@ -1,5 +1,6 @@
 #include "Pike_LinearHeatConduction_DataTransfer.hpp"
 #include "Pike_LinearHeatConduction_ModelEvaluator.hpp"
+#include <cmath>
 
 namespace pike_test {
 
@@ -10,7 +11,10 @@ namespace pike_test {
   :
     comm_(comm),
     name_(myName),
-    mode_(mode)
+    mode_(mode),
+    changeTolerance_(0.0),
+    changeNormSquared_(0.0),
+    targetNormSquared_(0.0)
   {
   }
   
@@ -23,12 +27,25 @@ namespace pike_test {
   {
     const double dampingFactor = 0.5;
 
+    changeNormSquared_ = 0.0;
+    targetNormSquared_ = 0.0;
+
     for (std::vector<Teuchos::RCP<pike_test::LinearHeatConductionModelEvaluator> >::iterator target = targets_.begin();
 	 target != targets_.end(); ++target) {
-      if (mode_ == TRANSFER_T)
-	(*target)->set_T_left(dampingFactor * source_->get_T_right());
-      else if (mode_ == TRANSFER_Q)
-	(*target)->set_q(dampingFactor * source_->get_q());
+      if (mode_ == TRANSFER_T) {
+	const double value = dampingFactor * source_->get_T_right();
+	const double change = value - (*target)->get_T_left();
+	changeNormSquared_ += change * change;
+	targetNormSquared_ += value * value;
+	(*target)->set_T_left(value);
+      }
+      else if (mode_ == TRANSFER_Q) {
+	const double value = dampingFactor * source_->get_q();
+	const double change = value - (*target)->get_q();
+	changeNormSquared_ += change * change;
+	targetNormSquared_ += value * value;
+	(*target)->set_q(value);
+      }
       else {
 	TEUCHOS_ASSERT(false);
       }
@@ -51,6 +68,47 @@ namespace pike_test {
     return targetNames_;
   }
 
+  double LinearHeatConductionDataTransfer::targetValue(const std::size_t i) const
+  {
+    return (mode_ == TRANSFER_T) ? targets_[i]->get_T_left() : targets_[i]->get_q();
+  }
+
+  bool LinearHeatConductionDataTransfer::changedTarget(const std::string& targetModelName) const
+  {
+    for (std::size_t i = 0; i < targets_.size(); ++i) {
+      if (targetNames_[i] == targetModelName) {
+	if (!solvedTargets_[i] || (std::fabs(this->targetValue(i) - valuesAtLastSolve_[i]) > changeTolerance_))
+	  return true;
+      }
+    }
+    return false;
+  }
+
+  void LinearHeatConductionDataTransfer::targetSolved(const std::string& targetModelName)
+  {
+    for (std::size_t i = 0; i < targets_.size(); ++i) {
+      if (targetNames_[i] == targetModelName) {
+	solvedTargets_[i] = true;
+	valuesAtLastSolve_[i] = this->targetValue(i);
+      }
+    }
+  }
+
+  double LinearHeatConductionDataTransfer::getChangeNormSquared() const
+  {
+    return changeNormSquared_;
+  }
+
+  double LinearHeatConductionDataTransfer::getTargetNormSquared() const
+  {
+    return targetNormSquared_;
+  }
+
+  void LinearHeatConductionDataTransfer::setChangeTolerance(const double tolerance)
+  {
+    changeTolerance_ = tolerance;
+  }
+
   void LinearHeatConductionDataTransfer::setSource(const Teuchos::RCP<pike_test::LinearHeatConductionModelEvaluator>& source)
   {
     source_ = source;
@@ -61,6 +119,8 @@ namespace pike_test {
   {
     targets_.push_back(target);
     targetNames_.push_back(target->name());
+    solvedTargets_.push_back(false);
+    valuesAtLastSolve_.push_back(0.0);
     
     if (mode_ == TRANSFER_T)
       TEUCHOS_ASSERT(targets_.size() == 1);
@@ -71,6 +131,8 @@ namespace pike_test {
   {
     targets_.push_back(target);
     targetNames_.push_back(overrideTargetModelName);
+    solvedTargets_.push_back(false);
+    valuesAtLastSolve_.push_back(0.0);
     
     if (mode_ == TRANSFER_T)
       TEUCHOS_ASSERT(targets_.size() == 1);    
@@ -50,8 +50,22 @@ namespace pike_test {
     
     const std::vector<std::string>& getTargetModelNames() const;
 
+    bool changedTarget(const std::string& targetModelName) const;
+
+    void targetSolved(const std::string& targetModelName);
+
+    double getChangeNormSquared() const;
+
+    double getTargetNormSquared() const;
+
     //@}
 
+    /** \brief Sets the absolute tolerance used to decide if a target value changed since the target's last solve.
+
+	Defaults to 0.0, meaning any change in the transferred value is reported.
+    */
+    void setChangeTolerance(const double tolerance);
+
     void setSource(const Teuchos::RCP<pike_test::LinearHeatConductionModelEvaluator>& source);
 
     void addTarget(const Teuchos::RCP<pike_test::LinearHeatConductionModelEvaluator>& target);
@@ -61,6 +75,8 @@ namespace pike_test {
 		   const std::string& overrideTargetModelName);
 
   private:
+    double targetValue(const std::size_t i) const;
+
     Teuchos::RCP<const Teuchos::Comm<int> > comm_;
     std::string name_;
     Mode mode_;
@@ -68,6 +84,11 @@ namespace pike_test {
     std::vector<Teuchos::RCP<pike_test::LinearHeatConductionModelEvaluator> > targets_;
     std::vector<std::string> sourceNames_;
     std::vector<std::string> targetNames_;
+    double changeTolerance_;
+    std::vector<bool> solvedTargets_;
+    std::vector<double> valuesAtLastSolve_;
+    double changeNormSquared_;
+    double targetNormSquared_;
   };
 
   /** \brief non-member ctor
@@ -97,6 +97,21 @@ namespace pike_test {
       this->set_T_right(p[0]);
   }
 
+  Teuchos::ArrayView<const double> LinearHeatConductionModelEvaluator::getParameter(const int l) const
+  {
+    TEUCHOS_ASSERT( (l>=0) && (l<Teuchos::as<int>(parameterNames_.size())) );
+    if (mode_ == T_RIGHT_IS_RESPONSE)
+      return Teuchos::ArrayView<const double>(&q_,1);
+    else
+      return Teuchos::ArrayView<const double>(&T_right_,1);
+  }
+
+  int LinearHeatConductionModelEvaluator::getParameterSize(const int l) const
+  {
+    TEUCHOS_ASSERT( (l>=0) && (l<Teuchos::as<int>(parameterNames_.size())) );
+    return 1;
+  }
+
   Teuchos::ArrayView<const double> LinearHeatConductionModelEvaluator::getResponse(const int i) const
   {
     return Teuchos::ArrayView<const double>(responseValues_[i]);
@@ -56,6 +56,8 @@ namespace pike_test {
     virtual std::string getParameterName(const int l) const;
     virtual int getParameterIndex(const std::string& pName) const;
     virtual void setParameter(const int l, const Teuchos::ArrayView<const double>& p);
+    virtual Teuchos::ArrayView<const double> getParameter(const int l) const;
+    virtual int getParameterSize(const int l) const;
 
     Teuchos::ArrayView<const double> getResponse(const int i) const;
     int getResponseIndex(const std::string& rName) const;
@@ -3,6 +3,9 @@
 #include "Pike_Solver_BlockGaussSeidel.hpp"
 #include "Pike_LinearHeatConduction_ModelEvaluator.hpp"
 #include "Pike_LinearHeatConduction_DataTransfer.hpp"
+#include "Pike_Mock_ModelEvaluator.hpp"
+#include "Pike_BlackBoxModelEvaluator_SolverAdapter.hpp"
+#include "Pike_BlackBoxModelEvaluator_Caching.hpp"
 
 #include "Teuchos_DefaultMpiComm.hpp"
 #include <iostream>
@@ -29,6 +32,169 @@ namespace pike_test {
     std::cout << *bbme << std::endl;
   }
 
+  TEUCHOS_UNIT_TEST(app, LinearHeatConduction_getParameter)
+  {
+    using Teuchos::RCP;
+    using Teuchos::rcp;
+    RCP<Teuchos::MpiComm<int> > globalComm = rcp(new Teuchos::MpiComm<int>(Teuchos::opaqueWrapper(MPI_COMM_WORLD)));
+
+    RCP<LinearHeatConductionModelEvaluator> wall = 
+      linearHeatConductionModelEvaluator(globalComm,"wall",pike_test::LinearHeatConductionModelEvaluator::T_RIGHT_IS_RESPONSE);
+    const int l = wall->getParameterIndex("q");
+
+    std::vector<double> q(1,3.0);
+    wall->setParameter(l,Teuchos::arrayViewFromVector(q));
+    TEST_EQUALITY(wall->getParameter(l).size(), 1);
+    TEST_FLOATING_EQUALITY(wall->getParameter(l)[0], 3.0, 1.0e-12);
+
+    // Values written directly (e.g. by a DataTransfer) are also reported
+    wall->set_q(4.0);
+    TEST_FLOATING_EQUALITY(wall->getParameter(l)[0], 4.0, 1.0e-12);
+
+    RCP<pike::BlackBoxModelEvaluator> bbme = 
+      linearHeatConductionModelEvaluator(globalComm,"wall",pike_test::LinearHeatConductionModelEvaluator::Q_IS_RESPONSE);
+    bbme->setParameter(bbme->getParameterIndex("T_right"),Teuchos::arrayViewFromVector(q));
+    TEST_FLOATING_EQUALITY(bbme->getParameter(bbme->getParameterIndex("T_right"))[0], 3.0, 1.0e-12);
+  }
+
+  TEUCHOS_UNIT_TEST(app, batched_parameters_and_responses)
+  {
+    using Teuchos::RCP;
+    using Teuchos::rcp;
+    RCP<Teuchos::MpiComm<int> > globalComm = rcp(new Teuchos::MpiComm<int>(Teuchos::opaqueWrapper(MPI_COMM_WORLD)));
+
+    RCP<LinearHeatConductionModelEvaluator> wall = 
+      linearHeatConductionModelEvaluator(globalComm,"wall",pike_test::LinearHeatConductionModelEvaluator::T_RIGHT_IS_RESPONSE);
+    wall->set_T_left(7.0);
+    wall->set_k(1.0);
+    RCP<pike::BlackBoxModelEvaluator> bbme = wall;
+
+    const int q = bbme->getParameterIndex("q");
+    TEST_EQUALITY(bbme->getParameterSize(q), 1);
+
+    std::vector<int> l(1,q);
+    std::vector<double> p(1,1.0);
+    bbme->setParameters(Teuchos::arrayViewFromVector(l),Teuchos::arrayViewFromVector(p));
+    TEST_FLOATING_EQUALITY(wall->get_q(), 1.0, 1.0e-12);
+
+    std::vector<double> pTooLarge(2,1.0);
+    TEST_THROW(bbme->setParameters(Teuchos::arrayViewFromVector(l),Teuchos::arrayViewFromVector(pTooLarge)), std::logic_error);
+
+    bbme->solve();
+
+    // Request all responses, with one twice, in a single packed buffer
+    std::vector<int> j;
+    int totalSize = 0;
+    for (int i = 0; i < bbme->getNumberOfResponses(); ++i) {
+      j.push_back(i);
+      totalSize += bbme->getResponseSize(i);
+    }
+    const int T_right = bbme->getResponseIndex("T_right");
+    j.push_back(T_right);
+    totalSize += bbme->getResponseSize(T_right);
+
+    std::vector<double> g(totalSize,0.0);
+    bbme->getResponses(Teuchos::arrayViewFromVector(j),Teuchos::arrayViewFromVector(g));
+
+    int offset = 0;
+    for (std::size_t i = 0; i < j.size(); ++i) {
+      Teuchos::ArrayView<const double> g_i = bbme->getResponse(j[i]);
+      for (int k = 0; k < g_i.size(); ++k)
+	TEST_EQUALITY(g[offset+k], g_i[k]);
+      offset += g_i.size();
+    }
+    TEST_FLOATING_EQUALITY(g[totalSize-1], 6.0, 1.0e-12);
+
+    std::vector<double> gTooSmall(totalSize-1,0.0);
+    TEST_THROW(bbme->getResponses(Teuchos::arrayViewFromVector(j),Teuchos::arrayViewFromVector(gTooSmall)), std::logic_error);
+  }
+
+  TEUCHOS_UNIT_TEST(app, batched_calls_without_sizes_and_forwarded)
+  {
+    using Teuchos::RCP;
+    using Teuchos::rcp;
+    using Teuchos::arrayViewFromVector;
+    RCP<Teuchos::MpiComm<int> > globalComm = rcp(new Teuchos::MpiComm<int>(Teuchos::opaqueWrapper(MPI_COMM_WORLD)));
+
+    // The default size does not need getParameter(), which the mock
+    // does not implement, so only single parameters can be batched
+    {
+      RCP<pike::BlackBoxModelEvaluator> mock = 
+	mockModelEvaluator(globalComm,"mock",pike_test::MockModelEvaluator::LOCAL_FAILURE,10,5);
+      TEST_EQUALITY(mock->getParameterSize(0), -1);
+      std::vector<int> l(1,0);
+      std::vector<double> p(3,1.0);
+      TEST_NOTHROW(mock->setParameters(arrayViewFromVector(l),arrayViewFromVector(p)));
+      l.push_back(0);
+      TEST_THROW(mock->setParameters(arrayViewFromVector(l),arrayViewFromVector(p)), std::logic_error);
+    }
+
+    RCP<LinearHeatConductionModelEvaluator> leftWall = 
+      linearHeatConductionModelEvaluator(globalComm,"left wall",pike_test::LinearHeatConductionModelEvaluator::T_RIGHT_IS_RESPONSE);
+    RCP<LinearHeatConductionModelEvaluator> rightWall = 
+      linearHeatConductionModelEvaluator(globalComm,"right wall",pike_test::LinearHeatConductionModelEvaluator::Q_IS_RESPONSE);
+
+    // Solver adapter splits the batch per model
+    {
+      RCP<pike::BlockGaussSeidel> solver = rcp(new pike::BlockGaussSeidel);
+      solver->registerModelEvaluator(leftWall);
+      solver->registerModelEvaluator(rightWall);
+      solver->completeRegistration();
+      RCP<pike::SolverAdapterModelEvaluator> adapter = rcp(new pike::SolverAdapterModelEvaluator("adapter"));
+      adapter->setSolver(solver);
+
+      std::vector<int> l;
+      l.push_back(adapter->getParameterIndex("T_right"));
+      l.push_back(adapter->getParameterIndex("q"));
+      TEST_EQUALITY(adapter->getParameterSize(l[0]), 1);
+      std::vector<double> p;
+      p.push_back(3.0);
+      p.push_back(2.0);
+      adapter->setParameters(arrayViewFromVector(l),arrayViewFromVector(p));
+      TEST_FLOATING_EQUALITY(rightWall->get_T_right(), 3.0, 1.0e-12);
+      TEST_FLOATING_EQUALITY(leftWall->get_q(), 2.0, 1.0e-12);
+
+      // T_right = 1 - 2 / 1 and q = (1 - 3) * 1
+      leftWall->solve();
+      rightWall->solve();
+      std::vector<int> j;
+      j.push_back(adapter->getResponseIndex("T_right"));
+      j.push_back(adapter->getResponseIndex("q"));
+      j.push_back(adapter->getResponseIndex("T_right"));
+      TEST_EQUALITY(adapter->getResponseSize(j[1]), 1);
+      std::vector<double> g(3,0.0);
+      adapter->getResponses(arrayViewFromVector(j),arrayViewFromVector(g));
+      TEST_FLOATING_EQUALITY(g[0], -1.0, 1.0e-12);
+      TEST_FLOATING_EQUALITY(g[1], -2.0, 1.0e-12);
+      TEST_FLOATING_EQUALITY(g[2], -1.0, 1.0e-12);
+    }
+
+    // Caching decorator records batched parameters for its lookup
+    {
+      RCP<pike::CachingModelEvaluator> cached = pike::cachingModelEvaluator(leftWall);
+      cached->registerComm(globalComm);
+      std::vector<int> l(1,cached->getParameterIndex("q"));
+      TEST_EQUALITY(cached->getParameterSize(l[0]), 1);
+      std::vector<double> p(1,2.0);
+      cached->setParameters(arrayViewFromVector(l),arrayViewFromVector(p));
+      cached->solve();
+      p[0] = 4.0;
+      cached->setParameters(arrayViewFromVector(l),arrayViewFromVector(p));
+      cached->solve();
+      p[0] = 2.0;
+      cached->setParameters(arrayViewFromVector(l),arrayViewFromVector(p));
+      cached->solve();
+      TEST_EQUALITY(cached->getNumberOfCacheMisses(), 2);
+      TEST_EQUALITY(cached->getNumberOfCacheHits(), 1);
+
+      std::vector<int> j(1,cached->getResponseIndex("T_right"));
+      TEST_EQUALITY(cached->getResponseSize(j[0]), 1);
+      std::vector<double> g(1,0.0);
+      cached->getResponses(arrayViewFromVector(j),arrayViewFromVector(g));
+      TEST_FLOATING_EQUALITY(g[0], -1.0, 1.0e-12);
+    }
+  }
+
   TEUCHOS_UNIT_TEST(app, LinearHeatConduction_BlockJacobi)
   {
     using Teuchos::RCP;
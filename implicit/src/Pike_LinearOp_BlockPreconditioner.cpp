@@ -0,0 +1,14 @@
+#include "Pike_BlackBox_config.hpp"
+
+#ifdef HAVE_PIKE_EXPLICIT_INSTANTIATION
+
+#include "Pike_LinearOp_BlockPreconditioner.hpp"
+#include "Pike_LinearOp_BlockPreconditioner_def.hpp"
+
+namespace pike {
+
+  template class BlockPreconditionerOp<double>;
+
+}
+
+#endif
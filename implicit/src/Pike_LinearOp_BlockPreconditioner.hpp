@@ -0,0 +1,107 @@
+#ifndef PIKE_LINEAR_OP_BLOCK_PRECONDITIONER_HPP
+#define PIKE_LINEAR_OP_BLOCK_PRECONDITIONER_HPP
+
+#include "Pike_BlackBox_config.hpp"
+#include "Thyra_LinearOpDefaultBase.hpp"
+#include "Thyra_PreconditionerBase.hpp"
+#include "Thyra_ProductVectorSpaceBase.hpp"
+#include <vector>
+
+namespace pike {
+
+  //! Block preconditioner types built by the CompositeModelEvaluator.
+  enum EBlockPreconditionerType {
+    BLOCK_JACOBI,
+    BLOCK_GAUSS_SEIDEL
+  };
+
+  /** \brief Block preconditioner for a blocked system assembled from
+      preconditioners of the diagonal blocks.
+
+      Given diagonal block preconditioners P_i ~ inv(A_ii) and
+      optional off-diagonal coupling operators A_ij, this operator
+      applies:
+
+      - BLOCK_JACOBI: y_i = P_i x_i
+      - BLOCK_GAUSS_SEIDEL: y_i = P_i (x_i - sum_{j<i} A_ij y_j)
+
+      The coupling operators are only applied through
+      Thyra::apply(), so they can be matrix-free.  Block Gauss-Seidel
+      without any coupling operators is equivalent to Block Jacobi.
+
+      The diagonal preconditioners are stored as
+      Thyra::PreconditionerBase objects so that they can be
+      (re)computed in place by the sub-models.  The linear operator
+      used for block i is the unspecified preconditioner operator if
+      set, otherwise the right and then the left preconditioner
+      operator.
+
+      Only the non-transposed operator is supported.
+   */
+  template<typename Scalar>
+  class BlockPreconditionerOp : public Thyra::LinearOpDefaultBase<Scalar> {
+
+  public:
+
+    /** \brief Ctor.
+
+	\param[in] range Product space of the preconditioner range (the composite x space).
+	\param[in] domain Product space of the preconditioner domain (the composite f space).
+	\param[in] subPreconditioners Preconditioner of each diagonal block.
+	\param[in] type Block Jacobi or Block Gauss-Seidel.
+	\param[in] couplingOperators Optional (may be empty or contain nulls) operators A_ij mapping block j of the range to block i of the domain.
+    */
+    BlockPreconditionerOp(const Teuchos::RCP<const Thyra::ProductVectorSpaceBase<Scalar> >& range,
+			  const Teuchos::RCP<const Thyra::ProductVectorSpaceBase<Scalar> >& domain,
+			  const std::vector<Teuchos::RCP<Thyra::PreconditionerBase<Scalar> > >& subPreconditioners,
+			  const pike::EBlockPreconditionerType type,
+			  const std::vector<std::vector<Teuchos::RCP<const Thyra::LinearOpBase<Scalar> > > >& couplingOperators);
+
+    pike::EBlockPreconditionerType getBlockPreconditionerType() const;
+
+    int getNumberOfBlocks() const;
+
+    Teuchos::RCP<Thyra::PreconditionerBase<Scalar> > getNonconstSubPreconditioner(const int i);
+
+    Teuchos::RCP<const Thyra::PreconditionerBase<Scalar> > getSubPreconditioner(const int i) const;
+
+    //! Replace the coupling operator A_ij (may be null to remove the coupling).
+    void setCouplingOperator(const int i, const int j,
+			     const Teuchos::RCP<const Thyra::LinearOpBase<Scalar> >& A_ij);
+
+    //! Returns the coupling operator A_ij (null if the blocks are not coupled).
+    Teuchos::RCP<const Thyra::LinearOpBase<Scalar> > getCouplingOperator(const int i, const int j) const;
+
+    // From Thyra::LinearOpBase
+    Teuchos::RCP<const Thyra::VectorSpaceBase<Scalar> > range() const;
+    Teuchos::RCP<const Thyra::VectorSpaceBase<Scalar> > domain() const;
+
+  protected:
+
+    bool opSupportedImpl(Thyra::EOpTransp M_trans) const;
+
+    void applyImpl(const Thyra::EOpTransp M_trans,
+		   const Thyra::MultiVectorBase<Scalar>& X,
+		   const Teuchos::Ptr<Thyra::MultiVectorBase<Scalar> >& Y,
+		   const Scalar alpha,
+		   const Scalar beta) const;
+
+  private:
+
+    //! Returns the linear operator of the diagonal block preconditioner i.
+    Teuchos::RCP<const Thyra::LinearOpBase<Scalar> > getSubPreconditionerOp(const int i) const;
+
+    Teuchos::RCP<const Thyra::ProductVectorSpaceBase<Scalar> > range_;
+    Teuchos::RCP<const Thyra::ProductVectorSpaceBase<Scalar> > domain_;
+    std::vector<Teuchos::RCP<Thyra::PreconditionerBase<Scalar> > > subPreconditioners_;
+    pike::EBlockPreconditionerType type_;
+    std::vector<std::vector<Teuchos::RCP<const Thyra::LinearOpBase<Scalar> > > > couplingOperators_;
+  };
+
+}
+
+#ifndef HAVE_PIKE_EXPLICIT_INSTANTIATION
+#include "Pike_LinearOp_BlockPreconditioner_def.hpp"
+#endif
+
+#endif
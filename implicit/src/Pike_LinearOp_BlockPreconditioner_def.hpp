@@ -0,0 +1,190 @@
+#ifndef PIKE_LINEAR_OP_BLOCK_PRECONDITIONER_DEF_HPP
+#define PIKE_LINEAR_OP_BLOCK_PRECONDITIONER_DEF_HPP
+
+#include "Pike_LinearOp_BlockPreconditioner.hpp"
+#include "Thyra_ProductMultiVectorBase.hpp"
+#include "Thyra_MultiVectorStdOps.hpp"
+#include "Thyra_LinearOpBase.hpp"
+#include "Teuchos_Assert.hpp"
+#include "Teuchos_dyn_cast.hpp"
+
+namespace pike {
+
+  template<typename Scalar>
+  BlockPreconditionerOp<Scalar>::
+  BlockPreconditionerOp(const Teuchos::RCP<const Thyra::ProductVectorSpaceBase<Scalar> >& range,
+			const Teuchos::RCP<const Thyra::ProductVectorSpaceBase<Scalar> >& domain,
+			const std::vector<Teuchos::RCP<Thyra::PreconditionerBase<Scalar> > >& subPreconditioners,
+			const pike::EBlockPreconditionerType type,
+			const std::vector<std::vector<Teuchos::RCP<const Thyra::LinearOpBase<Scalar> > > >& couplingOperators) :
+    range_(range),
+    domain_(domain),
+    subPreconditioners_(subPreconditioners),
+    type_(type),
+    couplingOperators_(couplingOperators)
+  {
+    const int numBlocks = static_cast<int>(subPreconditioners_.size());
+
+    TEUCHOS_TEST_FOR_EXCEPTION( (range_->numBlocks() != numBlocks) || (domain_->numBlocks() != numBlocks),
+				std::logic_error,
+				"Error: pike::BlockPreconditionerOp - the number of sub-preconditioners ("
+				<< numBlocks << ") does not match the number of range (" << range_->numBlocks()
+				<< ") and domain (" << domain_->numBlocks() << ") blocks!");
+
+    for (int i = 0; i < numBlocks; ++i)
+      TEUCHOS_TEST_FOR_EXCEPTION(Teuchos::is_null(subPreconditioners_[i]), std::logic_error,
+				 "Error: pike::BlockPreconditionerOp - the sub-preconditioner " << i << " is null!");
+
+    // Empty coupling means no coupling
+    couplingOperators_.resize(numBlocks);
+    for (int i = 0; i < numBlocks; ++i)
+      couplingOperators_[i].resize(numBlocks);
+  }
+
+  template<typename Scalar>
+  pike::EBlockPreconditionerType BlockPreconditionerOp<Scalar>::getBlockPreconditionerType() const
+  {
+    return type_;
+  }
+
+  template<typename Scalar>
+  int BlockPreconditionerOp<Scalar>::getNumberOfBlocks() const
+  {
+    return static_cast<int>(subPreconditioners_.size());
+  }
+
+  template<typename Scalar>
+  Teuchos::RCP<Thyra::PreconditionerBase<Scalar> >
+  BlockPreconditionerOp<Scalar>::getNonconstSubPreconditioner(const int i)
+  {
+    TEUCHOS_ASSERT( (i >= 0) && (i < this->getNumberOfBlocks()) );
+    return subPreconditioners_[i];
+  }
+
+  template<typename Scalar>
+  Teuchos::RCP<const Thyra::PreconditionerBase<Scalar> >
+  BlockPreconditionerOp<Scalar>::getSubPreconditioner(const int i) const
+  {
+    TEUCHOS_ASSERT( (i >= 0) && (i < this->getNumberOfBlocks()) );
+    return subPreconditioners_[i];
+  }
+
+  template<typename Scalar>
+  void BlockPreconditionerOp<Scalar>::
+  setCouplingOperator(const int i, const int j,
+		      const Teuchos::RCP<const Thyra::LinearOpBase<Scalar> >& A_ij)
+  {
+    TEUCHOS_ASSERT( (i >= 0) && (i < this->getNumberOfBlocks()) );
+    TEUCHOS_ASSERT( (j >= 0) && (j < this->getNumberOfBlocks()) );
+    couplingOperators_[i][j] = A_ij;
+  }
+
+  template<typename Scalar>
+  Teuchos::RCP<const Thyra::LinearOpBase<Scalar> >
+  BlockPreconditionerOp<Scalar>::getCouplingOperator(const int i, const int j) const
+  {
+    TEUCHOS_ASSERT( (i >= 0) && (i < this->getNumberOfBlocks()) );
+    TEUCHOS_ASSERT( (j >= 0) && (j < this->getNumberOfBlocks()) );
+    return couplingOperators_[i][j];
+  }
+
+  template<typename Scalar>
+  Teuchos::RCP<const Thyra::VectorSpaceBase<Scalar> >
+  BlockPreconditionerOp<Scalar>::range() const
+  {
+    return range_;
+  }
+
+  template<typename Scalar>
+  Teuchos::RCP<const Thyra::VectorSpaceBase<Scalar> >
+  BlockPreconditionerOp<Scalar>::domain() const
+  {
+    return domain_;
+  }
+
+  template<typename Scalar>
+  bool BlockPreconditionerOp<Scalar>::opSupportedImpl(Thyra::EOpTransp M_trans) const
+  {
+    return (M_trans == Thyra::NOTRANS);
+  }
+
+  template<typename Scalar>
+  void BlockPreconditionerOp<Scalar>::
+  applyImpl(const Thyra::EOpTransp M_trans,
+	    const Thyra::MultiVectorBase<Scalar>& X_in,
+	    const Teuchos::Ptr<Thyra::MultiVectorBase<Scalar> >& Y_inout,
+	    const Scalar alpha,
+	    const Scalar beta) const
+  {
+    using Teuchos::RCP;
+    typedef Teuchos::ScalarTraits<Scalar> ST;
+
+    TEUCHOS_TEST_FOR_EXCEPTION(M_trans != Thyra::NOTRANS, std::logic_error,
+			       "Error: pike::BlockPreconditionerOp only supports Thyra::NOTRANS!");
+
+    const Thyra::ProductMultiVectorBase<Scalar>& X =
+      Teuchos::dyn_cast<const Thyra::ProductMultiVectorBase<Scalar> >(X_in);
+    Thyra::ProductMultiVectorBase<Scalar>& Y =
+      Teuchos::dyn_cast<Thyra::ProductMultiVectorBase<Scalar> >(*Y_inout);
+
+    if (type_ == pike::BLOCK_JACOBI) {
+      for (int i = 0; i < this->getNumberOfBlocks(); ++i)
+	Thyra::apply(*this->getSubPreconditionerOp(i), Thyra::NOTRANS, *X.getMultiVectorBlock(i),
+		     Y.getNonconstMultiVectorBlock(i).ptr(), alpha, beta);
+      return;
+    }
+
+    // Block Gauss-Seidel forward sweep.  The unscaled block solutions
+    // Z_j = P_j R_j are kept for the coupling terms of the following
+    // blocks since Y_j also contains beta * Y_j.
+    const int numColumns = X_in.domain()->dim();
+    std::vector<RCP<Thyra::MultiVectorBase<Scalar> > > Z(this->getNumberOfBlocks());
+
+    for (int i = 0; i < this->getNumberOfBlocks(); ++i) {
+
+      RCP<const Thyra::MultiVectorBase<Scalar> > R_i = X.getMultiVectorBlock(i);
+      RCP<Thyra::MultiVectorBase<Scalar> > R_i_coupled;
+      for (int j = 0; j < i; ++j) {
+	if (nonnull(couplingOperators_[i][j])) {
+	  if (is_null(R_i_coupled)) {
+	    R_i_coupled = Thyra::createMembers(domain_->getBlock(i), numColumns);
+	    Thyra::assign(R_i_coupled.ptr(), *R_i);
+	  }
+	  Thyra::apply(*couplingOperators_[i][j], Thyra::NOTRANS, *Z[j], R_i_coupled.ptr(), -ST::one(), ST::one());
+	}
+      }
+      if (nonnull(R_i_coupled))
+	R_i = R_i_coupled;
+
+      Z[i] = Thyra::createMembers(range_->getBlock(i), numColumns);
+      Thyra::apply(*this->getSubPreconditionerOp(i), Thyra::NOTRANS, *R_i, Z[i].ptr());
+
+      // Y_i = alpha * Z_i + beta * Y_i
+      const RCP<Thyra::MultiVectorBase<Scalar> > Y_i = Y.getNonconstMultiVectorBlock(i);
+      if (beta == ST::zero())
+	Thyra::assign(Y_i.ptr(), ST::zero());
+      else
+	Thyra::scale(beta, Y_i.ptr());
+      Thyra::update(alpha, *Z[i], Y_i.ptr());
+    }
+  }
+
+  template<typename Scalar>
+  Teuchos::RCP<const Thyra::LinearOpBase<Scalar> >
+  BlockPreconditionerOp<Scalar>::getSubPreconditionerOp(const int i) const
+  {
+    const Teuchos::RCP<const Thyra::PreconditionerBase<Scalar> > P = subPreconditioners_[i];
+    Teuchos::RCP<const Thyra::LinearOpBase<Scalar> > op = P->getUnspecifiedPrecOp();
+    if (is_null(op))
+      op = P->getRightPrecOp();
+    if (is_null(op))
+      op = P->getLeftPrecOp();
+    TEUCHOS_TEST_FOR_EXCEPTION(is_null(op), std::logic_error,
+			       "Error: pike::BlockPreconditionerOp - the sub-preconditioner " << i
+			       << " has not been initialized!");
+    return op;
+  }
+
+}
+
+#endif
@@ -0,0 +1,17 @@
+#include "Pike_BlackBox_config.hpp"
+
+#ifdef HAVE_PIKE_EXPLICIT_INSTANTIATION
+
+#include "Pike_ModelEvaluator_Composite.hpp"
+#include "Pike_ModelEvaluator_Composite_def.hpp"
+
+namespace pike {
+
+  template class CompositeModelEvaluator<double>;
+
+  template Teuchos::RCP<pike::CompositeModelEvaluator<double> >
+  compositeModelEvaluator<double>(const Teuchos::ArrayView<const Teuchos::RCP<const Thyra::ModelEvaluator<double> > >& me);
+
+}
+
+#endif
@@ -1,17 +1,54 @@
 #ifndef PIKE_MODEL_EVALUATOR_COMPOSITE_HPP
 #define PIKE_MODEL_EVALUATOR_COMPOSITE_HPP
 
+#include "Pike_BlackBox_config.hpp"
+#include "Pike_LinearOp_BlockPreconditioner.hpp"
 #include "Thyra_StateFuncModelEvaluatorBase.hpp"
 #include "Thyra_DefaultProductVectorSpace.hpp"
 #include "Thyra_DefaultProductVector.hpp"
+#include "Teuchos_Array.hpp"
+#include <vector>
+#include <utility>
 
 namespace pike {
-  
+
   /** \brief Forms a Product or Composite ModelEvaluator from multiple model evaluators.
 
-   */ 
+      The state x and residual f of the composite are product vectors
+      with one block per registered model.  The parameters and
+      responses of all models are concatenated: parameter l of the
+      composite is parameter p_map_[l].second of model
+      p_map_[l].first (and similarly for responses using g_map_).
+
+      Models are coupled by feeding the state of one model to a
+      parameter of another with setCouplingParameter().  Such a
+      parameter is set to the corresponding block of the composite x
+      in evalModel() and is not a parameter of the composite.
+
+      W_op is a DefaultBlockedLinearOp whose diagonal blocks are the
+      W_op of the sub-models.  The off-diagonal block (i,j) is the
+      coupling operator registered with setCouplingOperator() if
+      any, otherwise DfDp of the coupling parameter of model i fed by
+      model j if model i supports it as a linear operator.  Coupling
+      that is not registered in either way is missing from W_op.  A
+      LinearOpWithSolveFactory that can handle blocked operators must
+      be set with setLinearOpWithSolveFactory() to use create_W().
+
+      If all sub-models support W_prec, create_W_prec() returns a
+      block Jacobi or block Gauss-Seidel preconditioner (see
+      pike::BlockPreconditionerOp) assembled from the create_W_prec()
+      of each sub-model.  The sub-model preconditioners are computed
+      by the sub-models in evalModel().  The Gauss-Seidel sweep
+      applies the off-diagonal blocks of W_op matrix-free.  The DfDp
+      blocks are evaluated in evalModel() into the block of W_op if
+      W_op is requested too, which the preconditioner then shares,
+      and otherwise into operators owned by the preconditioner.
+
+      The sub-models are evaluated one after the other in
+      evalModel().
+   */
   template<typename Scalar>
-  class CompositeModelEvaluator : Thyra::StateFuncModelEvaluatorBase<Scalar> {
+  class CompositeModelEvaluator : public Thyra::StateFuncModelEvaluatorBase<Scalar> {
 
   public:
 
@@ -20,41 +57,117 @@ namespace pike {
     //! Register the model evaluators and build the product objects.
     void setModels(const Teuchos::ArrayView<const Teuchos::RCP<const Thyra::ModelEvaluator<Scalar> > >& me);
 
+    //! Set the solver factory used by create_W() and returned by get_W_factory().
+    void setLinearOpWithSolveFactory(const Teuchos::RCP<const Thyra::LinearOpWithSolveFactoryBase<Scalar> >& W_factory);
+
+    //! Set the block preconditioner built by create_W_prec().  Defaults to pike::BLOCK_JACOBI.
+    void setBlockPreconditionerType(const pike::EBlockPreconditionerType type);
+
+    pike::EBlockPreconditionerType getBlockPreconditionerType() const;
+
+    /** \brief Register the coupling operator A_ij = df_i/dx_j.
+
+	The operator is the (i,j) block of W_op and is used in the
+	block Gauss-Seidel preconditioner.  Must be called after
+	setModels() and before create_W_op() and create_W_prec().  The
+	operator is only applied, so it can be matrix-free and may be
+	updated by the caller between evaluations.
+    */
+    void setCouplingOperator(const int i, const int j,
+			     const Teuchos::RCP<const Thyra::LinearOpBase<Scalar> >& A_ij);
+
+    /** \brief Feed the state x_j of model j to the parameter l of model i.
+
+	The parameter space of model i must be compatible with the
+	state space of model j and each model can be fed by a given
+	model through one parameter only.  The parameter is removed
+	from the composite parameters, so this changes Np() and the
+	parameter map.  Must be called after setModels().
+    */
+    void setCouplingParameter(const int i, const int l, const int j);
+
+    //! Returns the model whose state is fed to parameter l of model i or -1 if the parameter is not a coupling parameter.
+    int getCoupledModel(const int i, const int l) const;
+
+    int getNumberOfModels() const;
+
+    Teuchos::RCP<const Thyra::ModelEvaluator<Scalar> > getModel(const int i) const;
+
+    //! Returns the (model index, model parameter index) of composite parameter l.
+    std::pair<int,int> getParameterMap(const int l) const;
+
+    //! Returns the (model index, model response index) of composite response j.
+    std::pair<int,int> getResponseMap(const int j) const;
+
     // From Thyra::ModelEvaluator
-    int Np() const;
-    int Ng() const;
-    Teuchos::RCP<const Thyra::VectorSpaceBase<Scalar> > get_x_space() const;    
+    Teuchos::RCP<const Thyra::VectorSpaceBase<Scalar> > get_x_space() const;
     Teuchos::RCP<const Thyra::VectorSpaceBase<Scalar> > get_f_space() const;
     Teuchos::RCP<const Thyra::VectorSpaceBase<Scalar> > get_p_space(int l) const;
     Teuchos::RCP<const Teuchos::Array<std::string> > get_p_names(int l) const;
     Teuchos::RCP<const Thyra::VectorSpaceBase<Scalar> > get_g_space(int j) const;
     Thyra::ModelEvaluatorBase::InArgs<Scalar> getNominalValues() const;
-    Teuchos::RCP<Thyra::LinearOpWithSolveBase<Scalar> > create_W() const;
     Teuchos::RCP<Thyra::LinearOpBase<Scalar> > create_W_op() const;
     Teuchos::RCP<Thyra::PreconditionerBase<Scalar> > create_W_prec() const;
     Teuchos::RCP<const Thyra::LinearOpWithSolveFactoryBase<Scalar> > get_W_factory() const;
     Thyra::ModelEvaluatorBase::InArgs<Scalar> createInArgs() const;
-    Thyra::ModelEvaluatorBase::OutArgs<Scalar> createOutArgs() const;
-    void evalModel(const Thyra::ModelEvaluatorBase::InArgs<Scalar> &inArgs,
-		   const Thyra::ModelEvaluatorBase::OutArgs<Scalar> &outArgs) const;
 
   private:
-    std::vector<const Teuchos::RCP<const Thyra::ModelEvaluator<Scalar> > > models_;
 
-    Teuchos::RCP<Thyra::DefaultProductVectorSpace<Scalar> > x_space_;
-    Teuchos::RCP<Thyra::DefaultProductVectorSpace<Scalar> > f_space_;
-    std::vector<Teuchos::RCP<Thyra::VectorSpace<Scalar> > > p_spaces_;
-    std::vector<Teuchos::RCP<Thyra::VectorSpace<Scalar> > > g_spaces_;
+    Thyra::ModelEvaluatorBase::OutArgs<Scalar> createOutArgsImpl() const;
+
+    void evalModelImpl(const Thyra::ModelEvaluatorBase::InArgs<Scalar> &inArgs,
+		       const Thyra::ModelEvaluatorBase::OutArgs<Scalar> &outArgs) const;
+
+    //! Rebuilds the composite parameters from the model parameters that are not coupling parameters.
+    void buildParameterMap();
+
+    //! Returns the parameter of model i fed by model j or -1 if there is none.
+    int getCouplingParameter(const int i, const int j) const;
+
+    //! Returns true if the (i,j) block of W_op is DfDp of a coupling parameter evaluated by model i.
+    bool isDfDpBlock(const int i, const int j) const;
+
+    //! Returns true if all sub-models support the in arg.
+    bool allModelsSupport(const Thyra::ModelEvaluatorBase::EInArgsMembers arg) const;
+
+    //! Returns true if all sub-models support the out arg.
+    bool allModelsSupport(const Thyra::ModelEvaluatorBase::EOutArgsMembers arg) const;
+
+    std::vector<Teuchos::RCP<const Thyra::ModelEvaluator<Scalar> > > models_;
+
+    Teuchos::RCP<const Thyra::DefaultProductVectorSpace<Scalar> > x_space_;
+    Teuchos::RCP<const Thyra::DefaultProductVectorSpace<Scalar> > f_space_;
+    std::vector<Teuchos::RCP<const Thyra::VectorSpaceBase<Scalar> > > p_spaces_;
+    std::vector<Teuchos::RCP<const Thyra::VectorSpaceBase<Scalar> > > g_spaces_;
 
     //! Maps a model parameter to a submodel evaluator and index for that me.
     std::vector<std::pair<int,int> > p_map_;
+    //! Maps a model response to a submodel evaluator and index for that me.
     std::vector<std::pair<int,int> > g_map_;
-    
+
     int Np_;
     int Ng_;
 
+    Teuchos::RCP<const Thyra::LinearOpWithSolveFactoryBase<Scalar> > W_factory_;
+
+    pike::EBlockPreconditionerType preconditionerType_;
+    //! Off-diagonal coupling operators of W_op and the block Gauss-Seidel preconditioner.
+    std::vector<std::vector<Teuchos::RCP<const Thyra::LinearOpBase<Scalar> > > > couplingOperators_;
+    //! For each model and model parameter, the model whose state is fed to the parameter or -1.
+    std::vector<std::vector<int> > coupledModels_;
   };
 
+  /** \brief Non-member ctor
+      \relates CompositeModelEvaluator
+  */
+  template<typename Scalar>
+  Teuchos::RCP<pike::CompositeModelEvaluator<Scalar> >
+  compositeModelEvaluator(const Teuchos::ArrayView<const Teuchos::RCP<const Thyra::ModelEvaluator<Scalar> > >& me);
+
 }
 
+#ifndef HAVE_PIKE_EXPLICIT_INSTANTIATION
+#include "Pike_ModelEvaluator_Composite_def.hpp"
+#endif
+
 #endif
@@ -1,75 +1,473 @@
+#ifndef PIKE_MODEL_EVALUATOR_COMPOSITE_DEF_HPP
+#define PIKE_MODEL_EVALUATOR_COMPOSITE_DEF_HPP
+
 #include "Pike_ModelEvaluator_Composite.hpp"
 #include "Thyra_DefaultProductVectorSpace.hpp"
 #include "Thyra_DefaultProductVector.hpp"
+#include "Thyra_DefaultBlockedLinearOp.hpp"
+#include "Thyra_DefaultPreconditioner.hpp"
+#include "Thyra_VectorStdOps.hpp"
+#include "Teuchos_Assert.hpp"
 
 namespace pike {
 
   template<typename Scalar>
-  CompositeModelEvaluator::CompositeModelEvaluator()
-  {
-    
-  }
+  CompositeModelEvaluator<Scalar>::CompositeModelEvaluator() :
+    Np_(0),
+    Ng_(0),
+    preconditionerType_(pike::BLOCK_JACOBI)
+  { }
 
   template<typename Scalar>
-  void CompositeModelEvaluator::
+  void CompositeModelEvaluator<Scalar>::
   setModels(const Teuchos::ArrayView<const Teuchos::RCP<const Thyra::ModelEvaluator<Scalar> > >& me)
   {
-    models_ = me;
+    TEUCHOS_TEST_FOR_EXCEPTION(me.size() == 0, std::logic_error,
+			       "Error: pike::CompositeModelEvaluator::setModels() - at least one model must be registered!");
 
-    std::vector<Teuchos::RCP<Thyra::VectorSpace<Scalar> > > x_spaces;
-    std::vector<Teuchos::RCP<Thyra::VectorSpace<Scalar> > > f_spaces;
+    models_.clear();
+    g_spaces_.clear();
+    g_map_.clear();
+    coupledModels_.clear();
+
+    Teuchos::Array<Teuchos::RCP<const Thyra::VectorSpaceBase<Scalar> > > x_spaces;
+    Teuchos::Array<Teuchos::RCP<const Thyra::VectorSpaceBase<Scalar> > > f_spaces;
 
     for (int model = 0; model < me.size(); ++model) {
 
-      x_spaces.push_back(me->get_x_space());
-      f_spaces.push_back(me->get_f_space());
+      TEUCHOS_TEST_FOR_EXCEPTION(Teuchos::is_null(me[model]), std::logic_error,
+				 "Error: pike::CompositeModelEvaluator::setModels() - model " << model << " is null!");
+
+      models_.push_back(me[model]);
+      x_spaces.push_back(me[model]->get_x_space());
+      f_spaces.push_back(me[model]->get_f_space());
 
+      coupledModels_.push_back(std::vector<int>(me[model]->Np(),-1));
+
+      for (int j = 0; j < me[model]->Ng(); ++j) {
+	g_map_.push_back(std::make_pair(model,j));
+	g_spaces_.push_back(me[model]->get_g_space(j));
+      }
     }
 
-    x_space_ = Teuchos::rcp(new Thyra::DefaultProductVectorSpace<Scalar>(x_spaces));
-    f_space_ = Teuchos::rcp(new Thyra::DefaultProductVectorSpace<Scalar>(f_spaces));
+    x_space_ = Thyra::productVectorSpace<Scalar>(x_spaces());
+    f_space_ = Thyra::productVectorSpace<Scalar>(f_spaces());
+
+    this->buildParameterMap();
+    Ng_ = static_cast<int>(g_map_.size());
+
+    couplingOperators_.clear();
+    couplingOperators_.resize(models_.size());
+    for (std::size_t i = 0; i < models_.size(); ++i)
+      couplingOperators_[i].resize(models_.size());
+  }
+
+  template<typename Scalar>
+  void CompositeModelEvaluator<Scalar>::
+  setLinearOpWithSolveFactory(const Teuchos::RCP<const Thyra::LinearOpWithSolveFactoryBase<Scalar> >& W_factory)
+  {
+    W_factory_ = W_factory;
+  }
+
+  template<typename Scalar>
+  void CompositeModelEvaluator<Scalar>::
+  setBlockPreconditionerType(const pike::EBlockPreconditionerType type)
+  {
+    preconditionerType_ = type;
+  }
+
+  template<typename Scalar>
+  pike::EBlockPreconditionerType CompositeModelEvaluator<Scalar>::getBlockPreconditionerType() const
+  {
+    return preconditionerType_;
   }
 
-    // From Thyra::ModelEvaluator
   template<typename Scalar>
-  int CompositeModelEvaluator::Np() const
+  void CompositeModelEvaluator<Scalar>::
+  setCouplingOperator(const int i, const int j,
+		      const Teuchos::RCP<const Thyra::LinearOpBase<Scalar> >& A_ij)
   {
-    TEUCHOS_TEST_FOR_EXCEPTION(true,std::logic_error,"Np() not implemented yet!");
-    return 0;
+    TEUCHOS_TEST_FOR_EXCEPTION( (i < 0) || (i >= this->getNumberOfModels()) ||
+				(j < 0) || (j >= this->getNumberOfModels()) || (i == j),
+				std::logic_error,
+				"Error: pike::CompositeModelEvaluator::setCouplingOperator() - the block (" << i << "," << j
+				<< ") is not an off-diagonal block of the " << this->getNumberOfModels() << " models!");
+    couplingOperators_[i][j] = A_ij;
   }
-  
-  int CompositeModelEvaluator::Ng() const
+
+  template<typename Scalar>
+  void CompositeModelEvaluator<Scalar>::
+  setCouplingParameter(const int i, const int l, const int j)
+  {
+    TEUCHOS_TEST_FOR_EXCEPTION( (i < 0) || (i >= this->getNumberOfModels()) ||
+				(j < 0) || (j >= this->getNumberOfModels()) || (i == j),
+				std::logic_error,
+				"Error: pike::CompositeModelEvaluator::setCouplingParameter() - the block (" << i << "," << j
+				<< ") is not an off-diagonal block of the " << this->getNumberOfModels() << " models!");
+    TEUCHOS_TEST_FOR_EXCEPTION( (l < 0) || (l >= models_[i]->Np()), std::logic_error,
+				"Error: pike::CompositeModelEvaluator::setCouplingParameter() - the parameter index " << l
+				<< " is out of range [0," << models_[i]->Np() << ") for model " << i << "!");
+    TEUCHOS_TEST_FOR_EXCEPTION( (this->getCouplingParameter(i,j) >= 0) && (this->getCouplingParameter(i,j) != l),
+				std::logic_error,
+				"Error: pike::CompositeModelEvaluator::setCouplingParameter() - model " << i
+				<< " is already fed by model " << j << " through parameter " << this->getCouplingParameter(i,j) << "!");
+    TEUCHOS_TEST_FOR_EXCEPTION(!models_[i]->get_p_space(l)->isCompatible(*models_[j]->get_x_space()),
+				std::logic_error,
+				"Error: pike::CompositeModelEvaluator::setCouplingParameter() - the space of parameter " << l
+				<< " of model " << i << " is not compatible with the state space of model " << j << "!");
+    coupledModels_[i][l] = j;
+    this->buildParameterMap();
+  }
+
+  template<typename Scalar>
+  int CompositeModelEvaluator<Scalar>::getCoupledModel(const int i, const int l) const
+  {
+    TEUCHOS_TEST_FOR_EXCEPTION( (i < 0) || (i >= this->getNumberOfModels()), std::logic_error,
+				"Error: pike::CompositeModelEvaluator::getCoupledModel() - the model index " << i
+				<< " is out of range [0," << this->getNumberOfModels() << ")!");
+    TEUCHOS_TEST_FOR_EXCEPTION( (l < 0) || (l >= static_cast<int>(coupledModels_[i].size())), std::logic_error,
+				"Error: pike::CompositeModelEvaluator::getCoupledModel() - the parameter index " << l
+				<< " is out of range [0," << coupledModels_[i].size() << ") for model " << i << "!");
+    return coupledModels_[i][l];
+  }
+
+  template<typename Scalar>
+  int CompositeModelEvaluator<Scalar>::getNumberOfModels() const
+  {
+    return static_cast<int>(models_.size());
+  }
+
+  template<typename Scalar>
+  Teuchos::RCP<const Thyra::ModelEvaluator<Scalar> >
+  CompositeModelEvaluator<Scalar>::getModel(const int i) const
   {
-    TEUCHOS_TEST_FOR_EXCEPTION(true,std::logic_error,"Ng() not implemented yet!");
-    return 0;
+    TEUCHOS_TEST_FOR_EXCEPTION( (i < 0) || (i >= this->getNumberOfModels()), std::logic_error,
+				"Error: pike::CompositeModelEvaluator::getModel() - the model index " << i
+				<< " is out of range [0," << this->getNumberOfModels() << ")!");
+    return models_[i];
   }
 
-    RCP<const VectorSpaceBase<Scalar> > get_x_space() const
-    {
-      return x_space_;
+  template<typename Scalar>
+  std::pair<int,int> CompositeModelEvaluator<Scalar>::getParameterMap(const int l) const
+  {
+    TEUCHOS_TEST_FOR_EXCEPTION( (l < 0) || (l >= Np_), std::logic_error,
+				"Error: pike::CompositeModelEvaluator::getParameterMap() - the parameter index " << l
+				<< " is out of range [0," << Np_ << ")!");
+    return p_map_[l];
+  }
+
+  template<typename Scalar>
+  std::pair<int,int> CompositeModelEvaluator<Scalar>::getResponseMap(const int j) const
+  {
+    TEUCHOS_TEST_FOR_EXCEPTION( (j < 0) || (j >= Ng_), std::logic_error,
+				"Error: pike::CompositeModelEvaluator::getResponseMap() - the response index " << j
+				<< " is out of range [0," << Ng_ << ")!");
+    return g_map_[j];
+  }
+
+  // From Thyra::ModelEvaluator
+  template<typename Scalar>
+  Teuchos::RCP<const Thyra::VectorSpaceBase<Scalar> >
+  CompositeModelEvaluator<Scalar>::get_x_space() const
+  {
+    return x_space_;
+  }
+
+  template<typename Scalar>
+  Teuchos::RCP<const Thyra::VectorSpaceBase<Scalar> >
+  CompositeModelEvaluator<Scalar>::get_f_space() const
+  {
+    return f_space_;
+  }
+
+  template<typename Scalar>
+  Teuchos::RCP<const Thyra::VectorSpaceBase<Scalar> >
+  CompositeModelEvaluator<Scalar>::get_p_space(int l) const
+  {
+    TEUCHOS_ASSERT( (l >= 0) && (l < Np_) );
+    return p_spaces_[l];
+  }
+
+  template<typename Scalar>
+  Teuchos::RCP<const Teuchos::Array<std::string> >
+  CompositeModelEvaluator<Scalar>::get_p_names(int l) const
+  {
+    TEUCHOS_ASSERT( (l >= 0) && (l < Np_) );
+    return models_[p_map_[l].first]->get_p_names(p_map_[l].second);
+  }
+
+  template<typename Scalar>
+  Teuchos::RCP<const Thyra::VectorSpaceBase<Scalar> >
+  CompositeModelEvaluator<Scalar>::get_g_space(int j) const
+  {
+    TEUCHOS_ASSERT( (j >= 0) && (j < Ng_) );
+    return g_spaces_[j];
+  }
+
+  template<typename Scalar>
+  Thyra::ModelEvaluatorBase::InArgs<Scalar>
+  CompositeModelEvaluator<Scalar>::getNominalValues() const
+  {
+    Thyra::ModelEvaluatorBase::InArgs<Scalar> nominalValues = this->createInArgs();
+
+    // Assemble the product x from the sub-model nominal values.
+    // Models without a nominal x contribute a zero block.
+    const Teuchos::RCP<Thyra::VectorBase<Scalar> > x = Thyra::createMember(*x_space_);
+    const Teuchos::RCP<Thyra::ProductVectorBase<Scalar> > x_blocks =
+      Thyra::nonconstProductVectorBase<Scalar>(x);
+    for (int model = 0; model < this->getNumberOfModels(); ++model) {
+      const Thyra::ModelEvaluatorBase::InArgs<Scalar> subNominal = models_[model]->getNominalValues();
+      if (nonnull(subNominal.get_x()))
+	Thyra::copy(*subNominal.get_x(), x_blocks->getNonconstVectorBlock(model).ptr());
+      else
+	Thyra::assign(x_blocks->getNonconstVectorBlock(model).ptr(), Teuchos::ScalarTraits<Scalar>::zero());
     }
+    nominalValues.set_x(x);
 
-    RCP<const VectorSpaceBase<Scalar> > get_f_space() const
-    {
-      return f_space_;
+    for (int l = 0; l < Np_; ++l)
+      nominalValues.set_p(l, models_[p_map_[l].first]->getNominalValues().get_p(p_map_[l].second));
+
+    return nominalValues;
+  }
+
+  template<typename Scalar>
+  Teuchos::RCP<Thyra::LinearOpBase<Scalar> >
+  CompositeModelEvaluator<Scalar>::create_W_op() const
+  {
+    TEUCHOS_TEST_FOR_EXCEPTION(!this->allModelsSupport(Thyra::ModelEvaluatorBase::OUT_ARG_W_op), std::logic_error,
+			       "Error: pike::CompositeModelEvaluator::create_W_op() - all sub-models must support W_op!");
+
+    const Teuchos::RCP<Thyra::DefaultBlockedLinearOp<Scalar> > W_op = Thyra::defaultBlockedLinearOp<Scalar>();
+    W_op->beginBlockFill(f_space_, x_space_);
+    for (int i = 0; i < this->getNumberOfModels(); ++i) {
+      W_op->setNonconstBlock(i, i, models_[i]->create_W_op());
+      for (int j = 0; j < this->getNumberOfModels(); ++j) {
+	if (nonnull(couplingOperators_[i][j]))
+	  W_op->setBlock(i, j, couplingOperators_[i][j]);
+	else if (this->isDfDpBlock(i,j))
+	  W_op->setNonconstBlock(i, j, models_[i]->create_DfDp_op(this->getCouplingParameter(i,j)));
+      }
+    }
+    W_op->endBlockFill();
+    return W_op;
+  }
+
+  template<typename Scalar>
+  Teuchos::RCP<Thyra::PreconditionerBase<Scalar> >
+  CompositeModelEvaluator<Scalar>::create_W_prec() const
+  {
+    TEUCHOS_TEST_FOR_EXCEPTION(!this->allModelsSupport(Thyra::ModelEvaluatorBase::OUT_ARG_W_prec), std::logic_error,
+			       "Error: pike::CompositeModelEvaluator::create_W_prec() - all sub-models must support W_prec!");
+
+    std::vector<Teuchos::RCP<Thyra::PreconditionerBase<Scalar> > > subPreconditioners;
+    for (int model = 0; model < this->getNumberOfModels(); ++model)
+      subPreconditioners.push_back(models_[model]->create_W_prec());
+
+    // Same off-diagonal blocks as create_W_op()
+    std::vector<std::vector<Teuchos::RCP<const Thyra::LinearOpBase<Scalar> > > > couplingOperators = couplingOperators_;
+    for (int i = 0; i < this->getNumberOfModels(); ++i)
+      for (int j = 0; j < this->getNumberOfModels(); ++j)
+	if (this->isDfDpBlock(i,j))
+	  couplingOperators[i][j] = models_[i]->create_DfDp_op(this->getCouplingParameter(i,j));
+
+    const Teuchos::RCP<pike::BlockPreconditionerOp<Scalar> > P =
+      Teuchos::rcp(new pike::BlockPreconditionerOp<Scalar>(x_space_, f_space_, subPreconditioners,
+							   preconditionerType_, couplingOperators));
+    return Thyra::nonconstUnspecifiedPrec<Scalar>(P);
+  }
+
+  template<typename Scalar>
+  Teuchos::RCP<const Thyra::LinearOpWithSolveFactoryBase<Scalar> >
+  CompositeModelEvaluator<Scalar>::get_W_factory() const
+  {
+    return W_factory_;
+  }
+
+  template<typename Scalar>
+  Thyra::ModelEvaluatorBase::InArgs<Scalar>
+  CompositeModelEvaluator<Scalar>::createInArgs() const
+  {
+    typedef Thyra::ModelEvaluatorBase MEB;
+    MEB::InArgsSetup<Scalar> inArgs;
+    inArgs.setModelEvalDescription(this->description());
+    inArgs.set_Np(Np_);
+    inArgs.setSupports(MEB::IN_ARG_x);
+
+    // Transient arguments are only supported if all models support them.
+    if (this->allModelsSupport(MEB::IN_ARG_x_dot))
+      inArgs.setSupports(MEB::IN_ARG_x_dot);
+    if (this->allModelsSupport(MEB::IN_ARG_t))
+      inArgs.setSupports(MEB::IN_ARG_t);
+    if (this->allModelsSupport(MEB::IN_ARG_alpha))
+      inArgs.setSupports(MEB::IN_ARG_alpha);
+    if (this->allModelsSupport(MEB::IN_ARG_beta))
+      inArgs.setSupports(MEB::IN_ARG_beta);
+
+    return inArgs;
+  }
+
+  template<typename Scalar>
+  Thyra::ModelEvaluatorBase::OutArgs<Scalar>
+  CompositeModelEvaluator<Scalar>::createOutArgsImpl() const
+  {
+    typedef Thyra::ModelEvaluatorBase MEB;
+    MEB::OutArgsSetup<Scalar> outArgs;
+    outArgs.setModelEvalDescription(this->description());
+    outArgs.set_Np_Ng(Np_,Ng_);
+    outArgs.setSupports(MEB::OUT_ARG_f);
+    if (this->allModelsSupport(MEB::OUT_ARG_W_op))
+      outArgs.setSupports(MEB::OUT_ARG_W_op);
+    if (this->allModelsSupport(MEB::OUT_ARG_W_prec))
+      outArgs.setSupports(MEB::OUT_ARG_W_prec);
+    return outArgs;
+  }
+
+  template<typename Scalar>
+  void CompositeModelEvaluator<Scalar>::
+  evalModelImpl(const Thyra::ModelEvaluatorBase::InArgs<Scalar> &inArgs,
+		const Thyra::ModelEvaluatorBase::OutArgs<Scalar> &outArgs) const
+  {
+    typedef Thyra::ModelEvaluatorBase MEB;
+    using Teuchos::RCP;
+
+    const RCP<const Thyra::ProductVectorBase<Scalar> > x =
+      Thyra::productVectorBase<Scalar>(inArgs.get_x());
+
+    RCP<const Thyra::ProductVectorBase<Scalar> > x_dot;
+    if (inArgs.supports(MEB::IN_ARG_x_dot) && nonnull(inArgs.get_x_dot()))
+      x_dot = Thyra::productVectorBase<Scalar>(inArgs.get_x_dot());
+
+    RCP<Thyra::ProductVectorBase<Scalar> > f;
+    if (nonnull(outArgs.get_f()))
+      f = Thyra::nonconstProductVectorBase<Scalar>(outArgs.get_f());
+
+    RCP<Thyra::PhysicallyBlockedLinearOpBase<Scalar> > W_op;
+    if (outArgs.supports(MEB::OUT_ARG_W_op) && nonnull(outArgs.get_W_op()))
+      W_op = Teuchos::rcp_dynamic_cast<Thyra::PhysicallyBlockedLinearOpBase<Scalar> >(outArgs.get_W_op(),true);
+
+    RCP<pike::BlockPreconditionerOp<Scalar> > W_prec;
+    if (outArgs.supports(MEB::OUT_ARG_W_prec) && nonnull(outArgs.get_W_prec()))
+      W_prec = Teuchos::rcp_dynamic_cast<pike::BlockPreconditionerOp<Scalar> >(outArgs.get_W_prec()->getNonconstUnspecifiedPrecOp(),true);
+
+    for (int model = 0; model < this->getNumberOfModels(); ++model) {
+
+      MEB::InArgs<Scalar> subInArgs = models_[model]->createInArgs();
+      MEB::OutArgs<Scalar> subOutArgs = models_[model]->createOutArgs();
+
+      subInArgs.set_x(x->getVectorBlock(model));
+      if (nonnull(x_dot))
+	subInArgs.set_x_dot(x_dot->getVectorBlock(model));
+      if (inArgs.supports(MEB::IN_ARG_t))
+	subInArgs.set_t(inArgs.get_t());
+      if (inArgs.supports(MEB::IN_ARG_alpha))
+	subInArgs.set_alpha(inArgs.get_alpha());
+      if (inArgs.supports(MEB::IN_ARG_beta))
+	subInArgs.set_beta(inArgs.get_beta());
+
+      if (nonnull(f))
+	subOutArgs.set_f(f->getNonconstVectorBlock(model));
+      if (nonnull(W_op))
+	subOutArgs.set_W_op(W_op->getNonconstBlock(model,model));
+      if (nonnull(W_prec))
+	subOutArgs.set_W_prec(W_prec->getNonconstSubPreconditioner(model));
+
+      for (int l = 0; l < Np_; ++l)
+	if (p_map_[l].first == model)
+	  subInArgs.set_p(p_map_[l].second, inArgs.get_p(l));
+
+      for (int l = 0; l < models_[model]->Np(); ++l) {
+	const int coupledModel = coupledModels_[model][l];
+	if (coupledModel < 0)
+	  continue;
+	subInArgs.set_p(l, x->getVectorBlock(coupledModel));
+	if (!this->isDfDpBlock(model,coupledModel))
+	  continue;
+	if (nonnull(W_op)) {
+	  subOutArgs.set_DfDp(l, MEB::Derivative<Scalar>(W_op->getNonconstBlock(model,coupledModel)));
+	  if (nonnull(W_prec))
+	    W_prec->setCouplingOperator(model, coupledModel, W_op->getBlock(model,coupledModel));
+	}
+	else if (nonnull(W_prec)) {
+	  // The preconditioner owns the operator created in create_W_prec()
+	  const RCP<Thyra::LinearOpBase<Scalar> > A_ij =
+	    Teuchos::rcp_const_cast<Thyra::LinearOpBase<Scalar> >(W_prec->getCouplingOperator(model,coupledModel));
+	  subOutArgs.set_DfDp(l, MEB::Derivative<Scalar>(A_ij));
+	}
+      }
+
+      for (int j = 0; j < Ng_; ++j)
+	if (g_map_[j].first == model)
+	  subOutArgs.set_g(g_map_[j].second, outArgs.get_g(j));
+
+      models_[model]->evalModel(subInArgs, subOutArgs);
     }
+  }
 
-    RCP<const VectorSpaceBase<Scalar> > get_p_space(int l) const
-    {
-      return p_space_;
+  template<typename Scalar>
+  void CompositeModelEvaluator<Scalar>::buildParameterMap()
+  {
+    p_spaces_.clear();
+    p_map_.clear();
+    for (int model = 0; model < this->getNumberOfModels(); ++model) {
+      for (int l = 0; l < models_[model]->Np(); ++l) {
+	if (coupledModels_[model][l] < 0) {
+	  p_map_.push_back(std::make_pair(model,l));
+	  p_spaces_.push_back(models_[model]->get_p_space(l));
+	}
+      }
     }
+    Np_ = static_cast<int>(p_map_.size());
+  }
 
-    RCP<const Teuchos::Array<std::string> > get_p_names(int l) const;
-    RCP<const VectorSpaceBase<Scalar> > get_g_space(int j) const;
-    ModelEvaluatorBase::InArgs<Scalar> getNominalValues() const;
-    RCP<LinearOpWithSolveBase<Scalar> > create_W() const;
-    RCP<LinearOpBase<Scalar> > create_W_op() const;
-    RCP<PreconditionerBase<Scalar> > create_W_prec() const;
-    RCP<const LinearOpWithSolveFactoryBase<Scalar> > get_W_factory() const;
-    ModelEvaluatorBase::InArgs<Scalar> createInArgs() const;
-    ModelEvaluatorBase::OutArgs<Scalar> createOutArgs() const;
-    void evalModel(const ModelEvaluatorBase::InArgs<Scalar> &inArgs,
-		   const ModelEvaluatorBase::OutArgs<Scalar> &outArgs) const;
+  template<typename Scalar>
+  int CompositeModelEvaluator<Scalar>::getCouplingParameter(const int i, const int j) const
+  {
+    for (std::size_t l = 0; l < coupledModels_[i].size(); ++l)
+      if (coupledModels_[i][l] == j)
+	return static_cast<int>(l);
+    return -1;
+  }
+
+  template<typename Scalar>
+  bool CompositeModelEvaluator<Scalar>::isDfDpBlock(const int i, const int j) const
+  {
+    typedef Thyra::ModelEvaluatorBase MEB;
+    const int l = this->getCouplingParameter(i,j);
+    if ( (l < 0) || nonnull(couplingOperators_[i][j]) )
+      return false;
+    return models_[i]->createOutArgs().supports(MEB::OUT_ARG_DfDp,l).supports(MEB::DERIV_LINEAR_OP);
+  }
+
+  template<typename Scalar>
+  bool CompositeModelEvaluator<Scalar>::
+  allModelsSupport(const Thyra::ModelEvaluatorBase::EInArgsMembers arg) const
+  {
+    for (int model = 0; model < this->getNumberOfModels(); ++model)
+      if (!models_[model]->createInArgs().supports(arg))
+	return false;
+    return true;
+  }
+
+  template<typename Scalar>
+  bool CompositeModelEvaluator<Scalar>::
+  allModelsSupport(const Thyra::ModelEvaluatorBase::EOutArgsMembers arg) const
+  {
+    for (int model = 0; model < this->getNumberOfModels(); ++model)
+      if (!models_[model]->createOutArgs().supports(arg))
+	return false;
+    return true;
+  }
+
+  // Non-member ctor
+  template<typename Scalar>
+  Teuchos::RCP<pike::CompositeModelEvaluator<Scalar> >
+  compositeModelEvaluator(const Teuchos::ArrayView<const Teuchos::RCP<const Thyra::ModelEvaluator<Scalar> > >& me)
+  {
+    const Teuchos::RCP<pike::CompositeModelEvaluator<Scalar> > composite =
+      Teuchos::rcp(new pike::CompositeModelEvaluator<Scalar>);
+    composite->setModels(me);
+    return composite;
+  }
 
 }
 
@@ -0,0 +1,200 @@
+#include "Pike_ModelEvaluator_FixedPoint.hpp"
+#include "Pike_Solver.hpp"
+#include "Pike_BlackBoxModelEvaluator.hpp"
+#include "Pike_DataTransfer.hpp"
+#include "Thyra_DefaultSpmdVectorSpace.hpp"
+#include "Thyra_DetachedVectorView.hpp"
+#include "Thyra_VectorStdOps.hpp"
+#include "Teuchos_Assert.hpp"
+
+namespace pike {
+
+  FixedPointModelEvaluator::
+  FixedPointModelEvaluator(const Teuchos::RCP<pike::Solver>& solver,
+			   const Teuchos::RCP<const Teuchos::Comm<int> >& comm) :
+    solver_(solver),
+    comm_(comm),
+    registrationComplete_(false)
+  {
+    TEUCHOS_ASSERT(nonnull(solver_));
+    TEUCHOS_ASSERT(nonnull(comm_));
+  }
+
+  void FixedPointModelEvaluator::addCouplingParameter(const std::string& modelName,
+						      const std::string& parameterName)
+  {
+    TEUCHOS_TEST_FOR_EXCEPTION(registrationComplete_, std::logic_error,
+			       "Error: pike::FixedPointModelEvaluator::addCouplingParameter() - can not add the parameter \""
+			       << parameterName << "\" of the model \"" << modelName
+			       << "\" after completeRegistration() has been called!");
+    couplingParameterNames_.push_back(std::make_pair(modelName,parameterName));
+  }
+
+  void FixedPointModelEvaluator::completeRegistration()
+  {
+    TEUCHOS_TEST_FOR_EXCEPTION(couplingParameterNames_.size() == 0, std::logic_error,
+			       "Error: pike::FixedPointModelEvaluator::completeRegistration() - no coupling parameters were added!");
+
+    const std::vector<Teuchos::RCP<const pike::BlackBoxModelEvaluator> > models = solver_->getModelEvaluators();
+
+    couplingParameters_.clear();
+    int offset = 0;
+    for (std::size_t i = 0; i < couplingParameterNames_.size(); ++i) {
+      CouplingParameter cp;
+      cp.modelIndex = -1;
+      for (std::size_t m = 0; m < models.size(); ++m)
+	if (models[m]->name() == couplingParameterNames_[i].first)
+	  cp.modelIndex = static_cast<int>(m);
+
+      TEUCHOS_TEST_FOR_EXCEPTION(cp.modelIndex < 0, std::logic_error,
+				 "Error: pike::FixedPointModelEvaluator::completeRegistration() - the model \""
+				 << couplingParameterNames_[i].first << "\" is not registered with the solver!");
+
+      const Teuchos::RCP<const pike::BlackBoxModelEvaluator> me = models[cp.modelIndex];
+      TEUCHOS_TEST_FOR_EXCEPTION(!me->supportsParameter(couplingParameterNames_[i].second), std::logic_error,
+				 "Error: pike::FixedPointModelEvaluator::completeRegistration() - the model \""
+				 << me->name() << "\" does not support the parameter \""
+				 << couplingParameterNames_[i].second << "\"!");
+
+      cp.parameterIndex = me->getParameterIndex(couplingParameterNames_[i].second);
+      cp.size = static_cast<int>(me->getParameter(cp.parameterIndex).size());
+      cp.offset = offset;
+      offset += cp.size;
+      couplingParameters_.push_back(cp);
+    }
+
+    x_space_ = Thyra::locallyReplicatedDefaultSpmdVectorSpace<double>(comm_,offset);
+
+    // Initial guess is the current state of the coupling parameters
+    const Teuchos::RCP<Thyra::VectorBase<double> > x0 = Thyra::createMember(*x_space_);
+    {
+      Thyra::DetachedVectorView<double> x0_view(x0);
+      for (std::size_t i = 0; i < couplingParameters_.size(); ++i) {
+	const CouplingParameter& cp = couplingParameters_[i];
+	const Teuchos::ArrayView<const double> p = models[cp.modelIndex]->getParameter(cp.parameterIndex);
+	for (int k = 0; k < cp.size; ++k)
+	  x0_view[cp.offset+k] = p[k];
+      }
+    }
+
+    Thyra::ModelEvaluatorBase::InArgsSetup<double> nominalValues(this->createInArgs());
+    nominalValues.set_x(x0);
+    nominalValues_ = nominalValues;
+
+    registrationComplete_ = true;
+  }
+
+  int FixedPointModelEvaluator::getCouplingParameterOffset(const int i) const
+  {
+    TEUCHOS_ASSERT(registrationComplete_);
+    TEUCHOS_ASSERT( (i >= 0) && (i < this->getNumberOfCouplingParameters()) );
+    return couplingParameters_[i].offset;
+  }
+
+  int FixedPointModelEvaluator::getNumberOfCouplingParameters() const
+  {
+    return static_cast<int>(couplingParameterNames_.size());
+  }
+
+  Teuchos::RCP<const pike::Solver> FixedPointModelEvaluator::getSolver() const
+  {
+    return solver_;
+  }
+
+  Teuchos::RCP<const Thyra::VectorSpaceBase<double> > FixedPointModelEvaluator::get_x_space() const
+  {
+    TEUCHOS_ASSERT(registrationComplete_);
+    return x_space_;
+  }
+
+  Teuchos::RCP<const Thyra::VectorSpaceBase<double> > FixedPointModelEvaluator::get_f_space() const
+  {
+    TEUCHOS_ASSERT(registrationComplete_);
+    return x_space_;
+  }
+
+  Thyra::ModelEvaluatorBase::InArgs<double> FixedPointModelEvaluator::getNominalValues() const
+  {
+    TEUCHOS_ASSERT(registrationComplete_);
+    return nominalValues_;
+  }
+
+  Thyra::ModelEvaluatorBase::InArgs<double> FixedPointModelEvaluator::createInArgs() const
+  {
+    Thyra::ModelEvaluatorBase::InArgsSetup<double> inArgs;
+    inArgs.setModelEvalDescription(this->description());
+    inArgs.setSupports(Thyra::ModelEvaluatorBase::IN_ARG_x);
+    return inArgs;
+  }
+
+  Thyra::ModelEvaluatorBase::OutArgs<double> FixedPointModelEvaluator::createOutArgsImpl() const
+  {
+    Thyra::ModelEvaluatorBase::OutArgsSetup<double> outArgs;
+    outArgs.setModelEvalDescription(this->description());
+    outArgs.setSupports(Thyra::ModelEvaluatorBase::OUT_ARG_f);
+    return outArgs;
+  }
+
+  void FixedPointModelEvaluator::
+  evalModelImpl(const Thyra::ModelEvaluatorBase::InArgs<double> &inArgs,
+		const Thyra::ModelEvaluatorBase::OutArgs<double> &outArgs) const
+  {
+    TEUCHOS_ASSERT(registrationComplete_);
+
+    const Teuchos::ArrayView<const Teuchos::RCP<const pike::BlackBoxModelEvaluator> > models = solver_->getModelEvaluatorsView();
+    const Teuchos::ArrayView<const Teuchos::RCP<const pike::DataTransfer> > transfers = solver_->getDataTransfersView();
+
+    // Copy x since it is needed again for the residual
+    std::vector<double> x(x_space_->dim());
+    {
+      Thyra::ConstDetachedVectorView<double> x_view(inArgs.get_x());
+      for (std::size_t k = 0; k < x.size(); ++k)
+	x[k] = x_view[k];
+    }
+
+    for (std::vector<CouplingParameter>::const_iterator cp = couplingParameters_.begin();
+	 cp != couplingParameters_.end(); ++cp)
+      Teuchos::rcp_const_cast<pike::BlackBoxModelEvaluator>(models[cp->modelIndex])->
+	setParameter(cp->parameterIndex, Teuchos::ArrayView<const double>(&x[cp->offset],cp->size));
+
+    bool failed = false;
+
+    for (Teuchos::ArrayView<const Teuchos::RCP<const pike::BlackBoxModelEvaluator> >::iterator m = models.begin();
+	 m != models.end(); ++m) {
+      Teuchos::rcp_const_cast<pike::BlackBoxModelEvaluator>(*m)->solve();
+      if (!(*m)->isLocallyConverged())
+	failed = true;
+    }
+
+    for (Teuchos::ArrayView<const Teuchos::RCP<const pike::DataTransfer> >::iterator t = transfers.begin();
+	 t != transfers.end(); ++t) {
+      Teuchos::rcp_const_cast<pike::DataTransfer>(*t)->doTransfer(*solver_);
+      if (!(*t)->transferSucceeded())
+	failed = true;
+    }
+
+    if (failed) {
+      outArgs.setFailed();
+      return;
+    }
+
+    if (nonnull(outArgs.get_f())) {
+      Thyra::DetachedVectorView<double> f_view(outArgs.get_f());
+      for (std::vector<CouplingParameter>::const_iterator cp = couplingParameters_.begin();
+	   cp != couplingParameters_.end(); ++cp) {
+	const Teuchos::ArrayView<const double> G = models[cp->modelIndex]->getParameter(cp->parameterIndex);
+	for (int k = 0; k < cp->size; ++k)
+	  f_view[cp->offset+k] = G[k] - x[cp->offset+k];
+      }
+    }
+  }
+
+  // Non-member ctor
+  Teuchos::RCP<pike::FixedPointModelEvaluator>
+  fixedPointModelEvaluator(const Teuchos::RCP<pike::Solver>& solver,
+			   const Teuchos::RCP<const Teuchos::Comm<int> >& comm)
+  {
+    return Teuchos::rcp(new pike::FixedPointModelEvaluator(solver,comm));
+  }
+
+}
@@ -0,0 +1,109 @@
+#ifndef PIKE_MODEL_EVALUATOR_FIXED_POINT_HPP
+#define PIKE_MODEL_EVALUATOR_FIXED_POINT_HPP
+
+#include "Pike_BlackBox_config.hpp"
+#include "Thyra_StateFuncModelEvaluatorBase.hpp"
+#include "Teuchos_Comm.hpp"
+#include <vector>
+#include <string>
+
+namespace pike {
+
+  class Solver;
+
+  /** \brief Exposes a coupled set of BlackBoxModelEvaluators and
+      DataTransfers as a Thyra fixed-point residual.
+
+      The unknowns x are the coupling parameters selected with
+      addCouplingParameter(), concatenated in the order they were
+      added.  The fixed-point map G is one block Jacobi sweep over the
+      coupled system:
+
+      1. set each coupling parameter of its model to the values in x
+      2. solve() every model registered with the solver
+      3. doTransfer() every data transfer registered with the solver
+      4. G(x) is the value of the coupling parameters after the transfers
+
+      and the residual is f = G(x) - x.  This allows NOX (Anderson
+      acceleration, Broyden, JFNK) to drive the existing blackbox
+      codes.  No W_op is supported, so Newton based methods must be
+      matrix-free.
+
+      The pike::Solver is only used as the registry of the models and
+      transfers (and as the argument of
+      pike::DataTransfer::doTransfer()); its step() is never called.
+      Registration on the solver must be complete before this object
+      is used.
+
+      Models must implement
+      pike::BlackBoxModelEvaluator::getParameter() for the coupling
+      parameters, returning the values written by the data
+      transfers.  The coupling data is replicated on all processes of
+      the comm, as in the blackbox interface.  If a model fails to
+      converge or a transfer fails, the evaluation is flagged as
+      failed via Thyra::ModelEvaluatorBase::OutArgs::setFailed().
+   */
+  class FixedPointModelEvaluator : public Thyra::StateFuncModelEvaluatorBase<double> {
+
+  public:
+
+    FixedPointModelEvaluator(const Teuchos::RCP<pike::Solver>& solver,
+			     const Teuchos::RCP<const Teuchos::Comm<int> >& comm);
+
+    //! Adds the parameter of the named model to the coupling unknowns.
+    void addCouplingParameter(const std::string& modelName, const std::string& parameterName);
+
+    /** \brief Builds the vector spaces and nominal values.
+
+	The nominal (initial) x is the current value of the coupling
+	parameters.  No coupling parameters can be added after this
+	call.
+    */
+    void completeRegistration();
+
+    //! Returns the offset of coupling parameter i in the x vector.
+    int getCouplingParameterOffset(const int i) const;
+
+    int getNumberOfCouplingParameters() const;
+
+    Teuchos::RCP<const pike::Solver> getSolver() const;
+
+    // From Thyra::ModelEvaluator
+    Teuchos::RCP<const Thyra::VectorSpaceBase<double> > get_x_space() const;
+    Teuchos::RCP<const Thyra::VectorSpaceBase<double> > get_f_space() const;
+    Thyra::ModelEvaluatorBase::InArgs<double> getNominalValues() const;
+    Thyra::ModelEvaluatorBase::InArgs<double> createInArgs() const;
+
+  private:
+
+    Thyra::ModelEvaluatorBase::OutArgs<double> createOutArgsImpl() const;
+
+    void evalModelImpl(const Thyra::ModelEvaluatorBase::InArgs<double> &inArgs,
+		       const Thyra::ModelEvaluatorBase::OutArgs<double> &outArgs) const;
+
+    struct CouplingParameter {
+      int modelIndex;
+      int parameterIndex;
+      int offset;
+      int size;
+    };
+
+    Teuchos::RCP<pike::Solver> solver_;
+    Teuchos::RCP<const Teuchos::Comm<int> > comm_;
+    std::vector<std::pair<std::string,std::string> > couplingParameterNames_;
+    std::vector<CouplingParameter> couplingParameters_;
+    bool registrationComplete_;
+    Teuchos::RCP<const Thyra::VectorSpaceBase<double> > x_space_;
+    Thyra::ModelEvaluatorBase::InArgs<double> nominalValues_;
+  };
+
+  /** \brief Non-member ctor
+      \relates FixedPointModelEvaluator
+  */
+  Teuchos::RCP<pike::FixedPointModelEvaluator>
+  fixedPointModelEvaluator(const Teuchos::RCP<pike::Solver>& solver,
+			   const Teuchos::RCP<const Teuchos::Comm<int> >& comm);
+
+}
+
+#endif
@@ -0,0 +1,136 @@
+#include "Pike_Linear_ModelEvaluator.hpp"
+#include "Thyra_DefaultSpmdVectorSpace.hpp"
+#include "Thyra_DefaultDiagonalLinearOp.hpp"
+#include "Thyra_DefaultPreconditioner.hpp"
+#include "Thyra_VectorStdOps.hpp"
+#include "Teuchos_Assert.hpp"
+
+namespace pike_test {
+
+  LinearModelEvaluator::LinearModelEvaluator(const std::string& name,
+					     const int dimension,
+					     const double a,
+					     const double b)
+    : space_(Thyra::defaultSpmdVectorSpace<double>(dimension)),
+      p_names_(Teuchos::rcp(new Teuchos::Array<std::string>(1,name+" p"))),
+      a_(a),
+      b_(b)
+  { }
+
+  Teuchos::RCP<const Thyra::VectorSpaceBase<double> > LinearModelEvaluator::get_x_space() const
+  { return space_; }
+
+  Teuchos::RCP<const Thyra::VectorSpaceBase<double> > LinearModelEvaluator::get_f_space() const
+  { return space_; }
+
+  Teuchos::RCP<const Thyra::VectorSpaceBase<double> > LinearModelEvaluator::get_p_space(int l) const
+  {
+    TEUCHOS_ASSERT(l == 0);
+    return space_;
+  }
+
+  Teuchos::RCP<const Teuchos::Array<std::string> > LinearModelEvaluator::get_p_names(int l) const
+  {
+    TEUCHOS_ASSERT(l == 0);
+    return p_names_;
+  }
+
+  Teuchos::RCP<const Thyra::VectorSpaceBase<double> > LinearModelEvaluator::get_g_space(int j) const
+  {
+    TEUCHOS_ASSERT(j == 0);
+    return space_;
+  }
+
+  Thyra::ModelEvaluatorBase::InArgs<double> LinearModelEvaluator::getNominalValues() const
+  {
+    Thyra::ModelEvaluatorBase::InArgs<double> nominalValues = this->createInArgs();
+    const Teuchos::RCP<Thyra::VectorBase<double> > x = Thyra::createMember(space_);
+    Thyra::assign(x.ptr(), 0.0);
+    nominalValues.set_x(x);
+    const Teuchos::RCP<Thyra::VectorBase<double> > p = Thyra::createMember(space_);
+    Thyra::assign(p.ptr(), 0.0);
+    nominalValues.set_p(0, p);
+    return nominalValues;
+  }
+
+  Teuchos::RCP<Thyra::LinearOpBase<double> > LinearModelEvaluator::create_W_op() const
+  { return Teuchos::rcp(new Thyra::DefaultDiagonalLinearOp<double>(space_)); }
+
+  Teuchos::RCP<Thyra::PreconditionerBase<double> > LinearModelEvaluator::create_W_prec() const
+  {
+    const Teuchos::RCP<Thyra::LinearOpBase<double> > P =
+      Teuchos::rcp(new Thyra::DefaultDiagonalLinearOp<double>(space_));
+    return Thyra::nonconstUnspecifiedPrec<double>(P);
+  }
+
+  Thyra::ModelEvaluatorBase::InArgs<double> LinearModelEvaluator::createInArgs() const
+  {
+    typedef Thyra::ModelEvaluatorBase MEB;
+    MEB::InArgsSetup<double> inArgs;
+    inArgs.setModelEvalDescription(this->description());
+    inArgs.set_Np(1);
+    inArgs.setSupports(MEB::IN_ARG_x);
+    return inArgs;
+  }
+
+  Teuchos::RCP<Thyra::LinearOpBase<double> > LinearModelEvaluator::create_DfDp_op_impl(int l) const
+  {
+    TEUCHOS_ASSERT(l == 0);
+    return Teuchos::rcp(new Thyra::DefaultDiagonalLinearOp<double>(space_));
+  }
+
+  Thyra::ModelEvaluatorBase::OutArgs<double> LinearModelEvaluator::createOutArgsImpl() const
+  {
+    typedef Thyra::ModelEvaluatorBase MEB;
+    MEB::OutArgsSetup<double> outArgs;
+    outArgs.setModelEvalDescription(this->description());
+    outArgs.set_Np_Ng(1,1);
+    outArgs.setSupports(MEB::OUT_ARG_f);
+    outArgs.setSupports(MEB::OUT_ARG_W_op);
+    outArgs.setSupports(MEB::OUT_ARG_W_prec);
+    outArgs.setSupports(MEB::OUT_ARG_DfDp, 0, MEB::DerivativeSupport(MEB::DERIV_LINEAR_OP));
+    return outArgs;
+  }
+
+  void LinearModelEvaluator::evalModelImpl(const Thyra::ModelEvaluatorBase::InArgs<double> &inArgs,
+					   const Thyra::ModelEvaluatorBase::OutArgs<double> &outArgs) const
+  {
+    const Teuchos::RCP<const Thyra::VectorBase<double> > x = inArgs.get_x();
+    Teuchos::RCP<const Thyra::VectorBase<double> > p = inArgs.get_p(0);
+    if (is_null(p))
+      p = this->getNominalValues().get_p(0);
+
+    if (nonnull(outArgs.get_f()))
+      Thyra::V_StVpStV(outArgs.get_f().ptr(), a_, *x, -b_, *p);
+
+    if (nonnull(outArgs.get_g(0)))
+      Thyra::copy(*x, outArgs.get_g(0).ptr());
+
+    if (nonnull(outArgs.get_W_op()))
+      this->setDiagonal(outArgs.get_W_op(), a_);
+
+    if (nonnull(outArgs.get_W_prec()))
+      this->setDiagonal(outArgs.get_W_prec()->getNonconstUnspecifiedPrecOp(), 1.0 / a_);
+
+    if (nonnull(outArgs.get_DfDp(0).getLinearOp()))
+      this->setDiagonal(outArgs.get_DfDp(0).getLinearOp(), -b_);
+  }
+
+  void LinearModelEvaluator::setDiagonal(const Teuchos::RCP<Thyra::LinearOpBase<double> >& op, const double value) const
+  {
+    const Teuchos::RCP<Thyra::DefaultDiagonalLinearOp<double> > D =
+      Teuchos::rcp_dynamic_cast<Thyra::DefaultDiagonalLinearOp<double> >(op,true);
+    Thyra::assign(D->getNonconstDiag().ptr(), value);
+  }
+
+  // non-member ctor
+  Teuchos::RCP<pike_test::LinearModelEvaluator>
+  linearModelEvaluator(const std::string& name,
+		       const int dimension,
+		       const double a,
+		       const double b)
+  {
+    return Teuchos::rcp(new pike_test::LinearModelEvaluator(name,dimension,a,b));
+  }
+
+}
@@ -0,0 +1,70 @@
+#ifndef PIKE_LINEAR_MODEL_EVALUATOR_HPP
+#define PIKE_LINEAR_MODEL_EVALUATOR_HPP
+
+#include "Thyra_StateFuncModelEvaluatorBase.hpp"
+#include "Thyra_VectorSpaceBase.hpp"
+#include "Teuchos_RCP.hpp"
+#include "Teuchos_Array.hpp"
+#include <string>
+
+namespace pike_test {
+
+  /** \brief Simple linear Thyra model evaluator for unit testing.
+
+      The residual is f = a * x - b * p where the parameter p has the
+      same space as the state x, so that models can be coupled by
+      feeding the state of one model to the parameter of another.
+      The Jacobian W_op = a * I, the preconditioner W_prec = I / a and
+      DfDp = -b * I are diagonal operators.  The single response is
+      g = x.
+   */
+  class LinearModelEvaluator : public Thyra::StateFuncModelEvaluatorBase<double> {
+
+  public:
+
+    LinearModelEvaluator(const std::string& name,
+			 const int dimension,
+			 const double a,
+			 const double b);
+
+    // From Thyra::ModelEvaluator
+    Teuchos::RCP<const Thyra::VectorSpaceBase<double> > get_x_space() const;
+    Teuchos::RCP<const Thyra::VectorSpaceBase<double> > get_f_space() const;
+    Teuchos::RCP<const Thyra::VectorSpaceBase<double> > get_p_space(int l) const;
+    Teuchos::RCP<const Teuchos::Array<std::string> > get_p_names(int l) const;
+    Teuchos::RCP<const Thyra::VectorSpaceBase<double> > get_g_space(int j) const;
+    Thyra::ModelEvaluatorBase::InArgs<double> getNominalValues() const;
+    Teuchos::RCP<Thyra::LinearOpBase<double> > create_W_op() const;
+    Teuchos::RCP<Thyra::PreconditionerBase<double> > create_W_prec() const;
+    Thyra::ModelEvaluatorBase::InArgs<double> createInArgs() const;
+
+  private:
+
+    Teuchos::RCP<Thyra::LinearOpBase<double> > create_DfDp_op_impl(int l) const;
+
+    Thyra::ModelEvaluatorBase::OutArgs<double> createOutArgsImpl() const;
+
+    void evalModelImpl(const Thyra::ModelEvaluatorBase::InArgs<double> &inArgs,
+		       const Thyra::ModelEvaluatorBase::OutArgs<double> &outArgs) const;
+
+    //! Sets the diagonal of a DefaultDiagonalLinearOp.
+    void setDiagonal(const Teuchos::RCP<Thyra::LinearOpBase<double> >& op, const double value) const;
+
+    Teuchos::RCP<const Thyra::VectorSpaceBase<double> > space_;
+    Teuchos::RCP<const Teuchos::Array<std::string> > p_names_;
+    double a_;
+    double b_;
+  };
+
+  /** \brief non-member ctor
+      \relates LinearModelEvaluator
+  */
+  Teuchos::RCP<pike_test::LinearModelEvaluator>
+  linearModelEvaluator(const std::string& name,
+		       const int dimension,
+		       const double a,
+		       const double b);
+
+}
+
+#endif
@@ -0,0 +1,168 @@
+#include "Teuchos_UnitTestHarness.hpp"
+#include "Teuchos_Array.hpp"
+#include <cmath>
+
+// Prerequisites for testing
+#include "Pike_Linear_ModelEvaluator.hpp"
+#include "Thyra_DefaultProductVector.hpp"
+#include "Thyra_DefaultIdentityLinearOp.hpp"
+#include "Thyra_DefaultScaledAdjointLinearOp.hpp"
+#include "Thyra_VectorStdOps.hpp"
+#include "Thyra_PreconditionerBase.hpp"
+
+// Objects to test
+#include "Pike_ModelEvaluator_Composite.hpp"
+
+namespace pike {
+
+  // Builds a composite of two models of dimension 2:
+  //   model 0: f_0 = 2 * x_0 - 1 * p_0
+  //   model 1: f_1 = 4 * x_1 - 2 * p_1
+  Teuchos::RCP<pike::CompositeModelEvaluator<double> > buildComposite()
+  {
+    Teuchos::Array<Teuchos::RCP<const Thyra::ModelEvaluator<double> > > models;
+    models.push_back(pike_test::linearModelEvaluator("model 0",2,2.0,1.0));
+    models.push_back(pike_test::linearModelEvaluator("model 1",2,4.0,2.0));
+    return pike::compositeModelEvaluator<double>(models());
+  }
+
+  // Returns a product vector with constant blocks.
+  Teuchos::RCP<Thyra::VectorBase<double> >
+  buildProductVector(const Teuchos::RCP<const Thyra::VectorSpaceBase<double> >& space,
+		     const double block0, const double block1)
+  {
+    const Teuchos::RCP<Thyra::VectorBase<double> > v = Thyra::createMember(space);
+    const Teuchos::RCP<Thyra::ProductVectorBase<double> > v_blocks =
+      Thyra::nonconstProductVectorBase<double>(v);
+    Thyra::assign(v_blocks->getNonconstVectorBlock(0).ptr(), block0);
+    Thyra::assign(v_blocks->getNonconstVectorBlock(1).ptr(), block1);
+    return v;
+  }
+
+  // Returns the value of a constant block of a product vector.
+  double blockValue(const Thyra::VectorBase<double>& v, const int block)
+  {
+    const Teuchos::RCP<const Thyra::VectorBase<double> > b =
+      Thyra::productVectorBase<double>(Teuchos::rcpFromRef(v))->getVectorBlock(block);
+    return Thyra::sum(*b) / b->space()->dim();
+  }
+
+  TEUCHOS_UNIT_TEST(composite_model_evaluator, coupling_parameters)
+  {
+    Teuchos::RCP<pike::CompositeModelEvaluator<double> > composite = buildComposite();
+    TEST_EQUALITY(composite->getNumberOfModels(), 2);
+    TEST_EQUALITY(composite->Np(), 2);
+    TEST_EQUALITY(composite->Ng(), 2);
+
+    // Only the uncoupled parameter is left in the composite
+    composite->setCouplingParameter(1,0,0);
+    TEST_EQUALITY(composite->Np(), 1);
+    TEST_EQUALITY(composite->getParameterMap(0).first, 0);
+    TEST_EQUALITY(composite->getParameterMap(0).second, 0);
+    TEST_EQUALITY(composite->getCoupledModel(1,0), 0);
+    TEST_EQUALITY(composite->getCoupledModel(0,0), -1);
+
+    composite->setCouplingParameter(0,0,1);
+    TEST_EQUALITY(composite->Np(), 0);
+
+    // Invalid couplings
+    TEST_THROW(composite->setCouplingParameter(0,0,0), std::logic_error);
+    TEST_THROW(composite->setCouplingParameter(0,1,1), std::logic_error);
+    TEST_THROW(composite->setCouplingParameter(0,0,2), std::logic_error);
+
+    // f_0 = 2 * 1 - 1 * 3 = -1, f_1 = 4 * 3 - 2 * 1 = 10
+    Thyra::ModelEvaluatorBase::InArgs<double> inArgs = composite->createInArgs();
+    inArgs.set_x(buildProductVector(composite->get_x_space(),1.0,3.0));
+    Thyra::ModelEvaluatorBase::OutArgs<double> outArgs = composite->createOutArgs();
+    const Teuchos::RCP<Thyra::VectorBase<double> > f = Thyra::createMember(composite->get_f_space());
+    outArgs.set_f(f);
+    composite->evalModel(inArgs,outArgs);
+
+    const double tol = 1.0e-10;
+    TEST_FLOATING_EQUALITY(blockValue(*f,0), -1.0, tol);
+    TEST_FLOATING_EQUALITY(blockValue(*f,1), 10.0, tol);
+  }
+
+  TEUCHOS_UNIT_TEST(composite_model_evaluator, coupling_blocks_of_W)
+  {
+    Teuchos::RCP<pike::CompositeModelEvaluator<double> > composite = buildComposite();
+    composite->setCouplingParameter(1,0,0);
+    composite->setCouplingParameter(0,0,1);
+
+    // A registered coupling operator replaces DfDp of the coupling parameter
+    Teuchos::RCP<pike::CompositeModelEvaluator<double> > registered = buildComposite();
+    registered->setCouplingParameter(1,0,0);
+    registered->setCouplingParameter(0,0,1);
+    registered->setCouplingOperator(0,1,Thyra::scale<double>(-5.0,Thyra::identity<double>(registered->getModel(1)->get_x_space())));
+
+    // W = [2 -1; -2 4] and W = [2 -5; -2 4] per block
+    const double expected[2][2] = { {1.0, 2.0}, {-3.0, 2.0} };
+    const Teuchos::RCP<pike::CompositeModelEvaluator<double> > composites[2] = {composite, registered};
+    const double tol = 1.0e-10;
+
+    for (int c = 0; c < 2; ++c) {
+      const Teuchos::RCP<Thyra::LinearOpBase<double> > W = composites[c]->create_W_op();
+      Thyra::ModelEvaluatorBase::InArgs<double> inArgs = composites[c]->createInArgs();
+      inArgs.set_x(buildProductVector(composites[c]->get_x_space(),1.0,3.0));
+      Thyra::ModelEvaluatorBase::OutArgs<double> outArgs = composites[c]->createOutArgs();
+      outArgs.set_W_op(W);
+      composites[c]->evalModel(inArgs,outArgs);
+
+      const Teuchos::RCP<Thyra::VectorBase<double> > v = buildProductVector(W->domain(),1.0,1.0);
+      const Teuchos::RCP<Thyra::VectorBase<double> > y = Thyra::createMember(W->range());
+      Thyra::apply(*W, Thyra::NOTRANS, *v, y.ptr());
+      TEST_FLOATING_EQUALITY(blockValue(*y,0), expected[c][0], tol);
+      TEST_FLOATING_EQUALITY(blockValue(*y,1), expected[c][1], tol);
+    }
+  }
+
+  TEUCHOS_UNIT_TEST(composite_model_evaluator, gauss_seidel_uses_W_blocks)
+  {
+    // Model 1 is fed by model 0, so W = [2 0; -2 4] per block is
+    // block lower triangular and block Gauss-Seidel with the exact
+    // diagonal inverses is the exact inverse of W.  The second
+    // composite uses a registered coupling operator -3 * I instead.
+    Teuchos::RCP<pike::CompositeModelEvaluator<double> > fromDfDp = buildComposite();
+    fromDfDp->setCouplingParameter(1,0,0);
+    Teuchos::RCP<pike::CompositeModelEvaluator<double> > registered = buildComposite();
+    registered->setCouplingParameter(1,0,0);
+    registered->setCouplingOperator(1,0,Thyra::scale<double>(-3.0,Thyra::identity<double>(registered->getModel(0)->get_x_space())));
+
+    const Teuchos::RCP<pike::CompositeModelEvaluator<double> > composites[2] = {fromDfDp, registered};
+    const double tol = 1.0e-10;
+
+    for (int c = 0; c < 2; ++c) {
+      composites[c]->setBlockPreconditionerType(pike::BLOCK_GAUSS_SEIDEL);
+
+      // Evaluate W_op and W_prec together (shared blocks) and W_prec alone
+      for (int together = 0; together < 2; ++together) {
+	const Teuchos::RCP<Thyra::LinearOpBase<double> > W = composites[c]->create_W_op();
+	const Teuchos::RCP<Thyra::PreconditionerBase<double> > P = composites[c]->create_W_prec();
+	Thyra::ModelEvaluatorBase::InArgs<double> inArgs = composites[c]->createInArgs();
+	inArgs.set_x(buildProductVector(composites[c]->get_x_space(),1.0,3.0));
+	{
+	  Thyra::ModelEvaluatorBase::OutArgs<double> outArgs = composites[c]->createOutArgs();
+	  outArgs.set_W_op(W);
+	  if (together == 1)
+	    outArgs.set_W_prec(P);
+	  composites[c]->evalModel(inArgs,outArgs);
+	}
+	if (together == 0) {
+	  Thyra::ModelEvaluatorBase::OutArgs<double> outArgs = composites[c]->createOutArgs();
+	  outArgs.set_W_prec(P);
+	  composites[c]->evalModel(inArgs,outArgs);
+	}
+
+	// P * W * v = v
+	const Teuchos::RCP<Thyra::VectorBase<double> > v = buildProductVector(W->domain(),1.0,3.0);
+	const Teuchos::RCP<Thyra::VectorBase<double> > Wv = Thyra::createMember(W->range());
+	Thyra::apply(*W, Thyra::NOTRANS, *v, Wv.ptr());
+	const Teuchos::RCP<Thyra::VectorBase<double> > PWv = Thyra::createMember(W->domain());
+	Thyra::apply(*P->getUnspecifiedPrecOp(), Thyra::NOTRANS, *Wv, PWv.ptr());
+	TEST_FLOATING_EQUALITY(blockValue(*PWv,0), 1.0, tol);
+	TEST_FLOATING_EQUALITY(blockValue(*PWv,1), 3.0, tol);
+      }
+    }
+  }
+
+}
@@ -0,0 +1,76 @@
+#include "Teuchos_UnitTestHarness.hpp"
+#include "Teuchos_DefaultComm.hpp"
+#include <cmath>
+
+// Prerequisites for testing
+#include "Pike_Solver_BlockJacobi.hpp"
+#include "Pike_LinearHeatConduction_ModelEvaluator.hpp"
+#include "Pike_LinearHeatConduction_DataTransfer.hpp"
+#include "Thyra_VectorStdOps.hpp"
+
+// Objects to test
+#include "Pike_ModelEvaluator_FixedPoint.hpp"
+
+namespace pike {
+
+  TEUCHOS_UNIT_TEST(fixed_point_model_evaluator, evalModel)
+  {
+    typedef pike_test::LinearHeatConductionModelEvaluator LHCME;
+    typedef pike_test::LinearHeatConductionDataTransfer LHCDT;
+
+    Teuchos::RCP<const Teuchos::Comm<int> > comm = Teuchos::DefaultComm<int>::getComm();
+
+    // left wall:  T_right = T_left - q / k with T_left = 1, k = 1
+    // right wall: q = (T_left - T_right) * k with T_left = 1, T_right = -3, k = 1
+    // The q transfer sets q of the left wall to half of q of the
+    // right wall, so G(q) = 0.5 * 4 = 2 and f = 2 - q.
+    Teuchos::RCP<LHCME> leftWall = pike_test::linearHeatConductionModelEvaluator(comm,"left wall",LHCME::T_RIGHT_IS_RESPONSE);
+    Teuchos::RCP<LHCME> rightWall = pike_test::linearHeatConductionModelEvaluator(comm,"right wall",LHCME::Q_IS_RESPONSE);
+    rightWall->set_T_right(-3.0);
+
+    Teuchos::RCP<LHCDT> transferQ = pike_test::linearHeatConductionDataTransfer(comm,"q: right->left",LHCDT::TRANSFER_Q);
+    transferQ->setSource(rightWall);
+    transferQ->addTarget(leftWall);
+
+    Teuchos::RCP<pike::BlockJacobi> solver = Teuchos::rcp(new pike::BlockJacobi);
+    solver->registerModelEvaluator(leftWall);
+    solver->registerModelEvaluator(rightWall);
+    solver->registerDataTransfer(transferQ);
+    solver->completeRegistration();
+
+    Teuchos::RCP<pike::FixedPointModelEvaluator> fp = pike::fixedPointModelEvaluator(solver,comm);
+    TEST_THROW(fp->completeRegistration(), std::logic_error);
+    fp->addCouplingParameter("left wall","q");
+    fp->completeRegistration();
+    TEST_THROW(fp->addCouplingParameter("right wall","T_right"), std::logic_error);
+    TEST_EQUALITY(fp->getNumberOfCouplingParameters(), 1);
+    TEST_EQUALITY(fp->getCouplingParameterOffset(0), 0);
+    TEST_EQUALITY(fp->get_x_space()->dim(), 1);
+
+    const double tol = 1.0e-10;
+
+    // The nominal x is the current q of the left wall
+    TEST_FLOATING_EQUALITY(Thyra::sum(*fp->getNominalValues().get_x()), 1.0, tol);
+
+    Thyra::ModelEvaluatorBase::InArgs<double> inArgs = fp->createInArgs();
+    const Teuchos::RCP<Thyra::VectorBase<double> > x = Thyra::createMember(fp->get_x_space());
+    Thyra::assign(x.ptr(), 5.0);
+    inArgs.set_x(x);
+    Thyra::ModelEvaluatorBase::OutArgs<double> outArgs = fp->createOutArgs();
+    const Teuchos::RCP<Thyra::VectorBase<double> > f = Thyra::createMember(fp->get_f_space());
+    outArgs.set_f(f);
+    fp->evalModel(inArgs,outArgs);
+
+    TEST_ASSERT(!outArgs.isFailed());
+    TEST_FLOATING_EQUALITY(Thyra::sum(*f), -3.0, tol);
+    // The left wall was solved with q = x before the transfer set q = G(x)
+    TEST_FLOATING_EQUALITY(leftWall->get_T_right(), -4.0, tol);
+    TEST_FLOATING_EQUALITY(leftWall->get_q(), 2.0, tol);
+
+    // f(G(x)) = 0 at the fixed point
+    Thyra::assign(x.ptr(), 2.0);
+    fp->evalModel(inArgs,outArgs);
+    TEST_ASSERT(std::abs(Thyra::sum(*f)) < tol);
+  }
+
+}